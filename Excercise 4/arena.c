@@ -0,0 +1,266 @@
+/*-----------------------------------------------------------------------
+
+File  : arena.c
+
+Authors: Konstantin Kläger, Isabel Staaden, Carolin Rösch
+
+Contents
+
+  Implementation of the chunked bump allocator.
+
+  This code is released under the GNU General Public Licence.
+
+Changes
+
+<1> Sat Oct 17 23:05:12 CEST 2026
+    New
+
+-----------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include "arena.h"
+
+
+
+/*---------------------------------------------------------------------*/
+/*                        Global Variables                             */
+/*---------------------------------------------------------------------*/
+
+
+/*---------------------------------------------------------------------*/
+/*                      Forward Declarations                           */
+/*---------------------------------------------------------------------*/
+
+
+/*---------------------------------------------------------------------*/
+/*                         Internal Functions                          */
+/*---------------------------------------------------------------------*/
+
+#define ALIGN_UP(n) (((n)+(ARENA_ALIGN-1)) & ~(size_t)(ARENA_ALIGN-1))
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: arena_new_chunk()
+//
+//   Allocate a fresh chunk with room for at least size bytes and make
+//   it the current chunk of arena. Exits on out-of-memory.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static ArenaChunk_p arena_new_chunk(Arena_p arena, size_t size)
+{
+   ArenaChunk_p chunk;
+
+   if(size < arena->chunk_size)
+   {
+      size = arena->chunk_size;
+   }
+   chunk = malloc(sizeof(ArenaChunkCell)+size);
+   if(!chunk)
+   {
+      fprintf(stderr, "Out of memory in arena allocator!\n");
+      exit(EXIT_FAILURE);
+   }
+   chunk->size = size;
+   chunk->used = 0;
+   chunk->next = arena->chunks;
+   arena->chunks = chunk;
+   arena->reserved += size;
+
+   return chunk;
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                         Exported Functions                          */
+/*---------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------
+//
+// Function: ArenaAlloc()
+//
+//   Return an empty arena. chunk_size is the size of the chunks
+//   requested from the system, 0 selects ARENA_CHUNK_SIZE.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+Arena_p ArenaAlloc(size_t chunk_size)
+{
+   Arena_p handle = ArenaCellAlloc();
+
+   handle->chunks     = NULL;
+   handle->chunk_size = chunk_size? ALIGN_UP(chunk_size) : ARENA_CHUNK_SIZE;
+   handle->allocated  = 0;
+   handle->reserved   = 0;
+
+   return handle;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ArenaFree()
+//
+//   Release the arena and everything ever allocated from it. Cost is
+//   proportional to the number of chunks, not to the number of
+//   objects.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+void ArenaFree(Arena_p junk)
+{
+   ArenaChunk_p chunk, next;
+
+   if(junk)
+   {
+      for(chunk = junk->chunks; chunk; chunk = next)
+      {
+         next = chunk->next;
+         free(chunk);
+      }
+   }
+   ArenaCellFree(junk);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ArenaReset()
+//
+//   Invalidate all objects in the arena, but keep the most recently
+//   allocated chunk around for reuse.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+void ArenaReset(Arena_p arena)
+{
+   ArenaChunk_p chunk, next;
+
+   if(arena->chunks)
+   {
+      for(chunk = arena->chunks->next; chunk; chunk = next)
+      {
+         next = chunk->next;
+         free(chunk);
+      }
+      arena->chunks->next = NULL;
+      arena->chunks->used = 0;
+      arena->reserved     = arena->chunks->size;
+   }
+   arena->allocated = 0;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ArenaMalloc()
+//
+//   Return size bytes of (uninitialized, ARENA_ALIGN-aligned) memory
+//   from the arena.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+void* ArenaMalloc(Arena_p arena, size_t size)
+{
+   ArenaChunk_p chunk = arena->chunks;
+   void*        res;
+
+   size = ALIGN_UP(size);
+   if(!chunk || (chunk->size - chunk->used) < size)
+   {
+      if(size > arena->chunk_size/4 && chunk)
+      {
+         /* Big object - give it its own chunk behind the current one,
+            so that we do not waste the rest of the current chunk */
+         ArenaChunk_p big = malloc(sizeof(ArenaChunkCell)+size);
+
+         if(!big)
+         {
+            fprintf(stderr, "Out of memory in arena allocator!\n");
+            exit(EXIT_FAILURE);
+         }
+         big->size = size;
+         big->used = size;
+         big->next = chunk->next;
+         chunk->next = big;
+         arena->reserved  += size;
+         arena->allocated += size;
+         return big->data;
+      }
+      chunk = arena_new_chunk(arena, size);
+   }
+   res = chunk->data + chunk->used;
+   chunk->used      += size;
+   arena->allocated += size;
+
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ArenaCalloc()
+//
+//   As ArenaMalloc(), but the memory is zeroed.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+void* ArenaCalloc(Arena_p arena, size_t size)
+{
+   void* res = ArenaMalloc(arena, size);
+
+   memset(res, 0, size);
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ArenaStrdup()
+//
+//   Return a copy of str allocated in the arena.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+char* ArenaStrdup(Arena_p arena, const char* str)
+{
+   size_t len = strlen(str)+1;
+   char*  res = ArenaMalloc(arena, len);
+
+   memcpy(res, str, len);
+   return res;
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                        End of File                                  */
+/*---------------------------------------------------------------------*/
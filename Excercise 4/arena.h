@@ -0,0 +1,81 @@
+/*-----------------------------------------------------------------------
+
+File  : arena.h
+
+Authors: Konstantin Kläger, Isabel Staaden, Carolin Rösch
+
+Contents
+
+  Simple bump allocator ("arena"). Memory is handed out from large
+  contiguous chunks and can only be released all at once. This is
+  used for data that lives exactly as long as one compilation unit
+  (AST nodes, literal strings, ...).
+
+  This code is released under the GNU General Public Licence.
+
+Changes
+
+<1> Sat Oct 17 23:05:12 CEST 2026
+    New
+
+-----------------------------------------------------------------------*/
+
+#ifndef ARENA
+
+#define ARENA
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+
+/*---------------------------------------------------------------------*/
+/*                    Data type declarations                           */
+/*---------------------------------------------------------------------*/
+
+/* Default size of a single arena chunk. Requests larger than a
+ * quarter of this get a chunk of their own. */
+#define ARENA_CHUNK_SIZE (64*1024)
+
+/* All allocations are aligned to this (malloc() alignment on x86-64
+ * and most other 64 bit platforms, which the chunks start with) */
+#define ARENA_ALIGN      16
+
+typedef struct arenachunk
+{
+   struct arenachunk *next;
+   size_t            size;
+   size_t            used;
+   char              data[] __attribute__((aligned(ARENA_ALIGN)));
+}ArenaChunkCell, *ArenaChunk_p;
+
+typedef struct arena
+{
+   ArenaChunk_p chunks;     /* Current chunk first */
+   size_t       chunk_size;
+   size_t       allocated;  /* Bytes handed out to users */
+   size_t       reserved;   /* Bytes requested from malloc() */
+}ArenaCell, *Arena_p;
+
+
+/*---------------------------------------------------------------------*/
+/*                Exported Functions and Variables                     */
+/*---------------------------------------------------------------------*/
+
+#define ArenaCellAlloc()    (ArenaCell*)malloc(sizeof(ArenaCell))
+#define ArenaCellFree(junk) free(junk)
+
+Arena_p ArenaAlloc(size_t chunk_size);
+void    ArenaFree(Arena_p junk);
+void    ArenaReset(Arena_p arena);
+
+void*   ArenaMalloc(Arena_p arena, size_t size);
+void*   ArenaCalloc(Arena_p arena, size_t size);
+char*   ArenaStrdup(Arena_p arena, const char* str);
+
+
+#endif
+
+/*---------------------------------------------------------------------*/
+/*                        End of File                                  */
+/*---------------------------------------------------------------------*/
@@ -0,0 +1,1602 @@
+/*-----------------------------------------------------------------------
+
+File  : asmgen.c
+
+Authors: Konstantin Kläger, Isabel Staaden, Carolin Rösch
+
+Contents
+
+  x86-64 assembly generation with linear-scan register allocation
+  (Poletto/Sarkar). The live interval of a slot spans the linear code
+  from the first to the last instruction where the slot is live
+  (dataflow analysis on the bytecode of the function) or written.
+
+  This code is released under the GNU General Public Licence.
+
+Changes
+
+<1> Sun Oct 18 08:31:52 CEST 2026
+    New
+
+-----------------------------------------------------------------------*/
+
+#include <errno.h>
+#include <sys/resource.h>
+#include "asmgen.h"
+
+
+
+/*---------------------------------------------------------------------*/
+/*                        Global Variables                             */
+/*---------------------------------------------------------------------*/
+
+static char* as_reg[AS_REGS] =
+{
+   "%rbx", "%r12", "%r13", "%r14", "%r15",
+   "%rsi", "%rdi", "%r8", "%r9", "%r10", "%r11"
+};
+
+static char* as_arg_reg[] = {"%rdi", "%rsi", "%rdx", "%rcx", "%r8", "%r9"};
+
+#define AS_ARG_REGS 6
+
+/* Conditional jumps for jeq ... jge */
+static char* as_jcc[] = {"je", "jne", "jl", "jle", "jg", "jge"};
+
+/* Runtime support, semantics as in nanort.c */
+static char* as_runtime[] =
+{
+   "# Digits from the end, two per division (by multiplication), into",
+   "# the buffer; their number from the highest bit and one comparison",
+   "nano_print_int:",
+   "\tcmpq\t$NANO_OUT_SIZE-NANO_INT_CHARS, nano_out_len(%rip)",
+   "\tjle\t1f",
+   "\tpushq\t%rdi",
+   "\tcall\tnano_flush",
+   "\tpopq\t%rdi",
+   "1:\tleaq\tnano_out(%rip), %r8",
+   "\taddq\tnano_out_len(%rip), %r8",
+   "\tmovq\t%rdi, %rax",
+   "\ttestq\t%rax, %rax",
+   "\tjns\t2f",
+   "\tmovb\t$45, (%r8)",
+   "\tincq\t%r8",
+   "\tnegq\t%rax",
+   "2:\tmovq\t%rax, %rdx",
+   "\torq\t$1, %rdx",
+   "\tbsrq\t%rdx, %rcx",
+   "\tincl\t%ecx",
+   "\timull\t$1233, %ecx, %ecx",
+   "\tshrl\t$12, %ecx",
+   "\tleaq\t.Ldec_pow10(%rip), %r9",
+   "\tcmpq\t(%r9,%rcx,8), %rdx",
+   "\tsbbq\t$-1, %rcx",
+   "\tleaq\t(%r8,%rcx), %r10",
+   "\tmovq\t%r10, %r11",
+   "\tleaq\t.Ldec_pairs(%rip), %r9",
+   "\tmovabsq\t$2951479051793528259, %rdi",
+   "3:\tcmpq\t$100, %rax",
+   "\tjb\t4f",
+   "\tmovq\t%rax, %rsi",
+   "\tshrq\t$2, %rax",
+   "\tmulq\t%rdi",
+   "\tshrq\t$2, %rdx",
+   "\timulq\t$100, %rdx, %rax",
+   "\tsubq\t%rax, %rsi",
+   "\tmovzwl\t(%r9,%rsi,2), %esi",
+   "\tsubq\t$2, %r10",
+   "\tmovw\t%si, (%r10)",
+   "\tmovq\t%rdx, %rax",
+   "\tjmp\t3b",
+   "4:\tcmpq\t$10, %rax",
+   "\tjb\t5f",
+   "\tmovzwl\t(%r9,%rax,2), %esi",
+   "\tmovw\t%si, -2(%r10)",
+   "\tjmp\t6f",
+   "5:\taddl\t$48, %eax",
+   "\tmovb\t%al, -1(%r10)",
+   "6:\tmovb\t$10, (%r11)",
+   "\tleaq\t1(%r11), %rax",
+   "\tleaq\tnano_out(%rip), %rdx",
+   "\tsubq\t%rdx, %rax",
+   "\tmovq\t%rax, nano_out_len(%rip)",
+   "\tcmpb\t$0, nano_out_line(%rip)",
+   "\tjne\tnano_flush",
+   "\tret",
+   "",
+   "nano_print_str:",
+   "\ttestq\t%rdi, %rdi",
+   "\tjz\t4f",
+   "\tpushq\t%rbx",
+   "\tpushq\t%r12",
+   "\tsubq\t$40, %rsp",
+   "\tmovq\t%rdi, %rbx",
+   "\tmovq\t-8(%rdi), %r12",
+   "\tcmpq\t$NANO_OUT_DIRECT, %r12",
+   "\tjge\t2f",
+   "\tmovq\tnano_out_len(%rip), %rax",
+   "\taddq\t%r12, %rax",
+   "\tcmpq\t$NANO_OUT_SIZE, %rax",
+   "\tjle\t1f",
+   "\tcall\tnano_flush",
+   "1:\tleaq\tnano_out(%rip), %rdi",
+   "\taddq\tnano_out_len(%rip), %rdi",
+   "\tmovq\t%rbx, %rsi",
+   "\tmovq\t%r12, %rdx",
+   "\tcall\tmemcpy@PLT",
+   "\taddq\t%r12, nano_out_len(%rip)",
+   "\tcmpb\t$0, nano_out_line(%rip)",
+   "\tje\t3f",
+   "\tmovq\t%rbx, %rdi",
+   "\tmovl\t$10, %esi",
+   "\tmovq\t%r12, %rdx",
+   "\tcall\tmemchr@PLT",
+   "\ttestq\t%rax, %rax",
+   "\tjz\t3f",
+   "\tcall\tnano_flush",
+   "\tjmp\t3f",
+   "# Long string: one writev for the buffer and the string, nano_write",
+   "# for what it left over",
+   "2:\tleaq\tnano_out(%rip), %rax",
+   "\tmovq\t%rax, (%rsp)",
+   "\tmovq\tnano_out_len(%rip), %rax",
+   "\tmovq\t%rax, 8(%rsp)",
+   "\tmovq\t%rbx, 16(%rsp)",
+   "\tmovq\t%r12, 24(%rsp)",
+   "\tmovq\t$0, nano_out_len(%rip)",
+   "\tmovl\t$1, %edi",
+   "\tmovq\t%rsp, %rsi",
+   "\tmovl\t$2, %edx",
+   "\tcall\twritev@PLT",
+   "\ttestq\t%rax, %rax",
+   "\tjns\t5f",
+   "\txorl\t%eax, %eax",
+   "5:\tmovq\t8(%rsp), %rsi",
+   "\tsubq\t%rsi, %rax",
+   "\tjge\t6f",
+   "\tleaq\tnano_out(%rip), %rdi",
+   "\taddq\t%rsi, %rdi",
+   "\taddq\t%rax, %rdi",
+   "\tnegq\t%rax",
+   "\tmovq\t%rax, %rsi",
+   "\tcall\tnano_write",
+   "\txorl\t%eax, %eax",
+   "6:\tleaq\t(%rbx,%rax), %rdi",
+   "\tmovq\t%r12, %rsi",
+   "\tsubq\t%rax, %rsi",
+   "\tcall\tnano_write",
+   "3:\taddq\t$40, %rsp",
+   "\tpopq\t%r12",
+   "\tpopq\t%rbx",
+   "4:\tret",
+   "",
+   "nano_flush:",
+   "\tleaq\tnano_out(%rip), %rdi",
+   "\tmovq\tnano_out_len(%rip), %rsi",
+   "\tmovq\t$0, nano_out_len(%rip)",
+   "",
+   "# Write %rsi bytes from %rdi, retrying after partial writes and",
+   "# interrupts, giving up on errors",
+   "nano_write:",
+   "\tpushq\t%rbx",
+   "\tpushq\t%r12",
+   "\tsubq\t$8, %rsp",
+   "\tmovq\t%rdi, %rbx",
+   "\tmovq\t%rsi, %r12",
+   "1:\ttestq\t%r12, %r12",
+   "\tjle\t3f",
+   "\tmovl\t$1, %edi",
+   "\tmovq\t%rbx, %rsi",
+   "\tmovq\t%r12, %rdx",
+   "\tcall\twrite@PLT",
+   "\ttestq\t%rax, %rax",
+   "\tjs\t2f",
+   "\tjz\t3f",
+   "\taddq\t%rax, %rbx",
+   "\tsubq\t%rax, %r12",
+   "\tjmp\t1b",
+   "2:\tcall\t__errno_location@PLT",
+   "\tcmpl\t$EINTR, (%rax)",
+   "\tje\t1b",
+   "3:\taddq\t$8, %rsp",
+   "\tpopq\t%r12",
+   "\tpopq\t%rbx",
+   "\tret",
+   "",
+   "nano_strcmp:",
+   "\txorl\t%eax, %eax",
+   "\tcmpq\t%rsi, %rdi",
+   "\tje\t1f",
+   "\tleaq\t.Lempty(%rip), %rax",
+   "\ttestq\t%rdi, %rdi",
+   "\tcmoveq\t%rax, %rdi",
+   "\ttestq\t%rsi, %rsi",
+   "\tcmoveq\t%rax, %rsi",
+   "\tjmp\tstrcmp@PLT",
+   "1:\tret",
+   "",
+   "nano_str_arg:",
+   "\tpushq\t%rbx",
+   "\tpushq\t%r12",
+   "\tsubq\t$8, %rsp",
+   "\tmovq\t%rdi, %rbx",
+   "\tcall\tstrlen@PLT",
+   "\tmovq\t%rax, %r12",
+   "\tleaq\t9(%rax), %rdi",
+   "\tcall\tmalloc@PLT",
+   "\ttestq\t%rax, %rax",
+   "\tjz\tnano_no_memory",
+   "\tmovq\t%r12, (%rax)",
+   "\tleaq\t8(%rax), %rdi",
+   "\tmovq\t%rbx, %rsi",
+   "\tleaq\t1(%r12), %rdx",
+   "\tcall\tmemcpy@PLT",
+   "\taddq\t$8, %rsp",
+   "\tpopq\t%r12",
+   "\tpopq\t%rbx",
+   "\tret",
+   "",
+   "# Lowest stack address for generated code: the stack size limit",
+   "# (at most NANO_STACK_MAX) below the caller, less a reserve",
+   "nano_stack_init:",
+   "\tsubq\t$24, %rsp",
+   "\tmovl\t$RLIMIT_STACK, %edi",
+   "\tmovq\t%rsp, %rsi",
+   "\tcall\tgetrlimit@PLT",
+   "\tmovq\t(%rsp), %rax",
+   "\tmovq\t$NANO_STACK_MAX, %rcx",
+   "\tcmpq\t%rcx, %rax",
+   "\tcmovaq\t%rcx, %rax",
+   "\tleaq\tNANO_STACK_RESERVE(%rsp), %rdx",
+   "\tsubq\t%rax, %rdx",
+   "\tmovq\t%rdx, nano_stack_limit(%rip)",
+   "\taddq\t$24, %rsp",
+   "\tret",
+   "",
+   "nano_stack_overflow:",
+   "\tleaq\t.Lmsg_stack(%rip), %rdi",
+   "\tjmp\tnano_error",
+   "",
+   "nano_no_memory:",
+   "\tleaq\t.Lmsg_mem(%rip), %rdi",
+   "\tjmp\tnano_error",
+   "",
+   "nano_div_zero:",
+   "\tleaq\t.Lmsg_div(%rip), %rdi",
+   "nano_error:",
+   "\tpushq\t%rbx",
+   "\tmovq\t%rdi, %rbx",
+   "\tcall\tnano_flush",
+   "\tmovq\tstderr@GOTPCREL(%rip), %rax",
+   "\tmovq\t(%rax), %rdi",
+   "\tleaq\t.Lfmt_err(%rip), %rsi",
+   "\tmovq\t%rbx, %rdx",
+   "\txorl\t%eax, %eax",
+   "\tcall\tfprintf@PLT",
+   "\tmovl\t$1, %edi",
+   "\tcall\texit@PLT",
+   NULL
+};
+
+static char* as_runtime_data[] =
+{
+   "\t.balign\t8",
+   ".Ldec_pow10:",
+   "\t.quad\t1, 10, 100, 1000, 10000, 100000, 1000000, 10000000",
+   "\t.quad\t100000000, 1000000000, 10000000000, 100000000000",
+   "\t.quad\t1000000000000, 10000000000000, 100000000000000",
+   "\t.quad\t1000000000000000, 10000000000000000, 100000000000000000",
+   "\t.quad\t1000000000000000000, 0x8ac7230489e80000",
+   ".Ldec_pairs:",
+   "\t.ascii\t\"0001020304050607080910111213141516171819\"",
+   "\t.ascii\t\"2021222324252627282930313233343536373839\"",
+   "\t.ascii\t\"4041424344454647484950515253545556575859\"",
+   "\t.ascii\t\"6061626364656667686970717273747576777879\"",
+   "\t.ascii\t\"8081828384858687888990919293949596979899\"",
+   ".Lfmt_err:\t.string\t\"runtime error: %s\\n\"",
+   ".Lmsg_div:\t.string\t\"division by zero\"",
+   ".Lmsg_mem:\t.string\t\"out of memory\"",
+   ".Lmsg_stack:\t.string\t\"stack overflow\"",
+   ".Lempty:\t.string\t\"\"",
+   NULL
+};
+
+/* Output of the print statement, waiting to be written */
+static char* as_runtime_bss[] =
+{
+   "nano_stack_limit:\t.zero\t8",
+   "nano_out_len:\t.zero\t8",
+   "nano_out_line:\t.zero\t8",
+   "nano_out:\t.zero\tNANO_OUT_SIZE",
+   NULL
+};
+
+/* A parallel move between two locations (registers or memory) */
+typedef struct asmove
+{
+   char src[32];
+   char dst[32];
+}ASMoveCell, *ASMove_p;
+
+
+/*---------------------------------------------------------------------*/
+/*                      Forward Declarations                           */
+/*---------------------------------------------------------------------*/
+
+
+/*---------------------------------------------------------------------*/
+/*                         Internal Functions                          */
+/*---------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------
+//
+// Function: as_fits32()
+//
+//   Return true if k can be an immediate operand.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static inline bool as_fits32(long k)
+{
+   return k == (int)k;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: as_log2()
+//
+//   Return s if k is 2^s with 0 < s < 63, 0 otherwise.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static int as_log2(long k)
+{
+   int s;
+
+   for(s=1; s<63; s++)
+   {
+      if(k == 1l << s)
+      {
+         return s;
+      }
+   }
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: as_is_reg()
+// Function: as_opnd()
+//
+//   Check if a slot lives in a register, and return the operand for
+//   a slot (valid for the next few calls only).
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static inline bool as_is_reg(ASGen_p g, long slot)
+{
+   return g->loc[slot] >= 0;
+}
+
+static char* as_opnd(ASGen_p g, long slot)
+{
+   static char buf[8][32];
+   static int  next = 0;
+   char        *res;
+
+   if(as_is_reg(g, slot))
+   {
+      return as_reg[g->loc[slot]];
+   }
+   res  = buf[next];
+   next = (next+1)%8;
+   sprintf(res, "%d(%%rbp)", -8*(g->saved - g->loc[slot]));
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: as_load()
+// Function: as_store()
+// Function: as_mov()
+//
+//   Move the value of a slot into a register, a register into a slot,
+//   and one slot into another.
+//
+// Global Variables: -
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+static void as_load(ASGen_p g, long slot, char* reg)
+{
+   char *src = as_opnd(g, slot);
+
+   if(strcmp(src, reg) != 0)
+   {
+      fprintf(g->out, "\tmovq\t%s, %s\n", src, reg);
+   }
+}
+
+static void as_store(ASGen_p g, long slot, char* reg)
+{
+   char *dst = as_opnd(g, slot);
+
+   if(strcmp(dst, reg) != 0)
+   {
+      fprintf(g->out, "\tmovq\t%s, %s\n", reg, dst);
+   }
+}
+
+static void as_mov(ASGen_p g, long dst, long src)
+{
+   if(as_is_reg(g, dst))
+   {
+      as_load(g, src, as_opnd(g, dst));
+   }
+   else if(as_is_reg(g, src))
+   {
+      as_store(g, dst, as_opnd(g, src));
+   }
+   else if(g->loc[dst] != g->loc[src])
+   {
+      as_load(g, src, "%rax");
+      as_store(g, dst, "%rax");
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: as_binop()
+//
+//   Emit dst = a op b for a two-operand instruction op, where b is an
+//   operand string (immediate, scratch register or the operand of
+//   slot bslot, otherwise bslot is -1).
+//
+// Global Variables: -
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+static void as_binop(ASGen_p g, char* op, long dst, long a, char* b,
+                     long bslot)
+{
+   if(as_is_reg(g, dst) && (bslot < 0 || g->loc[bslot] != g->loc[dst]))
+   {
+      as_load(g, a, as_opnd(g, dst));
+      fprintf(g->out, "\t%s\t%s, %s\n", op, b, as_opnd(g, dst));
+   }
+   else
+   {
+      as_load(g, a, "%rax");
+      fprintf(g->out, "\t%s\t%s, %%rax\n", op, b);
+      as_store(g, dst, "%rax");
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: as_imm()
+//
+//   Return an operand for the constant k: an immediate, or %rcx after
+//   loading it there.
+//
+// Global Variables: -
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+static char* as_imm(ASGen_p g, long k)
+{
+   static char buf[32];
+
+   if(as_fits32(k))
+   {
+      sprintf(buf, "$%ld", k);
+      return buf;
+   }
+   fprintf(g->out, "\tmovabsq\t$%ld, %%rcx\n", k);
+   return "%rcx";
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: as_parallel_move()
+//
+//   Perform the moves in moves simultaneously (every destination
+//   occurs once, memory destinations are never sources). Cycles are
+//   broken with %rax.
+//
+// Global Variables: -
+//
+// Side Effects    : Output, changes moves
+//
+/----------------------------------------------------------------------*/
+
+static void as_parallel_move(ASGen_p g, ASMove_p moves, int n)
+{
+   int  i, j, pending = n;
+   bool ready;
+
+   /* Memory to memory first, they need %rax and block nothing */
+   for(i=0; i<n; i++)
+   {
+      if(strcmp(moves[i].src, moves[i].dst) == 0)
+      {
+         moves[i].dst[0] = '\0';
+         pending--;
+      }
+      else if(moves[i].src[0] != '%' && moves[i].dst[0] != '%')
+      {
+         fprintf(g->out, "\tmovq\t%s, %%rax\n\tmovq\t%%rax, %s\n",
+                 moves[i].src, moves[i].dst);
+         moves[i].dst[0] = '\0';
+         pending--;
+      }
+   }
+   while(pending)
+   {
+      for(i=0; i<n; i++)
+      {
+         if(!moves[i].dst[0])
+         {
+            continue;
+         }
+         ready = true;
+         for(j=0; j<n && ready; j++)
+         {
+            ready = j==i || !moves[j].dst[0] ||
+               strcmp(moves[j].src, moves[i].dst) != 0;
+         }
+         if(ready)
+         {
+            break;
+         }
+      }
+      if(i == n)
+      {
+         /* Only cycles left: save a destination that is still needed */
+         for(i=0; !moves[i].dst[0]; i++)
+         {
+         }
+         fprintf(g->out, "\tmovq\t%s, %%rax\n", moves[i].dst);
+         for(j=0; j<n; j++)
+         {
+            if(moves[j].dst[0] && strcmp(moves[j].src, moves[i].dst) == 0)
+            {
+               strcpy(moves[j].src, "%rax");
+            }
+         }
+      }
+      fprintf(g->out, "\tmovq\t%s, %s\n", moves[i].src, moves[i].dst);
+      moves[i].dst[0] = '\0';
+      pending--;
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: as_args()
+//
+//   Pass the n values in slots base, base+1, ... as arguments of a
+//   call. Return the number of bytes pushed (to be removed after the
+//   call).
+//
+// Global Variables: as_arg_reg
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+static long as_args(ASGen_p g, long base, int n)
+{
+   ASMoveCell moves[AS_ARG_REGS];
+   long       pushed = 0;
+   int        i;
+
+   if(n > AS_ARG_REGS)
+   {
+      /* Keep the stack aligned to 16 bytes */
+      if((n-AS_ARG_REGS)%2)
+      {
+         fprintf(g->out, "\tsubq\t$8, %%rsp\n");
+         pushed += 8;
+      }
+      for(i=n-1; i>=AS_ARG_REGS; i--)
+      {
+         fprintf(g->out, "\tpushq\t%s\n", as_opnd(g, base+i));
+         pushed += 8;
+      }
+   }
+   for(i=0; i<n && i<AS_ARG_REGS; i++)
+   {
+      strcpy(moves[i].src, as_opnd(g, base+i));
+      strcpy(moves[i].dst, as_arg_reg[i]);
+   }
+   as_parallel_move(g, moves, i);
+
+   return pushed;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: as_touch()
+//
+//   Record an occurrence of slot at position pc.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static void as_touch(ASGen_p g, long slot, long pc)
+{
+   ASInterval_p live = &g->live[slot];
+
+   assert(slot < g->slots);
+
+   if(live->start < 0 || pc < live->start)
+   {
+      live->start = pc;
+   }
+   if(pc > live->end)
+   {
+      live->end = pc;
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: as_operands()
+//
+//   Collect the slots read by the instruction at pc in use (return
+//   their number), and the slots it writes (*def ... *def+*def_ctr-1).
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static int as_operands(ASGen_p g, long pc, long* use, long* def,
+                       long* def_ctr)
+{
+   VMInstr *p = g->prog->code+pc;
+   int     n = 0, i, arity;
+
+   *def     = p[1].arg;
+   *def_ctr = 0;
+   switch(p[0].arg)
+   {
+   case BC_ADD:
+   case BC_SUB:
+   case BC_MUL:
+   case BC_DIV:
+   case BC_SCMP:
+         use[n++] = p[3].arg;
+         /* Fall through */
+   case BC_MOV:
+   case BC_ADDK:
+   case BC_SUBK:
+   case BC_MULK:
+   case BC_DIVK:
+   case BC_NEG:
+         use[n++] = p[2].arg;
+         /* Fall through */
+   case BC_LOADI:
+   case BC_LOADS:
+   case BC_GETG:
+         *def_ctr = 1;
+         break;
+   case BC_CLEAR:
+         *def_ctr = p[2].arg;
+         break;
+   case BC_SETG:
+         use[n++] = p[2].arg;
+         break;
+   case BC_JEQ:
+   case BC_JNE:
+   case BC_JLT:
+   case BC_JLE:
+   case BC_JGT:
+   case BC_JGE:
+         use[n++] = p[2].arg;
+         /* Fall through */
+   case BC_JEQK:
+   case BC_JNEK:
+   case BC_JLTK:
+   case BC_JLEK:
+   case BC_JGTK:
+   case BC_JGEK:
+   case BC_RET:
+   case BC_PRINTI:
+   case BC_PRINTS:
+         use[n++] = p[1].arg;
+         break;
+   case BC_CALL:
+         *def_ctr = 1;
+         arity = g->prog->funs[p[2].arg].arity;
+         for(i=0; i<arity; i++)
+         {
+            use[n++] = p[3].arg+i;
+         }
+         break;
+   case BC_TCALL:
+         for(i=0; i<p[3].arg; i++)
+         {
+            use[n++] = p[2].arg+i;
+         }
+         break;
+   default:
+         break;
+   }
+   return n;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: as_intervals()
+//
+//   Compute the live intervals of all slots of the current function:
+//   from the first to the last instruction where the slot is live
+//   (by backward dataflow analysis on the instructions) or written.
+//   Return the number of calls before every code position (relative
+//   to g->first).
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static long* as_intervals(ASGen_p g)
+{
+   VMInstr       *code = g->prog->code;
+   long          len = g->last-g->first, words = (g->slots+63)/64;
+   long          *calls, *pos, *index, *use, pc, op, i, j, k, n = 0;
+   long          def, def_ctr, succ[2];
+   unsigned long *in, *out;
+   int           use_ctr, succ_ctr;
+   bool          changed;
+
+   calls = calloc(len+2, sizeof(long));
+   pos   = malloc((len+1)*sizeof(long));
+   index = malloc((len+1)*sizeof(long));
+   use   = malloc((g->slots+1)*sizeof(long));
+   out   = malloc((words+1)*sizeof(unsigned long));
+   if(!calls || !pos || !index || !use || !out)
+   {
+      fprintf(stderr, "Out of memory in assembly generator!\n");
+      exit(EXIT_FAILURE);
+   }
+   for(pc=g->first; pc<g->last; pc += bc_op_len[op])
+   {
+      op = code[pc].arg;
+      index[pc-g->first] = n;
+      pos[n++] = pc;
+      if(op == BC_CALL || op == BC_TCALL || op == BC_SCMP ||
+         op == BC_PRINTI || op == BC_PRINTS)
+      {
+         calls[pc-g->first+1] = 1;
+      }
+   }
+   for(i=1; i<=len+1; i++)
+   {
+      calls[i] += calls[i-1];
+   }
+   in = calloc(n*words+1, sizeof(unsigned long));
+   if(!in)
+   {
+      fprintf(stderr, "Out of memory in assembly generator!\n");
+      exit(EXIT_FAILURE);
+   }
+
+   /* Slots live before every instruction, to the fixpoint */
+   do
+   {
+      changed = false;
+      for(i=n-1; i>=0; i--)
+      {
+         pc = pos[i];
+         op = code[pc].arg;
+         succ_ctr = 0;
+         if(op != BC_JMP && op != BC_TCALL && op != BC_RET &&
+            op != BC_RETNIL && i+1 < n)
+         {
+            succ[succ_ctr++] = i+1;
+         }
+         if((k = BCJumpOperand(op)))
+         {
+            succ[succ_ctr++] = index[code[pc+k].arg-g->first];
+         }
+         memset(out, 0, words*sizeof(unsigned long));
+         for(j=0; j<succ_ctr; j++)
+         {
+            for(k=0; k<words; k++)
+            {
+               out[k] |= in[succ[j]*words+k];
+            }
+         }
+         use_ctr = as_operands(g, pc, use, &def, &def_ctr);
+         for(k=def; k<def+def_ctr; k++)
+         {
+            out[k/64] &= ~(1ul << (k%64));
+         }
+         for(k=0; k<use_ctr; k++)
+         {
+            out[use[k]/64] |= 1ul << (use[k]%64);
+         }
+         for(k=0; k<words; k++)
+         {
+            if(out[k] != in[i*words+k])
+            {
+               in[i*words+k] = out[k];
+               changed = true;
+            }
+         }
+      }
+   }while(changed);
+
+   for(i=0; i<g->slots; i++)
+   {
+      g->live[i].start = -1;
+      g->live[i].end   = -1;
+      g->live[i].slot  = i;
+      g->live[i].entry = i < g->prog->funs[g->fun].arity ||
+         (n && ((in[i/64] >> (i%64)) & 1));
+      if(g->live[i].entry)
+      {
+         as_touch(g, i, g->first);
+      }
+   }
+   for(i=0; i<n; i++)
+   {
+      for(k=0; k<g->slots; k++)
+      {
+         if((in[i*words+k/64] >> (k%64)) & 1)
+         {
+            as_touch(g, k, pos[i]);
+         }
+      }
+      as_operands(g, pos[i], use, &def, &def_ctr);
+      for(k=def; k<def+def_ctr; k++)
+      {
+         as_touch(g, k, pos[i]);
+      }
+   }
+
+   free(pos);
+   free(index);
+   free(use);
+   free(out);
+   free(in);
+
+   return calls;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: as_cmp_start()
+//
+//   Order intervals by start.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static int as_cmp_start(const void* a, const void* b)
+{
+   const ASIntervalCell *x = a, *y = b;
+
+   return (x->start > y->start) - (x->start < y->start);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: as_allocate()
+//
+//   Linear-scan register allocation for the current function. Values
+//   live across a call only get callee saved registers - this
+//   includes parameters used by a call at the first instruction and
+//   still needed afterwards. If no register is free, the interval
+//   ending last is spilled.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void as_allocate(ASGen_p g)
+{
+   long          *calls = as_intervals(g);
+   ASInterval_p  order;
+   int           active[AS_REGS], active_ctr = 0;
+   int           n = 0, i, j, reg, slot, victim;
+   bool          busy[AS_REGS] = {false}, cross;
+
+   order = malloc((g->slots+1)*sizeof(ASIntervalCell));
+   if(!order)
+   {
+      fprintf(stderr, "Out of memory in assembly generator!\n");
+      exit(EXIT_FAILURE);
+   }
+   for(i=0; i<g->slots; i++)
+   {
+      if(g->live[i].start >= 0)
+      {
+         order[n++] = g->live[i];
+      }
+   }
+   qsort(order, n, sizeof(ASIntervalCell), as_cmp_start);
+
+   for(i=0; i<n; i++)
+   {
+      slot = order[i].slot;
+
+      /* Expire intervals that ended */
+      for(j=0; j<active_ctr; j++)
+      {
+         if(g->live[active[j]].end < order[i].start)
+         {
+            busy[g->loc[active[j]]] = false;
+            active[j--] = active[--active_ctr];
+         }
+      }
+
+      /* Calls after the start, or at it if the value is already there */
+      cross = calls[order[i].end-g->first] >
+         calls[order[i].start-g->first+!order[i].entry];
+      reg   = -1;
+      for(j=cross? 0 : AS_REGS-1; j>=0 && j<AS_REGS; j += cross? 1 : -1)
+      {
+         if(!busy[j] && (!cross || j < AS_CALLEE_SAVED))
+         {
+            reg = j;
+            break;
+         }
+      }
+      if(reg >= 0)
+      {
+         g->loc[slot] = reg;
+         busy[reg] = g->used[reg] = true;
+         active[active_ctr++] = slot;
+         continue;
+      }
+
+      victim = -1;
+      for(j=0; j<active_ctr; j++)
+      {
+         if((!cross || g->loc[active[j]] < AS_CALLEE_SAVED) &&
+            (victim < 0 || g->live[active[j]].end > g->live[active[victim]].end))
+         {
+            victim = j;
+         }
+      }
+      if(victim >= 0 && g->live[active[victim]].end > order[i].end)
+      {
+         g->loc[slot] = g->loc[active[victim]];
+         g->loc[active[victim]] = -(++g->spills);
+         active[victim] = slot;
+      }
+      else
+      {
+         g->loc[slot] = -(++g->spills);
+      }
+   }
+   free(order);
+   free(calls);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: as_string()
+//
+//   Print str as the operand of a .string directive.
+//
+// Global Variables: -
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+static void as_string(FILE* out, NanoStr str)
+{
+   putc('"', out);
+   for(; str && *str; str++)
+   {
+      if(*str == '"' || *str == '\\' ||
+         (unsigned char)*str < ' ' || (unsigned char)*str >= 127)
+      {
+         fprintf(out, "\\%03o", (unsigned char)*str);
+      }
+      else
+      {
+         putc(*str, out);
+      }
+   }
+   putc('"', out);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: as_epilogue()
+//
+//   Restore the callee saved registers and the frame pointer of the
+//   current function, leaving the return address on top of the
+//   stack.
+//
+// Global Variables: as_reg
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+static void as_epilogue(ASGen_p g)
+{
+   int i;
+
+   if(g->saved)
+   {
+      fprintf(g->out, "\tleaq\t%d(%%rbp), %%rsp\n", -8*g->saved);
+      for(i=AS_CALLEE_SAVED-1; i>=0; i--)
+      {
+         if(g->used[i])
+         {
+            fprintf(g->out, "\tpopq\t%s\n", as_reg[i]);
+         }
+      }
+   }
+   else
+   {
+      fprintf(g->out, "\tmovq\t%%rbp, %%rsp\n");
+   }
+   fprintf(g->out, "\tpopq\t%%rbp\n");
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: as_instr()
+//
+//   Emit the code for the instruction at pc.
+//
+// Global Variables: as_jcc
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+static void as_instr(ASGen_p g, long pc)
+{
+   VMInstr    *p   = g->prog->code+pc;
+   FILE       *out = g->out;
+   long       op   = p[0].arg, pushed;
+   int        shift, i;
+   ASMoveCell moves[2];
+
+   switch(op)
+   {
+   case BC_MOV:
+         as_mov(g, p[1].arg, p[2].arg);
+         break;
+   case BC_LOADI:
+         if(as_fits32(p[2].arg))
+         {
+            fprintf(out, "\tmovq\t$%ld, %s\n", p[2].arg, as_opnd(g, p[1].arg));
+         }
+         else
+         {
+            fprintf(out, "\tmovabsq\t$%ld, %%rax\n", p[2].arg);
+            as_store(g, p[1].arg, "%rax");
+         }
+         break;
+   case BC_LOADS:
+         fprintf(out, "\tleaq\t.LS%ld(%%rip), %%rax\n", pc);
+         as_store(g, p[1].arg, "%rax");
+         break;
+   case BC_GETG:
+         fprintf(out, "\tmovq\tnano_g_%s(%%rip), %%rax\n",
+                 g->st->symbols[p[2].arg].symbol);
+         as_store(g, p[1].arg, "%rax");
+         break;
+   case BC_SETG:
+         as_load(g, p[2].arg, "%rax");
+         fprintf(out, "\tmovq\t%%rax, nano_g_%s(%%rip)\n",
+                 g->st->symbols[p[1].arg].symbol);
+         break;
+   case BC_ADD:
+         as_binop(g, "addq", p[1].arg, p[2].arg, as_opnd(g, p[3].arg), p[3].arg);
+         break;
+   case BC_SUB:
+         as_binop(g, "subq", p[1].arg, p[2].arg, as_opnd(g, p[3].arg), p[3].arg);
+         break;
+   case BC_MUL:
+         as_binop(g, "imulq", p[1].arg, p[2].arg, as_opnd(g, p[3].arg), p[3].arg);
+         break;
+   case BC_DIV:
+         /* Divisors 0 and -1 take the slow path */
+         as_load(g, p[3].arg, "%rcx");
+         as_load(g, p[2].arg, "%rax");
+         fprintf(out, "\tleaq\t1(%%rcx), %%rdx\n"
+                 "\tcmpq\t$1, %%rdx\n"
+                 "\tjbe\t.Ld%ld\n"
+                 "\tcqto\n"
+                 "\tidivq\t%%rcx\n"
+                 "\tjmp\t.Ld%ldx\n"
+                 ".Ld%ld:\n"
+                 "\ttestq\t%%rcx, %%rcx\n"
+                 "\tjnz\t.Ld%ldn\n"
+                 "\tcall\tnano_div_zero\n"
+                 ".Ld%ldn:\n"
+                 "\tnegq\t%%rax\n"
+                 ".Ld%ldx:\n", pc, pc, pc, pc, pc, pc);
+         as_store(g, p[1].arg, "%rax");
+         break;
+   case BC_ADDK:
+         as_binop(g, "addq", p[1].arg, p[2].arg, as_imm(g, p[3].arg), -1);
+         break;
+   case BC_SUBK:
+         as_binop(g, "subq", p[1].arg, p[2].arg, as_imm(g, p[3].arg), -1);
+         break;
+   case BC_MULK:
+         if((shift = as_log2(p[3].arg)))
+         {
+            as_binop(g, "salq", p[1].arg, p[2].arg, as_imm(g, shift), -1);
+         }
+         else if(as_fits32(p[3].arg))
+         {
+            fprintf(out, "\timulq\t$%ld, %s, %%rax\n", p[3].arg,
+                    as_opnd(g, p[2].arg));
+            as_store(g, p[1].arg, "%rax");
+         }
+         else
+         {
+            as_binop(g, "imulq", p[1].arg, p[2].arg, as_imm(g, p[3].arg), -1);
+         }
+         break;
+   case BC_DIVK:
+         as_load(g, p[2].arg, "%rax");
+         if((shift = as_log2(p[3].arg)))
+         {
+            /* Round towards zero: add 2^shift-1 to negative dividends */
+            fprintf(out, "\tcqto\n"
+                    "\tshrq\t$%d, %%rdx\n"
+                    "\taddq\t%%rdx, %%rax\n"
+                    "\tsarq\t$%d, %%rax\n", 64-shift, shift);
+         }
+         else
+         {
+            fprintf(out, "\tmovabsq\t$%ld, %%rcx\n"
+                    "\tcqto\n"
+                    "\tidivq\t%%rcx\n", p[3].arg);
+         }
+         as_store(g, p[1].arg, "%rax");
+         break;
+   case BC_NEG:
+         as_load(g, p[2].arg, "%rax");
+         fprintf(out, "\tnegq\t%%rax\n");
+         as_store(g, p[1].arg, "%rax");
+         break;
+   case BC_SCMP:
+         strcpy(moves[0].src, as_opnd(g, p[2].arg));
+         strcpy(moves[0].dst, "%rdi");
+         strcpy(moves[1].src, as_opnd(g, p[3].arg));
+         strcpy(moves[1].dst, "%rsi");
+         as_parallel_move(g, moves, 2);
+         fprintf(out, "\tcall\tnano_strcmp\n\tmovslq\t%%eax, %%rax\n");
+         as_store(g, p[1].arg, "%rax");
+         break;
+   case BC_JMP:
+         fprintf(out, "\tjmp\t.L%ld\n", p[1].arg);
+         break;
+   case BC_JEQ:
+   case BC_JNE:
+   case BC_JLT:
+   case BC_JLE:
+   case BC_JGT:
+   case BC_JGE:
+         if(as_is_reg(g, p[1].arg) || as_is_reg(g, p[2].arg))
+         {
+            fprintf(out, "\tcmpq\t%s, %s\n", as_opnd(g, p[2].arg),
+                    as_opnd(g, p[1].arg));
+         }
+         else
+         {
+            as_load(g, p[1].arg, "%rax");
+            fprintf(out, "\tcmpq\t%s, %%rax\n", as_opnd(g, p[2].arg));
+         }
+         fprintf(out, "\t%s\t.L%ld\n", as_jcc[op-BC_JEQ], p[3].arg);
+         break;
+   case BC_JEQK:
+   case BC_JNEK:
+   case BC_JLTK:
+   case BC_JLEK:
+   case BC_JGTK:
+   case BC_JGEK:
+         fprintf(out, "\tcmpq\t%s, ", as_imm(g, p[2].arg));
+         fprintf(out, "%s\n", as_opnd(g, p[1].arg));
+         fprintf(out, "\t%s\t.L%ld\n", as_jcc[op-BC_JEQK], p[3].arg);
+         break;
+   case BC_CLEAR:
+         for(i=0; i<p[2].arg; i++)
+         {
+            if(g->live[p[1].arg+i].start >= 0)
+            {
+               fprintf(out, "\tmovq\t$0, %s\n", as_opnd(g, p[1].arg+i));
+            }
+         }
+         break;
+   case BC_PRINTI:
+   case BC_PRINTS:
+         as_load(g, p[1].arg, "%rdi");
+         fprintf(out, "\tcall\t%s\n",
+                 op == BC_PRINTI? "nano_print_int" : "nano_print_str");
+         break;
+   case BC_CALL:
+         pushed = as_args(g, p[3].arg, g->prog->funs[p[2].arg].arity);
+         fprintf(out, "\tcall\tnano_f_%s\n", g->st->symbols[p[2].arg].symbol);
+         if(pushed)
+         {
+            fprintf(out, "\taddq\t$%ld, %%rsp\n", pushed);
+         }
+         as_store(g, p[1].arg, "%rax");
+         break;
+   case BC_TCALL:
+         /* Arguments passed on the stack would lie in the frame that
+            is given up, so these calls are not replaced by jumps */
+         pushed = as_args(g, p[2].arg, p[3].arg);
+         if(pushed)
+         {
+            fprintf(out, "\tcall\tnano_f_%s\n\taddq\t$%ld, %%rsp\n"
+                    "\tjmp\t.Lret%ld\n",
+                    g->st->symbols[p[1].arg].symbol, pushed, g->fun);
+         }
+         else
+         {
+            as_epilogue(g);
+            fprintf(out, "\tjmp\tnano_f_%s\n",
+                    g->st->symbols[p[1].arg].symbol);
+         }
+         break;
+   case BC_RET:
+         as_load(g, p[1].arg, "%rax");
+         fprintf(out, "\tjmp\t.Lret%ld\n", g->fun);
+         break;
+   case BC_RETNIL:
+         fprintf(out, "\txorl\t%%eax, %%eax\n\tjmp\t.Lret%ld\n", g->fun);
+         break;
+   default:
+         assert(false && "Unknown opcode");
+         break;
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: as_function()
+//
+//   Allocate registers for and emit the function at global position
+//   fun (code from first to last).
+//
+// Global Variables: as_reg, as_arg_reg
+//
+// Side Effects    : Output, memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void as_function(ASGen_p g, long fun, long first, long last,
+                        bool* label)
+{
+   VMFun_p    f = &g->prog->funs[fun];
+   ASMove_p   moves;
+   long       pc, frame;
+   int        i, n;
+
+   g->fun    = fun;
+   g->first  = first;
+   g->last   = last;
+   g->slots  = f->frame_size;
+   g->spills = 0;
+   g->saved  = 0;
+   g->live   = malloc((g->slots+1)*sizeof(ASIntervalCell));
+   g->loc    = malloc((g->slots+1)*sizeof(int));
+   moves     = malloc((f->arity+1)*sizeof(ASMoveCell));
+   if(!g->live || !g->loc || !moves)
+   {
+      fprintf(stderr, "Out of memory in assembly generator!\n");
+      exit(EXIT_FAILURE);
+   }
+   for(i=0; i<AS_REGS; i++)
+   {
+      g->used[i] = false;
+   }
+   as_allocate(g);
+
+   /* The stack check comes first, so that nano_stack_overflow is
+      entered with the stack aligned as after a call */
+   fprintf(g->out, "\nnano_f_%s:\n"
+           "\tcmpq\tnano_stack_limit(%%rip), %%rsp\n"
+           "\tjb\tnano_stack_overflow\n"
+           "\tpushq\t%%rbp\n\tmovq\t%%rsp, %%rbp\n",
+           g->st->symbols[fun].symbol);
+   for(i=0; i<AS_CALLEE_SAVED; i++)
+   {
+      if(g->used[i])
+      {
+         fprintf(g->out, "\tpushq\t%s\n", as_reg[i]);
+         g->saved++;
+      }
+   }
+   frame = 8*g->spills + ((g->saved+g->spills)%2? 8 : 0);
+   if(frame)
+   {
+      fprintf(g->out, "\tsubq\t$%ld, %%rsp\n", frame);
+   }
+
+   /* Parameters into their places */
+   for(i=0, n=0; i<f->arity; i++)
+   {
+      if(i < AS_ARG_REGS)
+      {
+         strcpy(moves[n].src, as_arg_reg[i]);
+      }
+      else
+      {
+         sprintf(moves[n].src, "%d(%%rbp)", 16+8*(i-AS_ARG_REGS));
+      }
+      strcpy(moves[n].dst, as_opnd(g, i));
+      n++;
+   }
+   as_parallel_move(g, moves, n);
+
+   for(pc=first; pc<last; pc += bc_op_len[g->prog->code[pc].arg])
+   {
+      if(label[pc])
+      {
+         fprintf(g->out, ".L%ld:\n", pc);
+      }
+      as_instr(g, pc);
+   }
+
+   fprintf(g->out, ".Lret%ld:\n", fun);
+   as_epilogue(g);
+   fprintf(g->out, "\tret\n");
+
+   free(moves);
+   free(g->loc);
+   free(g->live);
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                         Exported Functions                          */
+/*---------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------
+//
+// Function: ASGenProgram()
+//
+//   Print the (not threaded) bytecode program prog, compiled from
+//   the program with global symbol table st, as assembly. The C
+//   main() passes the command line arguments to the parameters of
+//   the nanoLang main() (missing ones are empty) and returns its
+//   result. Output is line buffered if line_buffered is set or
+//   stdout is a terminal.
+//
+// Global Variables: as_runtime, as_runtime_data, as_runtime_bss,
+//                   as_arg_reg
+//
+// Side Effects    : Output, memory operations
+//
+/----------------------------------------------------------------------*/
+
+void ASGenProgram(FILE* out, SymbolTable_p st, VMProg_p prog,
+                  bool line_buffered)
+{
+   ASGenCell g;
+   bool      *label;
+   long      *entries, pc, op, i, j, n, next;
+   int       arity;
+
+   assert(!prog->threaded && prog->main_fun >= 0);
+
+   g.out  = out;
+   g.prog = prog;
+   g.st   = st;
+
+   label   = calloc(prog->code_ctr+1, sizeof(bool));
+   entries = malloc((prog->global_ctr+1)*sizeof(long));
+   if(!label || !entries)
+   {
+      fprintf(stderr, "Out of memory in assembly generator!\n");
+      exit(EXIT_FAILURE);
+   }
+   for(pc=0; pc<prog->code_ctr; pc += bc_op_len[op])
+   {
+      op = prog->code[pc].arg;
+      if((i = BCJumpOperand(op)))
+      {
+         label[prog->code[pc+i].arg] = true;
+      }
+   }
+   for(i=0, n=0; i<prog->global_ctr; i++)
+   {
+      if(prog->funs[i].entry >= 0)
+      {
+         entries[n++] = prog->funs[i].entry;
+      }
+   }
+
+   fprintf(out, "# Generated by nanoLangCompiler --emit-asm\n\n"
+           "\t.equ\tNANO_OUT_SIZE, %d\n\t.equ\tNANO_OUT_DIRECT, %d\n"
+           "\t.equ\tNANO_INT_CHARS, %d\n\t.equ\tEINTR, %d\n"
+           "\t.equ\tRLIMIT_STACK, %d\n\t.equ\tNANO_STACK_MAX, %ld\n"
+           "\t.equ\tNANO_STACK_RESERVE, %d\n\n\t.text\n\n",
+           NANO_OUT_SIZE, NANO_OUT_DIRECT, NANO_INT_CHARS, EINTR,
+           RLIMIT_STACK, AS_STACK_MAX, AS_STACK_RESERVE);
+   for(i=0; as_runtime[i]; i++)
+   {
+      fprintf(out, "%s\n", as_runtime[i]);
+   }
+   for(i=0; i<prog->global_ctr; i++)
+   {
+      if(prog->funs[i].entry < 0)
+      {
+         continue;
+      }
+      /* Functions are contiguous, ours ends where the next one starts */
+      next = prog->code_ctr;
+      for(j=0; j<n; j++)
+      {
+         if(entries[j] > prog->funs[i].entry && entries[j] < next)
+         {
+            next = entries[j];
+         }
+      }
+      as_function(&g, i, prog->funs[i].entry, next, label);
+   }
+
+   /* C entry point: argc in %ebx, argv in %r12 */
+   arity = prog->funs[prog->main_fun].arity;
+   fprintf(out, "\n\t.globl\tmain\nmain:\n"
+           "\tpushq\t%%rbp\n\tmovq\t%%rsp, %%rbp\n"
+           "\tpushq\t%%rbx\n\tpushq\t%%r12\n"
+           "\tmovl\t%%edi, %%ebx\n\tmovq\t%%rsi, %%r12\n"
+           "\tcall\tnano_stack_init\n");
+   if(line_buffered)
+   {
+      fprintf(out, "\tmovb\t$1, nano_out_line(%%rip)\n");
+   }
+   else
+   {
+      fprintf(out, "\tmovl\t$1, %%edi\n\tcall\tisatty@PLT\n"
+              "\tmovb\t%%al, nano_out_line(%%rip)\n");
+   }
+   for(i=0; i<arity; i++)
+   {
+      fprintf(out, "\tcmpl\t$%ld, %%ebx\n"
+              "\tjle\t1f\n"
+              "\tmovq\t%ld(%%r12), %%rdi\n"
+              "\tcall\tnano_str_arg\n"
+              "\tmovq\t%%rax, %ld(%%r12)\n"
+              "1:\n", i+1, 8*(i+1), 8*(i+1));
+   }
+   if(arity > AS_ARG_REGS && (arity-AS_ARG_REGS)%2)
+   {
+      fprintf(out, "\tsubq\t$8, %%rsp\n");
+   }
+   for(i=arity-1; i>=0; i--)
+   {
+      fprintf(out, "\txorl\t%%eax, %%eax\n"
+              "\tcmpl\t$%ld, %%ebx\n"
+              "\tjle\t1f\n"
+              "\tmovq\t%ld(%%r12), %%rax\n"
+              "1:\n", i+1, 8*(i+1));
+      if(i >= AS_ARG_REGS)
+      {
+         fprintf(out, "\tpushq\t%%rax\n");
+      }
+      else
+      {
+         fprintf(out, "\tmovq\t%%rax, %s\n", as_arg_reg[i]);
+      }
+   }
+   fprintf(out, "\tcall\tnano_f_%s\n"
+           "\tleaq\t-16(%%rbp), %%rsp\n"
+           "\tmovq\t%%rax, %%rbx\n\tcall\tnano_flush\n\tmovq\t%%rbx, %%rax\n"
+           "\tpopq\t%%r12\n\tpopq\t%%rbx\n\tpopq\t%%rbp\n\tret\n",
+           st->symbols[prog->main_fun].symbol);
+
+   fprintf(out, "\n\t.section\t.rodata\n");
+   for(i=0; as_runtime_data[i]; i++)
+   {
+      fprintf(out, "%s\n", as_runtime_data[i]);
+   }
+   /* String literals with their length in front, one copy of each
+      (reusing entries for the positions of the copies) */
+   entries = realloc(entries, (prog->code_ctr+1)*sizeof(long));
+   if(!entries)
+   {
+      fprintf(stderr, "Out of memory in assembly generator!\n");
+      exit(EXIT_FAILURE);
+   }
+   n = 0;
+   for(pc=0; pc<prog->code_ctr; pc += bc_op_len[op])
+   {
+      op = prog->code[pc].arg;
+      if(op != BC_LOADS)
+      {
+         continue;
+      }
+      for(i=0; i<n && prog->code[entries[i]+2].str != prog->code[pc+2].str;
+          i++)
+      {
+      }
+      if(i < n)
+      {
+         fprintf(out, "\t.set\t.LS%ld, .LS%ld\n", pc, entries[i]);
+         continue;
+      }
+      entries[n++] = pc;
+      fprintf(out, "\t.balign\t8\n\t.quad\t%ld\n.LS%ld:\t.string\t",
+              NanoStrLen(prog->code[pc+2].str), pc);
+      as_string(out, prog->code[pc+2].str);
+      putc('\n', out);
+   }
+
+   fprintf(out, "\n\t.bss\n\t.align\t8\n");
+   for(i=0; as_runtime_bss[i]; i++)
+   {
+      fprintf(out, "%s\n", as_runtime_bss[i]);
+   }
+   for(i=0; i<prog->global_ctr; i++)
+   {
+      if(prog->funs[i].entry < 0)
+      {
+         fprintf(out, "nano_g_%s:\t.zero\t8\n", st->symbols[i].symbol);
+      }
+   }
+   fprintf(out, "\n\t.section\t.note.GNU-stack,\"\",@progbits\n");
+
+   free(entries);
+   free(label);
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                        End of File                                  */
+/*---------------------------------------------------------------------*/
@@ -0,0 +1,101 @@
+/*-----------------------------------------------------------------------
+
+File  : asmgen.h
+
+Authors: Konstantin Kläger, Isabel Staaden, Carolin Rösch
+
+Contents
+
+  Native x86-64 backend: translation of nanoLang bytecode (see
+  bytecode.h) into GNU as assembly for the System V ABI. The frame
+  slots of a function (locals and temporaries) are its virtual
+  registers. They are placed into machine registers by linear-scan
+  allocation over their live intervals, and spilled into the stack
+  frame only when no register is left.
+
+  Register usage:
+
+    rbx, r12-r15             Values live across calls
+    rsi, rdi, r8-r11         Values not live across calls
+    rax, rcx, rdx            Scratch
+
+  nanoLang functions are ordinary C functions (arguments in rdi, rsi,
+  rdx, rcx, r8, r9 and on the stack, result in rax). Tail calls
+  (BC_TCALL) that pass all arguments in registers jump to the callee
+  after the epilogue. The runtime (print, string comparison, errors)
+  is emitted in assembly as well and uses only the C library. Deep
+  recursion ends with the runtime error "stack overflow" instead of a
+  crash.
+
+  This code is released under the GNU General Public Licence.
+
+Changes
+
+<1> Sun Oct 18 08:31:52 CEST 2026
+    New
+
+-----------------------------------------------------------------------*/
+
+#ifndef ASMGEN
+
+#define ASMGEN
+
+#include "bytecode.h"
+
+
+/*---------------------------------------------------------------------*/
+/*                    Data type declarations                           */
+/*---------------------------------------------------------------------*/
+
+/* Allocatable registers: the first AS_CALLEE_SAVED survive calls */
+#define AS_REGS          11
+#define AS_CALLEE_SAVED  5
+
+/* Every function checks on entry that the stack pointer is above
+   nano_stack_limit. The limit is set below the stack pointer of
+   main() by the stack size limit of the process (at most
+   AS_STACK_MAX), less AS_STACK_RESERVE bytes for the runtime and
+   what lies above main() (arguments and environment). */
+#define AS_STACK_MAX     (1024L*1024*1024)
+#define AS_STACK_RESERVE (256*1024)
+
+/* Live interval of a frame slot (start = -1: unused) */
+typedef struct asinterval
+{
+   long start;
+   long end;
+   int  slot;
+   bool entry;  /* Live on function entry (parameters) */
+}ASIntervalCell, *ASInterval_p;
+
+/* State of the code generator for the current function */
+typedef struct asgen
+{
+   FILE          *out;
+   VMProg_p      prog;
+   SymbolTable_p st;
+   long          fun;        /* Global position of the function */
+   long          first;      /* Code range of the function */
+   long          last;
+   int           slots;
+   ASInterval_p  live;       /* Indexed by slot */
+   int           *loc;       /* Register (>= 0) or spill slot -(n+1) */
+   int           spills;
+   bool          used[AS_REGS];
+   int           saved;      /* Number of pushed callee saved registers */
+}ASGenCell, *ASGen_p;
+
+
+/*---------------------------------------------------------------------*/
+/*                Exported Functions and Variables                     */
+/*---------------------------------------------------------------------*/
+
+void ASGenProgram(FILE* out, SymbolTable_p st, VMProg_p prog,
+                  bool line_buffered);
+
+
+#endif
+
+/*---------------------------------------------------------------------*/
+/*                        End of File                                  */
+/*---------------------------------------------------------------------*/
@@ -2,6 +2,7 @@
 
 
 long nodectr=0;
+Arena_p ast_arena = NULL;
 
 char* ast_name[] =
 {
@@ -85,6 +86,14 @@ AST_p ASTEmptyAlloc(void)
 
    ast->type = nil;
    ast->litval = NULL;
+   ast->intval = 0;
+   ast->line = 0;
+   ast->column = 0;
+   ast->context = NULL;
+   ast->result_type = T_NoType;
+   ast->sym_table = NULL;
+   ast->sym_slot = -1;
+   ast->tail_call = false;
    ast->nodectr = nodectr++;
    for(i=0; i<MAXCHILD; i++)
    {
@@ -101,7 +110,7 @@ AST_p ASTAlloc(ASTNodeType type, char* litval, long intval, AST_p child0,
    ast->type = type;
    if(litval)
    {
-      ast->litval = strdup(litval);
+      ast->litval = StrIntern(litval);
    }
    ast->intval = intval;
    ast->child[0] = child0;
@@ -113,11 +122,35 @@ AST_p ASTAlloc(ASTNodeType type, char* litval, long intval, AST_p child0,
    return ast;
 }
 
+/* Turn the cell of an operator token into an inner node, so that
+   operators do not cost a second allocation. The node keeps the
+   position of the token. */
+AST_p ASTTokenNode2(AST_p token, ASTNodeType type, AST_p child0, AST_p child1)
+{
+   token->type = type;
+   token->child[0] = child0;
+   token->child[1] = child1;
+
+   return token;
+}
+
+/* Make all further AST allocations come from arena (or from the
+   heap, if arena is NULL). Nodes from an arena must not be ASTFree()d
+   after switching away from it - release the arena instead. */
+void ASTSetArena(Arena_p arena)
+{
+   ast_arena = arena;
+}
+
 void ASTFree(AST_p junk)
 {
+   if(ast_arena)
+   {
+      /* Everything goes away with the arena */
+      return;
+   }
    if(junk)
    {
-      free(junk->litval);
       int i;
 
       for(i=0; junk->child[i]; i++)
@@ -8,6 +8,8 @@
 #include <string.h>
 #include <assert.h>
 #include "symbols.h"
+#include "arena.h"
+#include "intern.h"
 
 
 typedef enum
@@ -68,7 +70,7 @@ typedef struct astcell
 {
   ASTNodeType type;
   long        nodectr;
-  char*       litval;
+  char*       litval;      /* Interned, see intern.h */
   long        intval;
   int         line;
   int         column;
@@ -76,14 +78,39 @@ typedef struct astcell
   SymbolTable_p context;     /* For semantic checks and type
                                 inference */
   TypeIndex     result_type; /* If any */
+  SymbolTable_p sym_table;   /* Identifiers and calls: Scope and */
+  int           sym_slot;    /* position of the symbol they denote */
+  bool          tail_call;   /* See ASTIsTailCall() */
 }ASTCell, *AST_p;
 
+/* The symbol an identifier or call has been bound to by
+ * ASTSemanticCheck() (check sym_table first!) */
+#define ASTSymbol(ast) (&((ast)->sym_table->symbols[(ast)->sym_slot]))
+#define ASTBind(ast, table, slot) ((ast)->sym_table=(table), (ast)->sym_slot=(slot))
+
+/* A return statement that returns the result of a call (marked by
+ * the semantic analysis, the inliner may have replaced the call
+ * since). Execution engines reuse the frame and jump instead of
+ * calling. */
+#define ASTIsTailCall(ast) ((ast)->type == ret_stmt && (ast)->tail_call && \
+                            (ast)->child[1]->type == funcall)
+
 
 extern long nodectr;
+extern char* ast_name[];
+
+/* If set, all AST nodes and their literal values are allocated from
+ * this arena (owned by the current compilation unit) and are only
+ * released with the arena. Otherwise we use malloc()/free(). */
+extern Arena_p ast_arena;
 
-#define ASTCellAlloc()    (ASTCell*)malloc(sizeof(ASTCell))
+#define ASTCellAlloc()    (ast_arena? \
+                           (ASTCell*)ArenaMalloc(ast_arena, sizeof(ASTCell)):\
+                           (ASTCell*)malloc(sizeof(ASTCell)))
 #define ASTCellFree(junk) free(junk)
 
+void   ASTSetArena(Arena_p arena);
+
 AST_p ASTEmptyAlloc(void);
 AST_p  ASTAlloc(ASTNodeType type, char* litval, long intval,
                 AST_p child0, AST_p child1, AST_p child2, AST_p child3);
@@ -91,6 +118,8 @@ AST_p  ASTAlloc(ASTNodeType type, char* litval, long intval,
 #define ASTAlloc2(type, litval, intval, child0, child1) \
    ASTAlloc((type), (litval), (intval), (child0), (child1), NULL, NULL)
 
+AST_p  ASTTokenNode2(AST_p token, ASTNodeType type, AST_p child0, AST_p child1);
+
 void   ASTFree(AST_p junk);
 
 void   DOTASTNodePrint(FILE* out, AST_p ast);
@@ -0,0 +1,1010 @@
+/*-----------------------------------------------------------------------
+
+File  : bytecode.c
+
+Authors: Konstantin Kläger, Isabel Staaden, Carolin Rösch
+
+Contents
+
+  Compilation of the SSA IR (see ir.h) into register bytecode.
+
+  This code is released under the GNU General Public Licence.
+
+Changes
+
+<1> Sun Oct 18 04:21:09 CEST 2026
+    New
+
+-----------------------------------------------------------------------*/
+
+#include "bytecode.h"
+#include "irpass.h"
+
+
+
+/*---------------------------------------------------------------------*/
+/*                        Global Variables                             */
+/*---------------------------------------------------------------------*/
+
+char* bc_op_name[] =
+{
+   "mov", "loadi", "loads", "getg", "setg",
+   "add", "sub", "mul", "div", "addk", "subk", "mulk", "divk", "neg", "scmp",
+   "jmp", "jeq", "jne", "jlt", "jle", "jgt", "jge",
+   "jeqk", "jnek", "jltk", "jlek", "jgtk", "jgek",
+   "clear", "printi", "prints", "call", "tcall", "ret",
+   "retnil"
+};
+
+/* Instruction length in words (opcode and operands) */
+int bc_op_len[] =
+{
+   3, 3, 3, 3, 3,
+   4, 4, 4, 4, 4, 4, 4, 4, 3, 4,
+   2, 4, 4, 4, 4, 4, 4,
+   4, 4, 4, 4, 4, 4,
+   3, 2, 2, 4, 4, 2, 1
+};
+
+/* Relations (offsets from BC_JEQ) negated, and with swapped operands */
+static int bc_rel_neg[]  = {1, 0, 5, 4, 3, 2};
+static int bc_rel_swap[] = {0, 1, 4, 5, 2, 3};
+
+/* A pending jump: operand to patch with the code offset of block */
+typedef struct bcfix
+{
+   long pos;
+   int  block;
+}BCFixCell, *BCFix_p;
+
+/* Copies for a branch edge, emitted behind the function */
+typedef struct bctramp
+{
+   long pos;
+   int  from;
+   int  to;
+}BCTrampCell, *BCTramp_p;
+
+/* State of the compilation of one function */
+typedef struct bccomp
+{
+   VMProg_p    prog;
+   IRFun_p     fun;
+   int         *slot;      /* Per value: frame slot, -1 for none */
+   int         *arg;       /* Per value: computed into argument slot n-1 */
+   int         colors;     /* Slots for values, argument slots follow */
+   int         scratch;    /* First of 3 scratch slots behind the arguments */
+   long        *block_pc;
+   BCFix_p     fix;
+   int         fix_ctr;
+   int         fix_size;
+   BCTramp_p   tramp;
+   int         tramp_ctr;
+   int         tramp_size;
+}BCCompCell, *BCComp_p;
+
+
+/*---------------------------------------------------------------------*/
+/*                      Forward Declarations                           */
+/*---------------------------------------------------------------------*/
+
+
+/*---------------------------------------------------------------------*/
+/*                         Internal Functions                          */
+/*---------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------
+//
+// Function: bc_emit()
+//
+//   Append one word to the code. Return its offset.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static long bc_emit(VMProg_p prog, long word)
+{
+   if(prog->code_ctr == prog->code_size)
+   {
+      prog->code_size = prog->code_size? 2*prog->code_size : 1024;
+      prog->code = realloc(prog->code, prog->code_size*sizeof(VMInstr));
+      if(!prog->code)
+      {
+         fprintf(stderr, "Out of memory in bytecode compiler!\n");
+         exit(EXIT_FAILURE);
+      }
+   }
+   prog->code[prog->code_ctr].arg = word;
+   return prog->code_ctr++;
+}
+
+/* Shorthands for complete instructions */
+#define bc_emit1(p, op)             bc_emit((p), (op))
+#define bc_emit2(p, op, x)          (bc_emit((p), (op)), bc_emit((p), (x)))
+#define bc_emit3(p, op, x, y)       (bc_emit((p), (op)), bc_emit((p), (x)), \
+                                     bc_emit((p), (y)))
+#define bc_emit4(p, op, x, y, z)    (bc_emit((p), (op)), bc_emit((p), (x)), \
+                                     bc_emit((p), (y)), bc_emit((p), (z)))
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: bc_fixup()
+//
+//   Record that the word at pos (just emitted) is the code offset of
+//   block.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void bc_fixup(BCComp_p c, long pos, int block)
+{
+   if(c->fix_ctr == c->fix_size)
+   {
+      c->fix_size = c->fix_size? 2*c->fix_size : 64;
+      c->fix = IRRealloc(c->fix, c->fix_size*sizeof(BCFixCell));
+   }
+   c->fix[c->fix_ctr].pos   = pos;
+   c->fix[c->fix_ctr].block = block;
+   c->fix_ctr++;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: bc_targets()
+//
+//   Find the values that can be computed directly into the argument
+//   slot of the call using them: defined in the block of the call,
+//   used only there, and with no other call in between (that would
+//   overwrite the argument slots with its frame).
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static void bc_targets(BCComp_p c)
+{
+   IRFun_p   fun = c->fun;
+   IRBlock_p blk;
+   IRInstr_p call, def;
+   int       b, i, j, k, v;
+
+   for(b=0; b<fun->layout_ctr; b++)
+   {
+      blk = &fun->blocks[fun->layout[b]];
+      for(i=0; i<blk->code_ctr; i++)
+      {
+         call = &fun->instrs[blk->code[i]];
+         if(call->op != IR_CALL)
+         {
+            continue;
+         }
+         for(j=0; j<call->argc; j++)
+         {
+            v   = call->args[j];
+            def = &fun->instrs[v];
+            if(fun->use_ctr[v] != 1 || def->block != fun->layout[b] ||
+               def->op == IR_PHI || def->op == IR_PARAM || IRIsConst(fun, v))
+            {
+               continue;
+            }
+            for(k=i-1; blk->code[k] != v &&
+                   fun->instrs[blk->code[k]].op != IR_CALL; k--)
+            {
+            }
+            if(blk->code[k] == v)
+            {
+               c->arg[v] = j+1;
+            }
+         }
+      }
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: bc_pick()
+//
+//   Return a free slot, hint if it is free.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static int bc_pick(bool* busy, int hint)
+{
+   int i;
+
+   if(hint >= 0 && !busy[hint])
+   {
+      return hint;
+   }
+   for(i=0; busy[i]; i++)
+   {
+   }
+   return i;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: bc_color()
+//
+//   Assign frame slots to the values of the function. The blocks are
+//   visited in dominator tree order, so the values live at the start
+//   of a block already have their slots; a value gets a slot not
+//   used by any value live at its definition and releases it after
+//   its last use. Parameter i is in slot i. Values flowing into a
+//   phi prefer the slot of the phi, and phis that of an operand, to
+//   save copies. Pure values that are never used get no slot.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void bc_color(BCComp_p c)
+{
+   IRFun_p       fun   = c->fun;
+   int           n     = fun->instr_ctr, words = fun->live_words;
+   bool          *busy = IRAlloc((n+fun->arity+1)*sizeof(bool));
+   int           *hint = IRAlloc((n+1)*sizeof(int));
+   int           *last = IRAlloc((n+1)*sizeof(int));
+   bool          *dead = IRAlloc((n+1)*sizeof(bool));
+   unsigned long *live = IRAlloc((words+1)*sizeof(unsigned long));
+   int           i, j, k, b, v, w, color;
+   IRBlock_p     blk;
+   IRInstr_p     instr;
+
+   for(v=0; v<n; v++)
+   {
+      c->slot[v] = -1;
+      hint[v]    = -1;
+      last[v]    = -1;
+   }
+   c->colors = fun->arity;
+
+   for(i=0; i<fun->rpo_ctr; i++)
+   {
+      b   = fun->dom_order[i];
+      blk = &fun->blocks[b];
+
+      /* Last uses in this block, and values never used after their
+         definition */
+      memcpy(live, fun->live_out+(long)b*words, words*sizeof(unsigned long));
+      for(j=blk->code_ctr-1; j>=0; j--)
+      {
+         v     = blk->code[j];
+         instr = &fun->instrs[v];
+         dead[v] = !((live[v/64] >> (v%64)) & 1);
+         live[v/64] &= ~(1ul << (v%64));
+         if(instr->op == IR_PHI)
+         {
+            continue;
+         }
+         for(k=0; k<instr->argc; k++)
+         {
+            w = instr->args[k];
+            if(!IRIsConst(fun, w) && !((live[w/64] >> (w%64)) & 1))
+            {
+               last[w] = v;
+               live[w/64] |= 1ul << (w%64);
+            }
+         }
+      }
+
+      memset(busy, 0, (n+fun->arity+1)*sizeof(bool));
+      for(v=0; v<n; v++)
+      {
+         if(IRIsLive(fun, fun->live_in, b, v) && c->slot[v] >= 0)
+         {
+            busy[c->slot[v]] = true;
+         }
+      }
+      for(j=0; j<blk->code_ctr; j++)
+      {
+         v     = blk->code[j];
+         instr = &fun->instrs[v];
+         if(instr->op != IR_PHI)
+         {
+            for(k=0; k<instr->argc; k++)
+            {
+               w = instr->args[k];
+               if(last[w] == v && c->slot[w] >= 0)
+               {
+                  busy[c->slot[w]] = false;
+               }
+            }
+         }
+         if(instr->type == T_NoType || c->arg[v] ||
+            (dead[v] && !IRHasEffect(fun, v)) ||
+            (instr->op == IR_CALL && !fun->use_ctr[v]))
+         {
+            continue;
+         }
+         if(instr->op == IR_PHI)
+         {
+            for(k=0; k<instr->argc && hint[v] < 0; k++)
+            {
+               if(!IRIsConst(fun, instr->args[k]))
+               {
+                  w = instr->args[k];
+                  if(c->slot[w] >= 0 && !busy[c->slot[w]])
+                  {
+                     hint[v] = c->slot[w];
+                  }
+               }
+            }
+         }
+         color = instr->op == IR_PARAM? instr->k : bc_pick(busy, hint[v]);
+         c->slot[v] = color;
+         if(color >= c->colors)
+         {
+            c->colors = color+1;
+         }
+         if(instr->op == IR_PHI)
+         {
+            for(k=0; k<instr->argc; k++)
+            {
+               if(hint[instr->args[k]] < 0)
+               {
+                  hint[instr->args[k]] = color;
+               }
+            }
+         }
+         busy[color] = !dead[v];
+      }
+   }
+
+   free(busy);
+   free(hint);
+   free(last);
+   free(dead);
+   free(live);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: bc_use()
+//
+//   Return the slot holding the value v, loading constants into
+//   scratch slot n first.
+//
+// Global Variables: -
+//
+// Side Effects    : Emits code
+//
+/----------------------------------------------------------------------*/
+
+static long bc_use(BCComp_p c, int v, int n)
+{
+   IRInstr_p instr = &c->fun->instrs[v];
+
+   switch(instr->op)
+   {
+   case IR_CONST:
+         bc_emit3(c->prog, BC_LOADI, c->scratch+n, instr->k);
+         return c->scratch+n;
+   case IR_STR:
+         bc_emit3(c->prog, BC_LOADS, c->scratch+n, 0);
+         c->prog->code[c->prog->code_ctr-1].str = instr->str;
+         return c->scratch+n;
+   default:
+         if(c->arg[v])
+         {
+            return c->colors+c->arg[v]-1;
+         }
+         assert(c->slot[v] >= 0);
+         return c->slot[v];
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: bc_dst()
+//
+//   Return the slot the instruction v writes its value to (a scratch
+//   slot if it is not used).
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static long bc_dst(BCComp_p c, int v)
+{
+   if(c->arg[v])
+   {
+      return c->colors+c->arg[v]-1;
+   }
+   return c->slot[v] >= 0? c->slot[v] : c->scratch;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: bc_copies()
+//
+//   Emit the phi copies for the edge from block to succ. They happen
+//   in parallel, so they are ordered such that no slot is overwritten
+//   before it is read, with cycles broken by a scratch slot.
+//   Constants are loaded last.
+//
+// Global Variables: -
+//
+// Side Effects    : Emits code, memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void bc_copies(BCComp_p c, int block, int succ)
+{
+   IRFun_p   fun = c->fun;
+   IRBlock_p blk = &fun->blocks[succ];
+   IRInstr_p phi;
+   long      *dst = IRAlloc((blk->code_ctr+1)*sizeof(long));
+   long      *src = IRAlloc((blk->code_ctr+1)*sizeof(long));
+   int       pos, i, j, n = 0, v;
+   bool      blocked, progress;
+
+   for(pos=0; blk->preds[pos] != block; pos++)
+   {
+   }
+   for(i=0; i<blk->code_ctr && fun->instrs[blk->code[i]].op == IR_PHI; i++)
+   {
+      v = fun->instrs[blk->code[i]].args[pos];
+      if(c->slot[blk->code[i]] >= 0 && !IRIsConst(fun, v) &&
+         c->slot[v] != c->slot[blk->code[i]])
+      {
+         dst[n] = c->slot[blk->code[i]];
+         src[n] = c->slot[v];
+         n++;
+      }
+   }
+   while(n)
+   {
+      progress = false;
+      for(i=0; i<n; i++)
+      {
+         for(j=0, blocked=false; j<n && !blocked; j++)
+         {
+            blocked = j != i && src[j] == dst[i];
+         }
+         if(!blocked)
+         {
+            bc_emit3(c->prog, BC_MOV, dst[i], src[i]);
+            dst[i] = dst[--n];
+            src[i] = src[n];
+            progress = true;
+            i--;
+         }
+      }
+      if(!progress)
+      {
+         /* Only cycles left - save one source */
+         bc_emit3(c->prog, BC_MOV, c->scratch+2, src[0]);
+         for(j=1; j<n; j++)
+         {
+            if(src[j] == src[0])
+            {
+               src[j] = c->scratch+2;
+            }
+         }
+         src[0] = c->scratch+2;
+      }
+   }
+   for(i=0; i<blk->code_ctr && fun->instrs[blk->code[i]].op == IR_PHI; i++)
+   {
+      phi = &fun->instrs[blk->code[i]];
+      v   = phi->args[pos];
+      if(c->slot[blk->code[i]] >= 0 && IRIsConst(fun, v))
+      {
+         if(fun->instrs[v].op == IR_STR)
+         {
+            bc_emit3(c->prog, BC_LOADS, c->slot[blk->code[i]], 0);
+            c->prog->code[c->prog->code_ctr-1].str = fun->instrs[v].str;
+         }
+         else
+         {
+            bc_emit3(c->prog, BC_LOADI, c->slot[blk->code[i]],
+                     fun->instrs[v].k);
+         }
+      }
+   }
+   free(dst);
+   free(src);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: bc_has_copies()
+//
+//   Tell if the edge from block to succ needs phi copies.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static bool bc_has_copies(BCComp_p c, int block, int succ)
+{
+   IRFun_p   fun = c->fun;
+   IRBlock_p blk = &fun->blocks[succ];
+   int       pos, i, v;
+
+   for(pos=0; blk->preds[pos] != block; pos++)
+   {
+   }
+   for(i=0; i<blk->code_ctr && fun->instrs[blk->code[i]].op == IR_PHI; i++)
+   {
+      v = fun->instrs[blk->code[i]].args[pos];
+      if(c->slot[blk->code[i]] >= 0 &&
+         (IRIsConst(fun, v) || c->slot[v] != c->slot[blk->code[i]]))
+      {
+         return true;
+      }
+   }
+   return false;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: bc_branch()
+//
+//   Emit the conditional jump of the branch v at the end of block,
+//   followed by the way to the other successor. next is the block
+//   placed behind, which needs no jump.
+//
+// Global Variables: bc_rel_neg, bc_rel_swap
+//
+// Side Effects    : Emits code, memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void bc_branch(BCComp_p c, int block, int v, int next)
+{
+   IRFun_p   fun   = c->fun;
+   IRInstr_p instr = &fun->instrs[v];
+   IRBlock_p blk   = &fun->blocks[block];
+   int       rel   = instr->k, x = instr->args[0], y = instr->args[1];
+   int       succ  = blk->succ[0], fail = blk->succ[1], tmp;
+   long      a, b;
+
+   if(succ == next)
+   {
+      rel  = bc_rel_neg[rel];
+      succ = blk->succ[1];
+      fail = blk->succ[0];
+   }
+   if(fun->instrs[x].op == IR_CONST && fun->instrs[y].op != IR_CONST)
+   {
+      rel = bc_rel_swap[rel];
+      tmp = x;
+      x   = y;
+      y   = tmp;
+   }
+   a = bc_use(c, x, 0);
+   if(fun->instrs[y].op == IR_CONST)
+   {
+      bc_emit4(c->prog, BC_JEQK+rel, a, fun->instrs[y].k, -1);
+   }
+   else
+   {
+      b = bc_use(c, y, 1);
+      bc_emit4(c->prog, BC_JEQ+rel, a, b, -1);
+   }
+   if(bc_has_copies(c, block, succ))
+   {
+      if(c->tramp_ctr == c->tramp_size)
+      {
+         c->tramp_size = c->tramp_size? 2*c->tramp_size : 16;
+         c->tramp = IRRealloc(c->tramp, c->tramp_size*sizeof(BCTrampCell));
+      }
+      c->tramp[c->tramp_ctr].pos  = c->prog->code_ctr-1;
+      c->tramp[c->tramp_ctr].from = block;
+      c->tramp[c->tramp_ctr].to   = succ;
+      c->tramp_ctr++;
+   }
+   else
+   {
+      bc_fixup(c, c->prog->code_ctr-1, succ);
+   }
+   bc_copies(c, block, fail);
+   if(fail != next)
+   {
+      bc_emit2(c->prog, BC_JMP, -1);
+      bc_fixup(c, c->prog->code_ctr-1, fail);
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: bc_tail_call()
+//
+//   Return true if v is a call at the end of block whose value the
+//   block returns (it is followed by the IR_RET of its value only).
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static bool bc_tail_call(IRFun_p fun, IRBlock_p blk, int v)
+{
+   int ret = blk->code[blk->code_ctr-1];
+
+   return fun->instrs[v].op == IR_CALL &&
+      blk->code_ctr >= 2 && blk->code[blk->code_ctr-2] == v &&
+      fun->instrs[ret].op == IR_RET && fun->instrs[ret].args[0] == v;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: bc_instr()
+//
+//   Emit the code for the instruction v at the end of block.
+//
+// Global Variables: -
+//
+// Side Effects    : Emits code, memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void bc_instr(BCComp_p c, int block, int v, int next)
+{
+   VMProg_p  prog  = c->prog;
+   IRFun_p   fun   = c->fun;
+   IRInstr_p instr = &fun->instrs[v];
+   IRBlock_p blk   = &fun->blocks[block];
+   int       x, y, i, w;
+   long      k, a, b;
+
+   switch(instr->op)
+   {
+   case IR_PARAM:
+   case IR_PHI:
+         break;
+   case IR_ADD:
+   case IR_SUB:
+   case IR_MUL:
+   case IR_DIV:
+         x = instr->args[0];
+         y = instr->args[1];
+         if((instr->op == IR_ADD || instr->op == IR_MUL) &&
+            fun->instrs[x].op == IR_CONST)
+         {
+            /* Commutative - put the constant on the right */
+            x = instr->args[1];
+            y = instr->args[0];
+         }
+         k = fun->instrs[y].k;
+         a = bc_use(c, x, 0);
+         if(fun->instrs[y].op == IR_CONST &&
+            (instr->op != IR_DIV || (k != 0 && k != -1)))
+         {
+            /* BC_ADDK etc. are in the same order as BC_ADD etc. */
+            bc_emit4(prog, BC_ADDK+(instr->op-IR_ADD), bc_dst(c, v), a, k);
+         }
+         else
+         {
+            b = bc_use(c, y, 1);
+            bc_emit4(prog, BC_ADD+(instr->op-IR_ADD), bc_dst(c, v), a, b);
+         }
+         break;
+   case IR_NEG:
+         a = bc_use(c, instr->args[0], 0);
+         bc_emit3(prog, BC_NEG, bc_dst(c, v), a);
+         break;
+   case IR_SCMP:
+         a = bc_use(c, instr->args[0], 0);
+         b = bc_use(c, instr->args[1], 1);
+         bc_emit4(prog, BC_SCMP, bc_dst(c, v), a, b);
+         break;
+   case IR_GETG:
+         bc_emit3(prog, BC_GETG, bc_dst(c, v), instr->k);
+         break;
+   case IR_SETG:
+         a = bc_use(c, instr->args[0], 0);
+         bc_emit3(prog, BC_SETG, instr->k, a);
+         break;
+   case IR_CALL:
+         for(i=0; i<instr->argc; i++)
+         {
+            w = instr->args[i];
+            if(c->arg[w] == i+1)
+            {
+               continue;
+            }
+            switch(fun->instrs[w].op)
+            {
+            case IR_CONST:
+                  bc_emit3(prog, BC_LOADI, c->colors+i, fun->instrs[w].k);
+                  break;
+            case IR_STR:
+                  bc_emit3(prog, BC_LOADS, c->colors+i, 0);
+                  prog->code[prog->code_ctr-1].str = fun->instrs[w].str;
+                  break;
+            default:
+                  bc_emit3(prog, BC_MOV, c->colors+i, c->slot[w]);
+                  break;
+            }
+         }
+         if(bc_tail_call(fun, blk, v))
+         {
+            bc_emit4(prog, BC_TCALL, instr->k, c->colors, instr->argc);
+         }
+         else
+         {
+            bc_emit4(prog, BC_CALL, bc_dst(c, v), instr->k, c->colors);
+         }
+         break;
+   case IR_PRINT:
+         a = bc_use(c, instr->args[0], 0);
+         bc_emit2(prog, fun->instrs[instr->args[0]].type == T_String?
+                  BC_PRINTS : BC_PRINTI, a);
+         break;
+   case IR_JMP:
+         bc_copies(c, block, blk->succ[0]);
+         if(blk->succ[0] != next)
+         {
+            bc_emit2(prog, BC_JMP, -1);
+            bc_fixup(c, prog->code_ctr-1, blk->succ[0]);
+         }
+         break;
+   case IR_BR:
+         bc_branch(c, block, v, next);
+         break;
+   case IR_RET:
+         if(blk->code_ctr >= 2 &&
+            bc_tail_call(fun, blk, blk->code[blk->code_ctr-2]))
+         {
+            break; /* Done by BC_TCALL */
+         }
+         a = bc_use(c, instr->args[0], 0);
+         bc_emit2(prog, BC_RET, a);
+         break;
+   default:
+         assert(false && "Unexpected IR instruction in bc_instr()");
+         break;
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: bc_fundef()
+//
+//   Compile a function. The blocks are emitted in layout order, the
+//   copies for branch edges that need them behind the function.
+//
+// Global Variables: -
+//
+// Side Effects    : Emits code, memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void bc_fundef(VMProg_p prog, IRFun_p fun)
+{
+   VMFun_p    entry = &prog->funs[fun->sym];
+   BCCompCell c;
+   IRBlock_p  blk;
+   int        b, i, max_args = 0;
+
+   IRRequire(fun, IR_ALL);
+
+   memset(&c, 0, sizeof(BCCompCell));
+   c.prog     = prog;
+   c.fun      = fun;
+   c.slot     = IRAlloc((fun->instr_ctr+1)*sizeof(int));
+   c.arg      = IRAlloc((fun->instr_ctr+1)*sizeof(int));
+   c.block_pc = IRAlloc((fun->block_ctr+1)*sizeof(long));
+   memset(c.arg, 0, (fun->instr_ctr+1)*sizeof(int));
+   bc_targets(&c);
+   bc_color(&c);
+   for(i=0; i<fun->instr_ctr; i++)
+   {
+      if(fun->instrs[i].op == IR_CALL && fun->instrs[i].argc > max_args)
+      {
+         max_args = fun->instrs[i].argc;
+      }
+   }
+   c.scratch = c.colors+max_args;
+
+   entry->entry      = prog->code_ctr;
+   entry->arity      = fun->arity;
+   entry->frame_size = c.scratch+3;
+   for(b=0; b<fun->layout_ctr; b++)
+   {
+      c.block_pc[fun->layout[b]] = prog->code_ctr;
+      blk = &fun->blocks[fun->layout[b]];
+      for(i=0; i<blk->code_ctr; i++)
+      {
+         bc_instr(&c, fun->layout[b], blk->code[i],
+                  b+1 < fun->layout_ctr? fun->layout[b+1] : -1);
+      }
+   }
+   for(i=0; i<c.tramp_ctr; i++)
+   {
+      prog->code[c.tramp[i].pos].arg = prog->code_ctr;
+      bc_copies(&c, c.tramp[i].from, c.tramp[i].to);
+      bc_emit2(prog, BC_JMP, -1);
+      bc_fixup(&c, prog->code_ctr-1, c.tramp[i].to);
+   }
+   for(i=0; i<c.fix_ctr; i++)
+   {
+      prog->code[c.fix[i].pos].arg = c.block_pc[c.fix[i].block];
+   }
+
+   free(c.slot);
+   free(c.arg);
+   free(c.block_pc);
+   free(c.fix);
+   free(c.tramp);
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                         Exported Functions                          */
+/*---------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------
+//
+// Function: BCCompile()
+//
+//   Compile the (optimized) IR of a program into bytecode.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+VMProg_p BCCompile(IRProg_p ir)
+{
+   VMProg_p handle = VMProgCellAlloc();
+   long     i;
+
+   handle->code       = NULL;
+   handle->code_ctr   = 0;
+   handle->code_size  = 0;
+   handle->global_ctr = ir->global_ctr;
+   handle->funs       = calloc(ir->global_ctr+1, sizeof(VMFunCell));
+   handle->threaded   = false;
+   if(!handle->funs)
+   {
+      fprintf(stderr, "Out of memory in bytecode compiler!\n");
+      exit(EXIT_FAILURE);
+   }
+   for(i=0; i<ir->global_ctr; i++)
+   {
+      handle->funs[i].entry = -1;
+      if(ir->funs[i])
+      {
+         bc_fundef(handle, ir->funs[i]);
+      }
+   }
+   handle->main_fun = ir->main_fun;
+
+   return handle;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: VMProgFree()
+//
+//   Free a bytecode program (string immediates belong to the literal
+//   cache of the interpreter).
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+void VMProgFree(VMProg_p junk)
+{
+   free(junk->code);
+   free(junk->funs);
+   VMProgCellFree(junk);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: BCJumpOperand()
+//
+//   Return the operand position of the jump target of op, or 0.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+int BCJumpOperand(long op)
+{
+   if(op == BC_JMP)
+   {
+      return 1;
+   }
+   if(op >= BC_JEQ && op <= BC_JGEK)
+   {
+      return 3;
+   }
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: BCPrint()
+//
+//   Print the (not yet threaded) bytecode in readable form.
+//
+// Global Variables: bc_op_name, bc_op_len
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+void BCPrint(FILE* out, VMProg_p prog)
+{
+   long i, pc, op;
+   int  j;
+
+   assert(!prog->threaded);
+
+   for(i=0; i<prog->global_ctr; i++)
+   {
+      if(prog->funs[i].entry >= 0)
+      {
+         fprintf(out, "# Function %ld: arity %d, frame %d, entry %ld\n", i,
+                 prog->funs[i].arity, prog->funs[i].frame_size,
+                 prog->funs[i].entry);
+      }
+   }
+   for(pc=0; pc<prog->code_ctr; pc += bc_op_len[op])
+   {
+      op = prog->code[pc].arg;
+      fprintf(out, "%6ld: %-7s", pc, bc_op_name[op]);
+      for(j=1; j<bc_op_len[op]; j++)
+      {
+         if(op == BC_LOADS && j == 2)
+         {
+            fprintf(out, " \"%s\"", prog->code[pc+j].str);
+         }
+         else
+         {
+            fprintf(out, " %ld", prog->code[pc+j].arg);
+         }
+      }
+      fprintf(out, "\n");
+   }
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                        End of File                                  */
+/*---------------------------------------------------------------------*/
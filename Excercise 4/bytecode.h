@@ -0,0 +1,142 @@
+/*-----------------------------------------------------------------------
+
+File  : bytecode.h
+
+Authors: Konstantin Kläger, Isabel Staaden, Carolin Rösch
+
+Contents
+
+  Register based bytecode for nanoLang and the compiler from the SSA
+  IR (see ir.h) into it. Operands are frame slots, global positions,
+  immediates and jump targets. The values of a function are assigned
+  to frame slots by coloring (values that are never live at the same
+  time share a slot, parameters keep their slots), phis become copies
+  on the incoming edges. Constants are immediates where an
+  instruction takes one, and are loaded into scratch slots behind the
+  argument slots otherwise.
+
+  Calls use overlapping frames: the arguments are evaluated into
+  consecutive slots at the top of the caller's frame, and these
+  become the first slots (the parameters) of the callee's frame.
+  Values used only as an argument are computed directly into their
+  argument slot. A call whose value is returned right away (a tail
+  call) moves the arguments down to the first slots and reuses the
+  frame of the caller instead (BC_TCALL).
+
+  Instructions are a sequence of VMInstr words: the opcode followed
+  by its operands. Before the first run, the VM replaces opcodes by
+  the addresses of their implementations and jump targets by
+  pointers (direct threading, see vm.c).
+
+  This code is released under the GNU General Public Licence.
+
+Changes
+
+<1> Sun Oct 18 04:21:09 CEST 2026
+    New
+
+-----------------------------------------------------------------------*/
+
+#ifndef BYTECODE
+
+#define BYTECODE
+
+#include "ir.h"
+
+
+/*---------------------------------------------------------------------*/
+/*                    Data type declarations                           */
+/*---------------------------------------------------------------------*/
+
+/* Operand notation: d, a, b = frame slots, g = global position,
+   k = integer immediate, s = string immediate, L = jump target,
+   f = function (global position) */
+typedef enum
+{
+   BC_MOV,      /* d a      d = a */
+   BC_LOADI,    /* d k      d = k */
+   BC_LOADS,    /* d s      d = s */
+   BC_GETG,     /* d g      d = globals[g] */
+   BC_SETG,     /* g a      globals[g] = a */
+   BC_ADD,      /* d a b    d = a + b */
+   BC_SUB,      /* d a b */
+   BC_MUL,      /* d a b */
+   BC_DIV,      /* d a b */
+   BC_ADDK,     /* d a k    d = a + k */
+   BC_SUBK,     /* d a k */
+   BC_MULK,     /* d a k */
+   BC_DIVK,     /* d a k    k is neither 0 nor -1 */
+   BC_NEG,      /* d a      d = -a */
+   BC_SCMP,     /* d a b    d = string comparison of a and b (-1/0/1) */
+   BC_JMP,      /* L */
+   BC_JEQ,      /* a b L    if(a == b) goto L */
+   BC_JNE,      /* a b L */
+   BC_JLT,      /* a b L */
+   BC_JLE,      /* a b L */
+   BC_JGT,      /* a b L */
+   BC_JGE,      /* a b L */
+   BC_JEQK,     /* a k L    if(a == k) goto L */
+   BC_JNEK,     /* a k L */
+   BC_JLTK,     /* a k L */
+   BC_JLEK,     /* a k L */
+   BC_JGTK,     /* a k L */
+   BC_JGEK,     /* a k L */
+   BC_CLEAR,    /* a k      a ... a+k-1 = 0 */
+   BC_PRINTI,   /* a */
+   BC_PRINTS,   /* a */
+   BC_CALL,     /* d f a    d = f(a, a+1, ...) */
+   BC_TCALL,    /* f a k    return f(a, ..., a+k-1) in this frame */
+   BC_RET,      /* a        return a */
+   BC_RETNIL,   /*          return 0 */
+   BC_OPCOUNT
+}BCOp;
+
+typedef union vminstr
+{
+   long                arg;    /* Opcode (before threading), operands */
+   NanoStr             str;
+   const void          *op;    /* Threaded opcode */
+   union vminstr       *target;/* Threaded jump target */
+}VMInstr;
+
+typedef struct vmfun
+{
+   long    entry;      /* Code offset, -1 for non-functions */
+   VMInstr *entry_pc;  /* Set when threading */
+   int     frame_size; /* Locals and temporaries */
+   int     arity;
+}VMFunCell, *VMFun_p;
+
+typedef struct vmprog
+{
+   VMInstr *code;
+   long    code_ctr;
+   long    code_size;
+   VMFun_p funs;       /* Indexed by global symbol position */
+   long    global_ctr;
+   long    main_fun;
+   bool    threaded;
+}VMProgCell, *VMProg_p;
+
+
+/*---------------------------------------------------------------------*/
+/*                Exported Functions and Variables                     */
+/*---------------------------------------------------------------------*/
+
+extern char* bc_op_name[];
+extern int   bc_op_len[];
+
+#define VMProgCellAlloc()    (VMProgCell*)malloc(sizeof(VMProgCell))
+#define VMProgCellFree(junk) free(junk)
+
+VMProg_p BCCompile(IRProg_p ir);
+void     VMProgFree(VMProg_p junk);
+int      BCJumpOperand(long op);
+void     BCPrint(FILE* out, VMProg_p prog);
+
+
+#endif
+
+/*---------------------------------------------------------------------*/
+/*                        End of File                                  */
+/*---------------------------------------------------------------------*/
@@ -0,0 +1,917 @@
+/*-----------------------------------------------------------------------
+
+File  : cgen.c
+
+Authors: Konstantin Kläger, Isabel Staaden, Carolin Rösch
+
+Contents
+
+  Translation of the SSA IR (see ir.h) into C. Names are prefixed
+  (g_ globals, f_ functions, vN values, bN blocks, sN string
+  literals), so they can clash neither with C keywords nor with the
+  runtime. Every string literal is a constant object holding the
+  length and the characters, as in nanort.h. Every value that is
+  used becomes a variable of its function, every instruction one
+  statement (which also fixes the evaluation order), blocks are
+  labeled where control flow jumps to them, and phis are assigned
+  on the incoming edges.
+
+  This code is released under the GNU General Public Licence.
+
+Changes
+
+<1> Sun Oct 18 07:10:26 CEST 2026
+    New
+
+-----------------------------------------------------------------------*/
+
+#include "cgen.h"
+#include "irpass.h"
+
+
+
+/*---------------------------------------------------------------------*/
+/*                        Global Variables                             */
+/*---------------------------------------------------------------------*/
+
+/* Runtime support, semantics as in nanort.c */
+static char* cg_runtime[] =
+{
+   "#include <stdio.h>",
+   "#include <stdlib.h>",
+   "#include <string.h>",
+   "#include <errno.h>",
+   "#include <unistd.h>",
+   "#include <sys/uio.h>",
+   "",
+   "typedef const char* nano_str;",
+   "",
+   "/* Strings carry their length in the word in front of them */",
+   "#define nano_str_len(s) ((s)? ((const long*)(s))[-1] : 0)",
+   "",
+   "/* Wrap-around arithmetic without undefined behaviour */",
+   "#define nano_add(a, b) ((long)((unsigned long)(a)+(unsigned long)(b)))",
+   "#define nano_sub(a, b) ((long)((unsigned long)(a)-(unsigned long)(b)))",
+   "#define nano_mul(a, b) ((long)((unsigned long)(a)*(unsigned long)(b)))",
+   "#define nano_neg(a)    ((long)(0ul-(unsigned long)(a)))",
+   "",
+   "/* Output of the print statement, waiting to be written */",
+   "static char nano_out[NANO_OUT_SIZE];",
+   "static long nano_out_len;",
+   "static int  nano_out_line;",
+   "",
+   "static void nano_write(struct iovec* iov, int cnt)",
+   "{",
+   "   ssize_t done;",
+   "",
+   "   while(cnt)",
+   "   {",
+   "      done = writev(STDOUT_FILENO, iov, cnt);",
+   "      if(done < 0 && errno == EINTR)",
+   "      {",
+   "         continue;",
+   "      }",
+   "      if(done <= 0)",
+   "      {",
+   "         return;",
+   "      }",
+   "      while(cnt && (size_t)done >= iov->iov_len)",
+   "      {",
+   "         done -= iov->iov_len;",
+   "         iov++;",
+   "         cnt--;",
+   "      }",
+   "      if(cnt)",
+   "      {",
+   "         iov->iov_base  = (char*)iov->iov_base+done;",
+   "         iov->iov_len  -= done;",
+   "      }",
+   "   }",
+   "}",
+   "",
+   "static void nano_flush(void)",
+   "{",
+   "   struct iovec iov;",
+   "",
+   "   if(nano_out_len)",
+   "   {",
+   "      iov.iov_base = nano_out;",
+   "      iov.iov_len  = nano_out_len;",
+   "      nano_out_len = 0;",
+   "      nano_write(&iov, 1);",
+   "   }",
+   "}",
+   "",
+   "static inline void nano_error(const char* msg)",
+   "{",
+   "   nano_flush();",
+   "   fprintf(stderr, \"runtime error: %s\\n\", msg);",
+   "   exit(EXIT_FAILURE);",
+   "}",
+   "",
+   "static inline long nano_div(long a, long b)",
+   "{",
+   "   if(b == 0)",
+   "   {",
+   "      nano_error(\"division by zero\");",
+   "   }",
+   "   if(b == -1)",
+   "   {",
+   "      return nano_neg(a);",
+   "   }",
+   "   return a / b;",
+   "}",
+   "",
+   "static inline int nano_strcmp(nano_str a, nano_str b)",
+   "{",
+   "   long la, lb;",
+   "   int  res;",
+   "",
+   "   if(a == b)",
+   "   {",
+   "      return 0;",
+   "   }",
+   "   la  = nano_str_len(a);",
+   "   lb  = nano_str_len(b);",
+   "   res = memcmp(a? a : \"\", b? b : \"\", la < lb? la : lb);",
+   "   if(res)",
+   "   {",
+   "      return res < 0? -1 : 1;",
+   "   }",
+   "   return (la > lb) - (la < lb);",
+   "}",
+   "",
+   "static nano_str nano_str_arg(const char* arg)",
+   "{",
+   "   size_t len  = strlen(arg);",
+   "   long   *cell = malloc(sizeof(long)+len+1);",
+   "",
+   "   if(!cell)",
+   "   {",
+   "      nano_error(\"out of memory\");",
+   "   }",
+   "   cell[0] = len;",
+   "   memcpy(cell+1, arg, len+1);",
+   "   return (nano_str)(cell+1);",
+   "}",
+   "",
+   "static const char nano_dec_pairs[201] =",
+   "   \"0001020304050607080910111213141516171819\"",
+   "   \"2021222324252627282930313233343536373839\"",
+   "   \"4041424344454647484950515253545556575859\"",
+   "   \"6061626364656667686970717273747576777879\"",
+   "   \"8081828384858687888990919293949596979899\";",
+   "",
+   "static const unsigned long nano_dec_pow10[20] =",
+   "{",
+   "   1ul, 10ul, 100ul, 1000ul, 10000ul, 100000ul, 1000000ul, 10000000ul,",
+   "   100000000ul, 1000000000ul, 10000000000ul, 100000000000ul,",
+   "   1000000000000ul, 10000000000000ul, 100000000000000ul,",
+   "   1000000000000000ul, 10000000000000000ul, 100000000000000000ul,",
+   "   1000000000000000000ul, 10000000000000000000ul",
+   "};",
+   "",
+   "static inline int nano_int_to_dec(char* buf, long val)",
+   "{",
+   "   unsigned long u = val, q;",
+   "   int           len, digits;",
+   "   char          *p;",
+   "",
+   "   len = 0;",
+   "   if(val < 0)",
+   "   {",
+   "      buf[len++] = '-';",
+   "      u = 0ul-u;",
+   "   }",
+   "   digits  = ((64-__builtin_clzl(u|1))*1233) >> 12;",
+   "   digits += (u|1) >= nano_dec_pow10[digits];",
+   "   len    += digits;",
+   "",
+   "   p = buf+len;",
+   "   while(u >= 100)",
+   "   {",
+   "      q   = u/100;",
+   "      p  -= 2;",
+   "      memcpy(p, nano_dec_pairs+2*(u-100*q), 2);",
+   "      u   = q;",
+   "   }",
+   "   if(u >= 10)",
+   "   {",
+   "      memcpy(p-2, nano_dec_pairs+2*u, 2);",
+   "   }",
+   "   else",
+   "   {",
+   "      p[-1] = '0'+u;",
+   "   }",
+   "   return len;",
+   "}",
+   "",
+   "static inline void nano_print_int(long val)",
+   "{",
+   "   if(nano_out_len > NANO_OUT_SIZE-NANO_INT_CHARS)",
+   "   {",
+   "      nano_flush();",
+   "   }",
+   "   nano_out_len += nano_int_to_dec(nano_out+nano_out_len, val);",
+   "   nano_out[nano_out_len++] = '\\n';",
+   "   if(nano_out_line)",
+   "   {",
+   "      nano_flush();",
+   "   }",
+   "}",
+   "",
+   "static inline void nano_print_str(nano_str str)",
+   "{",
+   "   long         len = nano_str_len(str);",
+   "   struct iovec iov[2];",
+   "",
+   "   if(len >= NANO_OUT_DIRECT)",
+   "   {",
+   "      iov[0].iov_base = nano_out;",
+   "      iov[0].iov_len  = nano_out_len;",
+   "      iov[1].iov_base = (char*)str;",
+   "      iov[1].iov_len  = len;",
+   "      nano_out_len    = 0;",
+   "      nano_write(iov, 2);",
+   "      return;",
+   "   }",
+   "   if(nano_out_len+len > NANO_OUT_SIZE)",
+   "   {",
+   "      nano_flush();",
+   "   }",
+   "   memcpy(nano_out+nano_out_len, str, len);",
+   "   nano_out_len += len;",
+   "   if(nano_out_line && memchr(str, '\\n', len))",
+   "   {",
+   "      nano_flush();",
+   "   }",
+   "}",
+   NULL
+};
+
+
+/* C operators for the relations of IR_BR, and their negations */
+static char* cg_rel[]     = {"==", "!=", "<", "<=", ">", ">="};
+static char* cg_rel_neg[] = {"!=", "==", ">=", ">", "<=", "<"};
+
+
+/*---------------------------------------------------------------------*/
+/*                      Forward Declarations                           */
+/*---------------------------------------------------------------------*/
+
+
+/*---------------------------------------------------------------------*/
+/*                         Internal Functions                          */
+/*---------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------
+//
+// Function: cg_ctype()
+//
+//   Return the C type for a nanoLang type.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static inline char* cg_ctype(TypeIndex type)
+{
+   return type == T_String? "nano_str" : "long";
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: cg_string()
+//
+//   Print the string str as a C string literal.
+//
+// Global Variables: -
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+static void cg_string(CGen_p c, NanoStr str)
+{
+   NanoStr s;
+
+   putc('"', c->out);
+   for(s=str; s && *s; s++)
+   {
+      if(*s == '"' || *s == '\\' || *s == '?' ||
+         (unsigned char)*s < ' ' || (unsigned char)*s >= 127)
+      {
+         fprintf(c->out, "\\%03o", (unsigned char)*s);
+      }
+      else
+      {
+         putc(*s, c->out);
+      }
+   }
+   putc('"', c->out);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: cg_literal()
+//
+//   Return the number of the string literal str (the runtime keeps
+//   only one copy of every string, so the address identifies it),
+//   adding it if it is new.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static long cg_literal(CGen_p c, NanoStr str)
+{
+   long i;
+
+   for(i=0; i<c->lit_ctr; i++)
+   {
+      if(c->lits[i] == str)
+      {
+         return i;
+      }
+   }
+   if(c->lit_ctr == c->lit_size)
+   {
+      c->lit_size = c->lit_size? 2*c->lit_size : 16;
+      c->lits     = IRRealloc(c->lits, c->lit_size*sizeof(NanoStr));
+   }
+   c->lits[c->lit_ctr] = str;
+   return c->lit_ctr++;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: cg_literals()
+//
+//   Print the definitions of all string literals used in ir, each
+//   as a constant object with the length in front of the characters.
+//
+// Global Variables: -
+//
+// Side Effects    : Output, memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void cg_literals(CGen_p c, IRProg_p ir)
+{
+   IRFun_p   fun;
+   IRBlock_p blk;
+   IRInstr_p instr;
+   long      f, i;
+   int       b, j, k;
+
+   for(f=0; f<ir->global_ctr; f++)
+   {
+      if(!(fun = ir->funs[f]))
+      {
+         continue;
+      }
+      for(b=0; b<fun->layout_ctr; b++)
+      {
+         blk = &fun->blocks[fun->layout[b]];
+         for(j=0; j<blk->code_ctr; j++)
+         {
+            instr = &fun->instrs[blk->code[j]];
+            for(k=0; k<instr->argc; k++)
+            {
+               if(fun->instrs[instr->args[k]].op == IR_STR)
+               {
+                  cg_literal(c, fun->instrs[instr->args[k]].str);
+               }
+            }
+         }
+      }
+   }
+   if(c->lit_ctr)
+   {
+      fputs("\n", c->out);
+   }
+   for(i=0; i<c->lit_ctr; i++)
+   {
+      fprintf(c->out, "static const struct { long len; char s[%ld]; } "
+              "s%ld = {%ld, ", NanoStrLen(c->lits[i])+1, i,
+              NanoStrLen(c->lits[i]));
+      cg_string(c, c->lits[i]);
+      fputs("};\n", c->out);
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: cg_value()
+//
+//   Print the value v: constants as C literals, everything else as
+//   its variable.
+//
+// Global Variables: -
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+static void cg_value(CGen_p c, int v)
+{
+   IRInstr_p instr = &c->fun->instrs[v];
+
+   switch(instr->op)
+   {
+   case IR_CONST:
+         /* -LONG_MAX-1 has no literal of its own */
+         if(instr->type == T_String)
+         {
+            fputs("0", c->out);
+         }
+         else if(instr->k == LONG_MIN)
+         {
+            fprintf(c->out, "(%ldL-1)", LONG_MIN+1);
+         }
+         else
+         {
+            fprintf(c->out, instr->k < 0? "(%ldL)" : "%ldL", instr->k);
+         }
+         break;
+   case IR_STR:
+         fprintf(c->out, "s%ld.s", cg_literal(c, instr->str));
+         break;
+   default:
+         fprintf(c->out, "v%d", v);
+         break;
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: cg_is_var()
+//
+//   Tell if the value v is held in a C variable: it has a type, is no
+//   constant, and is used.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static inline bool cg_is_var(CGen_p c, int v)
+{
+   return c->fun->instrs[v].type != T_NoType && !IRIsConst(c->fun, v) &&
+      c->fun->use_ctr[v];
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: cg_copies()
+//
+//   Print the assignments to the phis of succ for the edge from
+//   block, indented by ind. They happen in parallel, so with more
+//   than one they go through temporaries.
+//
+// Global Variables: -
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+static void cg_copies(CGen_p c, int block, int succ, char* ind)
+{
+   IRFun_p   fun = c->fun;
+   IRBlock_p blk = &fun->blocks[succ];
+   int       pos, i, n = 0, phi;
+
+   for(pos=0; blk->preds[pos] != block; pos++)
+   {
+   }
+   for(i=0; i<blk->code_ctr && fun->instrs[blk->code[i]].op == IR_PHI; i++)
+   {
+      phi = blk->code[i];
+      if(cg_is_var(c, phi) && fun->instrs[phi].args[pos] != phi)
+      {
+         n++;
+      }
+   }
+   if(n == 1)
+   {
+      for(i=0; fun->instrs[blk->code[i]].op == IR_PHI; i++)
+      {
+         phi = blk->code[i];
+         if(cg_is_var(c, phi) && fun->instrs[phi].args[pos] != phi)
+         {
+            fprintf(c->out, "%sv%d = ", ind, phi);
+            cg_value(c, fun->instrs[phi].args[pos]);
+            fputs(";\n", c->out);
+         }
+      }
+   }
+   else if(n > 1)
+   {
+      fprintf(c->out, "%s{\n", ind);
+      for(i=0; fun->instrs[blk->code[i]].op == IR_PHI; i++)
+      {
+         phi = blk->code[i];
+         if(cg_is_var(c, phi) && fun->instrs[phi].args[pos] != phi)
+         {
+            fprintf(c->out, "%s   %s t%d = ", ind,
+                    cg_ctype(fun->instrs[phi].type), phi);
+            cg_value(c, fun->instrs[phi].args[pos]);
+            fputs(";\n", c->out);
+         }
+      }
+      for(i=0; fun->instrs[blk->code[i]].op == IR_PHI; i++)
+      {
+         phi = blk->code[i];
+         if(cg_is_var(c, phi) && fun->instrs[phi].args[pos] != phi)
+         {
+            fprintf(c->out, "%s   v%d = t%d;\n", ind, phi, phi);
+         }
+      }
+      fprintf(c->out, "%s}\n", ind);
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: cg_goto()
+//
+//   Print the way from block to succ (indented by ind): the phi
+//   copies, and a goto unless succ is next.
+//
+// Global Variables: -
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+static void cg_goto(CGen_p c, int block, int succ, int next, char* ind)
+{
+   cg_copies(c, block, succ, ind);
+   if(succ != next)
+   {
+      fprintf(c->out, "%sgoto b%d;\n", ind, succ);
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: cg_labels()
+//
+//   Mark the blocks that are targets of a goto (in the same way as
+//   cg_instr() emits them).
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static void cg_labels(CGen_p c)
+{
+   IRFun_p   fun = c->fun;
+   IRBlock_p blk;
+   int       b, next;
+
+   for(b=0; b<fun->block_ctr; b++)
+   {
+      c->label[b] = false;
+   }
+   for(b=0; b<fun->layout_ctr; b++)
+   {
+      blk  = &fun->blocks[fun->layout[b]];
+      next = b+1 < fun->layout_ctr? fun->layout[b+1] : -1;
+      if(blk->succ_ctr == 2)
+      {
+         c->label[blk->succ[blk->succ[0] == next? 1 : 0]] = true;
+      }
+      if(blk->succ_ctr && blk->succ[blk->succ_ctr-1] != next)
+      {
+         c->label[blk->succ[blk->succ_ctr-1]] = true;
+      }
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: cg_instr()
+//
+//   Print the instruction v at the end of block. next is the block
+//   placed behind it.
+//
+// Global Variables: cg_rel, cg_rel_neg
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+static void cg_instr(CGen_p c, int block, int v, int next)
+{
+   IRFun_p   fun   = c->fun;
+   IRInstr_p instr = &fun->instrs[v];
+   IRBlock_p blk   = &fun->blocks[block];
+   char      *name = NULL;
+   int       i, succ, fail;
+   long      k;
+
+   switch(instr->op)
+   {
+   case IR_PARAM:
+   case IR_PHI:
+         return;
+   case IR_JMP:
+         cg_goto(c, block, blk->succ[0], next, "   ");
+         return;
+   case IR_BR:
+         succ = blk->succ[0];
+         fail = blk->succ[1];
+         fputs("   if(", c->out);
+         cg_value(c, instr->args[0]);
+         fprintf(c->out, " %s ", succ == next? cg_rel_neg[instr->k] :
+                 cg_rel[instr->k]);
+         cg_value(c, instr->args[1]);
+         fputs(")\n   {\n", c->out);
+         if(succ == next)
+         {
+            succ = blk->succ[1];
+            fail = blk->succ[0];
+         }
+         cg_goto(c, block, succ, -1, "      ");
+         fputs("   }\n", c->out);
+         cg_goto(c, block, fail, next, "   ");
+         return;
+   default:
+         break;
+   }
+   if(instr->type != T_NoType && !cg_is_var(c, v) && !IRHasEffect(fun, v))
+   {
+      return;
+   }
+
+   fputs("   ", c->out);
+   if(cg_is_var(c, v))
+   {
+      fprintf(c->out, "v%d = ", v);
+   }
+   switch(instr->op)
+   {
+   case IR_ADD:
+         name = "nano_add";
+         break;
+   case IR_SUB:
+         name = "nano_sub";
+         break;
+   case IR_MUL:
+         name = "nano_mul";
+         break;
+   case IR_DIV:
+         /* Constant divisors need no checks (except 0 and -1) */
+         k = fun->instrs[instr->args[1]].k;
+         if(fun->instrs[instr->args[1]].op == IR_CONST && k != 0 && k != -1)
+         {
+            cg_value(c, instr->args[0]);
+            fputs(" / ", c->out);
+            cg_value(c, instr->args[1]);
+            fputs(";\n", c->out);
+            return;
+         }
+         name = "nano_div";
+         break;
+   case IR_NEG:
+         name = "nano_neg";
+         break;
+   case IR_SCMP:
+         name = "nano_strcmp";
+         break;
+   case IR_CALL:
+         fprintf(c->out, "f_");
+         name = c->st->symbols[instr->k].symbol;
+         break;
+   case IR_PRINT:
+         name = fun->instrs[instr->args[0]].type == T_String?
+            "nano_print_str" : "nano_print_int";
+         break;
+   case IR_GETG:
+         fprintf(c->out, "g_%s;\n", c->st->symbols[instr->k].symbol);
+         return;
+   case IR_SETG:
+         fprintf(c->out, "g_%s = ", c->st->symbols[instr->k].symbol);
+         cg_value(c, instr->args[0]);
+         fputs(";\n", c->out);
+         return;
+   case IR_RET:
+         fputs("return ", c->out);
+         cg_value(c, instr->args[0]);
+         fputs(";\n", c->out);
+         return;
+   default:
+         assert(false && "Unexpected IR instruction in cg_instr()");
+         return;
+   }
+   fprintf(c->out, "%s(", name);
+   for(i=0; i<instr->argc; i++)
+   {
+      if(i)
+      {
+         fputs(", ", c->out);
+      }
+      cg_value(c, instr->args[i]);
+   }
+   fputs(");\n", c->out);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: cg_header()
+//
+//   Print the head of the C function for fun (without ";" or body).
+//   Parameters are named after their values.
+//
+// Global Variables: -
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+static void cg_header(CGen_p c, IRFun_p fun)
+{
+   int i;
+
+   fprintf(c->out, "static %s f_%s(", cg_ctype(fun->type), fun->name);
+   for(i=0; i<fun->arity; i++)
+   {
+      fprintf(c->out, "%s%s v%d", i? ", " : "",
+              cg_ctype(fun->instrs[fun->params[i]].type), fun->params[i]);
+   }
+   fputs(fun->arity? ")" : "void)", c->out);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: cg_fundef()
+//
+//   Print the definition of fun: the variables for its values, then
+//   the blocks in layout order, labeled where they are jumped to.
+//
+// Global Variables: -
+//
+// Side Effects    : Output, memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void cg_fundef(CGen_p c, IRFun_p fun)
+{
+   IRBlock_p blk;
+   int       b, i, v;
+
+   IRRequire(fun, IR_DEFUSE);
+   c->fun   = fun;
+   c->label = IRAlloc((fun->block_ctr+1)*sizeof(bool));
+   cg_labels(c);
+
+   fputs("\n", c->out);
+   cg_header(c, fun);
+   fputs("\n{\n", c->out);
+   for(b=0; b<fun->layout_ctr; b++)
+   {
+      blk = &fun->blocks[fun->layout[b]];
+      for(i=0; i<blk->code_ctr; i++)
+      {
+         v = blk->code[i];
+         if(cg_is_var(c, v) && fun->instrs[v].op != IR_PARAM)
+         {
+            fprintf(c->out, "   %s v%d;\n", cg_ctype(fun->instrs[v].type), v);
+         }
+      }
+   }
+   for(b=0; b<fun->layout_ctr; b++)
+   {
+      blk = &fun->blocks[fun->layout[b]];
+      if(c->label[fun->layout[b]])
+      {
+         fprintf(c->out, "b%d: ;\n", fun->layout[b]);
+      }
+      for(i=0; i<blk->code_ctr; i++)
+      {
+         cg_instr(c, fun->layout[b], blk->code[i],
+                  b+1 < fun->layout_ctr? fun->layout[b+1] : -1);
+      }
+   }
+   fputs("}\n", c->out);
+   free(c->label);
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                         Exported Functions                          */
+/*---------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------
+//
+// Function: CGenProgram()
+//
+//   Print the IR of a program as a C translation unit. Its main()
+//   passes the command line arguments to the String parameters of
+//   the nanoLang main() (missing ones are empty) and returns the
+//   result of main() as exit status. Output is line buffered if
+//   line_buffered is set or stdout is a terminal.
+//
+// Global Variables: cg_runtime
+//
+// Side Effects    : Output, memory operations
+//
+/----------------------------------------------------------------------*/
+
+void CGenProgram(FILE* out, IRProg_p ir, bool line_buffered)
+{
+   SymbolTable_p st = ir->st;
+   IRFun_p       main_fun;
+   CGenCell      c;
+   long          i;
+
+   assert(ir->main_fun >= 0);
+
+   c.out      = out;
+   c.st       = st;
+   c.lits     = NULL;
+   c.lit_ctr  = 0;
+   c.lit_size = 0;
+
+   fprintf(out, "/* Generated by nanoLangCompiler --emit-c */\n\n"
+           "#define NANO_OUT_SIZE   %d\n#define NANO_OUT_DIRECT %d\n"
+           "#define NANO_INT_CHARS  %d\n\n", NANO_OUT_SIZE,
+           NANO_OUT_DIRECT, NANO_INT_CHARS);
+   for(i=0; cg_runtime[i]; i++)
+   {
+      fprintf(out, "%s\n", cg_runtime[i]);
+   }
+
+   /* String literals, global variables, then all prototypes (for
+      mutual recursion) */
+   cg_literals(&c, ir);
+   fputs("\n", out);
+   for(i=0; i<st->symbol_ctr; i++)
+   {
+      if(!ir->funs[i])
+      {
+         fprintf(out, "static %s g_%s;\n", cg_ctype(st->symbols[i].type),
+                 st->symbols[i].symbol);
+      }
+   }
+   fputs("\n", out);
+   for(i=0; i<st->symbol_ctr; i++)
+   {
+      if(ir->funs[i])
+      {
+         cg_header(&c, ir->funs[i]);
+         fputs(";\n", out);
+      }
+   }
+   for(i=0; i<st->symbol_ctr; i++)
+   {
+      if(ir->funs[i])
+      {
+         cg_fundef(&c, ir->funs[i]);
+      }
+   }
+
+   main_fun = ir->funs[ir->main_fun];
+   fprintf(out, "\nint main(int argc, char* argv[])\n{\n"
+           "   long res;\n\n"
+           "   nano_out_line = %s;\n"
+           "   res = (long)f_main(", line_buffered? "1" : "isatty(STDOUT_FILENO)");
+   for(i=0; i<main_fun->arity; i++)
+   {
+      if(main_fun->instrs[main_fun->params[i]].type == T_String)
+      {
+         fprintf(out, "%sargc > %ld? nano_str_arg(argv[%ld]) : 0",
+                 i? ", " : "", i+1, i+1);
+      }
+      else
+      {
+         fprintf(out, "%s0", i? ", " : "");
+      }
+   }
+   fputs(");\n   nano_flush();\n   return (int)res;\n}\n", out);
+   free(c.lits);
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                        End of File                                  */
+/*---------------------------------------------------------------------*/
@@ -0,0 +1,59 @@
+/*-----------------------------------------------------------------------
+
+File  : cgen.h
+
+Authors: Konstantin Kläger, Isabel Staaden, Carolin Rösch
+
+Contents
+
+  Ahead-of-time translation of nanoLang programs (in SSA form, see
+  ir.h) into one C translation unit: one C function per fundef, long for Integer,
+  const char* for String, a small runtime with the semantics of
+  nanort.h, and a C main() that calls the nanoLang main() with the
+  command line arguments.
+
+  This code is released under the GNU General Public Licence.
+
+Changes
+
+<1> Sun Oct 18 07:10:26 CEST 2026
+    New
+
+-----------------------------------------------------------------------*/
+
+#ifndef CGEN
+
+#define CGEN
+
+#include "ir.h"
+
+
+/*---------------------------------------------------------------------*/
+/*                    Data type declarations                           */
+/*---------------------------------------------------------------------*/
+
+/* State of the code generator */
+typedef struct cgen
+{
+   FILE          *out;
+   SymbolTable_p st;
+   IRFun_p       fun;     /* Current function */
+   bool          *label;  /* Per block: needs a label */
+   NanoStr       *lits;   /* String literals, sN is lits[N] */
+   long          lit_ctr;
+   long          lit_size;
+}CGenCell, *CGen_p;
+
+
+/*---------------------------------------------------------------------*/
+/*                Exported Functions and Variables                     */
+/*---------------------------------------------------------------------*/
+
+void CGenProgram(FILE* out, IRProg_p ir, bool line_buffered);
+
+
+#endif
+
+/*---------------------------------------------------------------------*/
+/*                        End of File                                  */
+/*---------------------------------------------------------------------*/
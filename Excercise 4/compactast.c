@@ -0,0 +1,432 @@
+/*-----------------------------------------------------------------------
+
+File  : compactast.c
+
+Authors: Konstantin Kläger, Isabel Staaden, Carolin Rösch
+
+Contents
+
+  Construction and traversal of compact (index based) ASTs.
+
+  This code is released under the GNU General Public Licence.
+
+Changes
+
+<1> Sun Oct 18 01:02:33 CEST 2026
+    New
+
+-----------------------------------------------------------------------*/
+
+#include "compactast.h"
+
+
+
+/*---------------------------------------------------------------------*/
+/*                        Global Variables                             */
+/*---------------------------------------------------------------------*/
+
+/* Bytes per node in the per-node arrays */
+#define CAST_NODE_BYTES (sizeof(uint8_t)+2*sizeof(uint32_t)+         \
+                         2*sizeof(int32_t)+sizeof(char*)+sizeof(long)+ \
+                         sizeof(TypeIndex))
+
+
+/*---------------------------------------------------------------------*/
+/*                      Forward Declarations                           */
+/*---------------------------------------------------------------------*/
+
+
+/*---------------------------------------------------------------------*/
+/*                         Internal Functions                          */
+/*---------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------
+//
+// Function: xrealloc()
+//
+//   realloc() that exits on failure.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void* xrealloc(void* ptr, size_t size)
+{
+   void* res = realloc(ptr, size);
+
+   if(!res)
+   {
+      fprintf(stderr, "Out of memory in compact AST!\n");
+      exit(EXIT_FAILURE);
+   }
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: cast_grow_nodes()
+//
+//   Make room for at least one more node.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void cast_grow_nodes(CompactAST_p cast)
+{
+   uint32_t size = cast->node_size? 2*cast->node_size : 1024;
+
+   cast->type        = xrealloc(cast->type, size*sizeof(uint8_t));
+   cast->child_start = xrealloc(cast->child_start, size*sizeof(uint32_t));
+   cast->child_no    = xrealloc(cast->child_no, size*sizeof(uint32_t));
+   cast->line        = xrealloc(cast->line, size*sizeof(int32_t));
+   cast->column      = xrealloc(cast->column, size*sizeof(int32_t));
+   cast->litval      = xrealloc(cast->litval, size*sizeof(char*));
+   cast->intval      = xrealloc(cast->intval, size*sizeof(long));
+   cast->result_type = xrealloc(cast->result_type, size*sizeof(TypeIndex));
+   cast->node_size   = size;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: cast_reserve_children()
+//
+//   Make room for at least n more entries in the children array.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void cast_reserve_children(CompactAST_p cast, uint32_t n)
+{
+   uint32_t size = cast->child_size? cast->child_size : 1024;
+
+   while(size - cast->child_ctr < n)
+   {
+      size *= 2;
+   }
+   if(size != cast->child_size)
+   {
+      cast->children   = xrealloc(cast->children, size*sizeof(CNode));
+      cast->child_size = size;
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: is_list_type()
+//
+//   Return true if nodes of this type are built by a left-recursive
+//   list rule of the grammar.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static bool is_list_type(ASTNodeType type)
+{
+   switch(type)
+   {
+   case prog:
+   case vardefs:
+   case stmts:
+   case idlist:
+   case paramlist:
+   case arglist:
+         return true;
+   default:
+         return false;
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: compact_list()
+//
+//   Convert a chain of list nodes (of the type of ast) into a single
+//   n-ary node. Works iteratively, so long lists do not cost stack.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static CNode compact_list(CompactAST_p cast, AST_p ast)
+{
+   ASTNodeType type = ast->type;
+   AST_p       *elems = NULL, cur;
+   CNode       *kids, res;
+   long        size = 0, ctr = 0, i, n = 0;
+
+   for(cur = ast; cur && cur->type == type; cur = cur->child[0])
+   {
+      if(ctr == size)
+      {
+         size  = size? 2*size : 16;
+         elems = xrealloc(elems, size*sizeof(AST_p));
+      }
+      elems[ctr++] = cur->child[1];
+   }
+   kids = xrealloc(NULL, (ctr+1)*sizeof(CNode));
+   if(cur && cur->type != nil)
+   {
+      kids[n++] = ASTCompact(cast, cur);
+   }
+   for(i = ctr-1; i >= 0; i--)
+   {
+      if(elems[i])
+      {
+         kids[n++] = ASTCompact(cast, elems[i]);
+      }
+   }
+   res = CompactASTAddNode(cast, ast, n, kids);
+   free(kids);
+   free(elems);
+
+   return res;
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                         Exported Functions                          */
+/*---------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------
+//
+// Function: CompactASTAlloc()
+//
+//   Return an empty compact AST (only the reserved node 0).
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+CompactAST_p CompactASTAlloc(void)
+{
+   CompactAST_p handle = CompactASTCellAlloc();
+
+   memset(handle, 0, sizeof(CompactASTCell));
+   CompactASTAddNode(handle, NULL, 0, NULL);
+
+   return handle;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: CompactASTFree()
+//
+//   Free a compact AST.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+void CompactASTFree(CompactAST_p junk)
+{
+   free(junk->type);
+   free(junk->child_start);
+   free(junk->child_no);
+   free(junk->children);
+   free(junk->line);
+   free(junk->column);
+   free(junk->litval);
+   free(junk->intval);
+   free(junk->result_type);
+   CompactASTCellFree(junk);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: CompactASTBytes()
+//
+//   Return the number of bytes allocated for the compact AST.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+size_t CompactASTBytes(CompactAST_p cast)
+{
+   return sizeof(CompactASTCell) +
+      (size_t)cast->node_size*CAST_NODE_BYTES +
+      (size_t)cast->child_size*sizeof(CNode);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: CompactASTAddNode()
+//
+//   Append a new node with the given children. Type, position and
+//   literal values are taken from proto (if any). Return the new
+//   node.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+CNode CompactASTAddNode(CompactAST_p cast, AST_p proto,
+                        int child_no, CNode* children)
+{
+   CNode res = cast->node_ctr;
+
+   if(cast->node_ctr == cast->node_size)
+   {
+      cast_grow_nodes(cast);
+   }
+   cast_reserve_children(cast, child_no);
+
+   cast->type[res]        = proto? proto->type : nil;
+   cast->child_start[res] = cast->child_ctr;
+   cast->child_no[res]    = child_no;
+   cast->line[res]        = proto? proto->line : 0;
+   cast->column[res]      = proto? proto->column : 0;
+   cast->litval[res]      = proto? proto->litval : NULL;
+   cast->intval[res]      = proto? proto->intval : 0;
+   cast->result_type[res] = proto? proto->result_type : T_NoType;
+
+   if(child_no)
+   {
+      memcpy(cast->children+cast->child_ctr, children, child_no*sizeof(CNode));
+   }
+   cast->child_ctr += child_no;
+   cast->node_ctr++;
+   cast->root = res;
+
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ASTCompact()
+//
+//   Append the compact version of ast to cast and return its
+//   root. NULL children become CNODE_NONE, trailing NULL children are
+//   dropped.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+CNode ASTCompact(CompactAST_p cast, AST_p ast)
+{
+   CNode kids[MAXCHILD];
+   int   i, n = 0;
+
+   if(!ast)
+   {
+      return CNODE_NONE;
+   }
+   if(is_list_type(ast->type))
+   {
+      return compact_list(cast, ast);
+   }
+   for(i=0; i<MAXCHILD; i++)
+   {
+      kids[i] = ASTCompact(cast, ast->child[i]);
+      if(kids[i] != CNODE_NONE)
+      {
+         n = i+1;
+      }
+   }
+   return CompactASTAddNode(cast, ast, n, kids);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: CompactASTSExprPrint()
+//
+//   Print the tree rooted at node as an S-expression, in the same
+//   format as SExprASTPrint() (but with flattened lists).
+//
+// Global Variables: ast_name[]
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+void CompactASTSExprPrint(FILE* out, CompactAST_p cast, CNode node)
+{
+   uint32_t i;
+
+   if(node != CNODE_NONE)
+   {
+      switch(CASTType(cast, node))
+      {
+      case t_STRINGLIT:
+      case t_IDENT:
+      case t_INTLIT:
+            fprintf(out, "%s<%s> ",
+                    ast_name[CASTType(cast, node)], cast->litval[node]);
+            break;
+      default:
+            fprintf(out, "(");
+            fprintf(out, "%s ", ast_name[CASTType(cast, node)]);
+            for(i=0; i<CASTArity(cast, node); i++)
+            {
+               CompactASTSExprPrint(out, cast, CASTChild(cast, node, i));
+            }
+            fprintf(out, ") ");
+            break;
+      }
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: CompactASTCountNodes()
+//
+//   Return the number of nodes of the given type. Since nodes are
+//   stored in a flat array, this is a linear scan of the type array
+//   only, no tree walk is necessary.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+long CompactASTCountNodes(CompactAST_p cast, ASTNodeType type)
+{
+   long     res = 0;
+   uint32_t i;
+
+   for(i=1; i<cast->node_ctr; i++)
+   {
+      res += (cast->type[i] == type);
+   }
+   return res;
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                        End of File                                  */
+/*---------------------------------------------------------------------*/
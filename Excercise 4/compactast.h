@@ -0,0 +1,102 @@
+/*-----------------------------------------------------------------------
+
+File  : compactast.h
+
+Authors: Konstantin Kläger, Isabel Staaden, Carolin Rösch
+
+Contents
+
+  Compact, index based representation of nanoLang ASTs. Nodes are
+  32 bit indices into parallel arrays (struct of arrays). The fields
+  every traversal needs (node type and children) are kept apart from
+  the ones only some passes look at (positions, literal values,
+  annotations). Children are stored in a shared side array, so nodes
+  have exactly as many child slots as they need. The left-recursive
+  list constructs of the grammar (prog, vardefs, stmts, idlist,
+  paramlist, arglist) are flattened into a single n-ary node.
+
+  Nodes are stored in post-order: children always have smaller
+  indices than their parent, and the root is the last node.
+
+  The semantic checks, the optimizer and the back ends all work on
+  the pointer AST. The compact form is built from it for --csexpr,
+  --stats and nanobench.
+
+  This code is released under the GNU General Public Licence.
+
+Changes
+
+<1> Sun Oct 18 01:02:33 CEST 2026
+    New
+
+-----------------------------------------------------------------------*/
+
+#ifndef COMPACTAST
+
+#define COMPACTAST
+
+#include <stdint.h>
+#include "ast.h"
+
+
+/*---------------------------------------------------------------------*/
+/*                    Data type declarations                           */
+/*---------------------------------------------------------------------*/
+
+/* Node handle. 0 is reserved for "no node" (NULL in the pointer
+ * representation). */
+typedef uint32_t CNode;
+
+#define CNODE_NONE 0
+
+typedef struct compactast
+{
+   /* Hot - one entry per node */
+   uint8_t       *type;        /* ASTNodeType */
+   uint32_t      *child_start; /* First child in children[] */
+   uint32_t      *child_no;    /* Number of child slots */
+   /* Side array of children */
+   CNode         *children;
+   /* Cold - one entry per node */
+   int32_t       *line;
+   int32_t       *column;
+   char*         *litval;      /* Interned */
+   long          *intval;
+   TypeIndex     *result_type;
+
+   uint32_t      node_ctr;
+   uint32_t      node_size;
+   uint32_t      child_ctr;
+   uint32_t      child_size;
+   CNode         root;
+}CompactASTCell, *CompactAST_p;
+
+
+/*---------------------------------------------------------------------*/
+/*                Exported Functions and Variables                     */
+/*---------------------------------------------------------------------*/
+
+#define CompactASTCellAlloc()    (CompactASTCell*)malloc(sizeof(CompactASTCell))
+#define CompactASTCellFree(junk) free(junk)
+
+#define CASTType(cast, n)      ((ASTNodeType)(cast)->type[n])
+#define CASTArity(cast, n)     ((cast)->child_no[n])
+#define CASTChild(cast, n, i)  ((cast)->children[(cast)->child_start[n]+(i)])
+
+CompactAST_p CompactASTAlloc(void);
+void         CompactASTFree(CompactAST_p junk);
+size_t       CompactASTBytes(CompactAST_p cast);
+
+CNode        CompactASTAddNode(CompactAST_p cast, AST_p proto,
+                               int child_no, CNode* children);
+CNode        ASTCompact(CompactAST_p cast, AST_p ast);
+
+void         CompactASTSExprPrint(FILE* out, CompactAST_p cast, CNode node);
+long         CompactASTCountNodes(CompactAST_p cast, ASTNodeType type);
+
+
+#endif
+
+/*---------------------------------------------------------------------*/
+/*                        End of File                                  */
+/*---------------------------------------------------------------------*/
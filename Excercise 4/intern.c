@@ -0,0 +1,188 @@
+/*-----------------------------------------------------------------------
+
+File  : intern.c
+
+Authors: Konstantin Kläger, Isabel Staaden, Carolin Rösch
+
+Contents
+
+  Implementation of the string intern pool (open addressing with
+  linear probing, strings live in an arena).
+
+  This code is released under the GNU General Public Licence.
+
+Changes
+
+<1> Sun Oct 18 00:12:40 CEST 2026
+    New
+
+-----------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include "intern.h"
+
+
+
+/*---------------------------------------------------------------------*/
+/*                        Global Variables                             */
+/*---------------------------------------------------------------------*/
+
+InternPoolCell intern_pool = {NULL, NULL, 0, 0};
+
+
+/*---------------------------------------------------------------------*/
+/*                      Forward Declarations                           */
+/*---------------------------------------------------------------------*/
+
+
+/*---------------------------------------------------------------------*/
+/*                         Internal Functions                          */
+/*---------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------
+//
+// Function: str_hash()
+//
+//   Return the FNV-1a hash of the first len bytes of str.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static unsigned int str_hash(const char* str, size_t len)
+{
+   unsigned int hash = 2166136261u;
+   size_t       i;
+
+   for(i=0; i<len; i++)
+   {
+      hash ^= (unsigned char)str[i];
+      hash *= 16777619u;
+   }
+   return hash;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: intern_grow()
+//
+//   Double the size of the hash table (or create it) and rehash all
+//   entries.
+//
+// Global Variables: intern_pool
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void intern_grow(void)
+{
+   InternEntry_p old  = intern_pool.table;
+   size_t        size = intern_pool.size, i, j, mask;
+
+   intern_pool.size  = size? 2*size : INTERN_INIT_SIZE;
+   intern_pool.table = calloc(intern_pool.size, sizeof(InternEntryCell));
+   if(!intern_pool.table)
+   {
+      fprintf(stderr, "Out of memory in string pool!\n");
+      exit(EXIT_FAILURE);
+   }
+   mask = intern_pool.size-1;
+   for(i=0; i<size; i++)
+   {
+      if(old[i].str)
+      {
+         for(j = old[i].hash & mask; intern_pool.table[j].str; j = (j+1) & mask)
+         {
+            /* Find free slot */
+         }
+         intern_pool.table[j] = old[i];
+      }
+   }
+   free(old);
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                         Exported Functions                          */
+/*---------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------
+//
+// Function: StrInternN()
+//
+//   Return the canonical copy of the len bytes starting at str
+//   (which need not be 0-terminated). The copy is 0-terminated and
+//   valid until StrInternFree().
+//
+// Global Variables: intern_pool
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+char* StrInternN(const char* str, size_t len)
+{
+   unsigned int  hash = str_hash(str, len);
+   size_t        i, mask;
+   InternEntry_p entry;
+
+   if(2*(intern_pool.count+1) > intern_pool.size)
+   {
+      intern_grow();
+   }
+   if(!intern_pool.strings)
+   {
+      intern_pool.strings = ArenaAlloc(0);
+   }
+   mask = intern_pool.size-1;
+   for(i = hash & mask; intern_pool.table[i].str; i = (i+1) & mask)
+   {
+      entry = &(intern_pool.table[i]);
+      if(entry->hash == hash && entry->len == len &&
+         memcmp(entry->str, str, len)==0)
+      {
+         return entry->str;
+      }
+   }
+   entry = &(intern_pool.table[i]);
+   entry->str  = ArenaMalloc(intern_pool.strings, len+1);
+   memcpy(entry->str, str, len);
+   entry->str[len] = '\0';
+   entry->hash = hash;
+   entry->len  = len;
+   intern_pool.count++;
+
+   return entry->str;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: StrInternFree()
+//
+//   Release all interned strings.
+//
+// Global Variables: intern_pool
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+void StrInternFree(void)
+{
+   ArenaFree(intern_pool.strings);
+   free(intern_pool.table);
+   intern_pool.strings = NULL;
+   intern_pool.table   = NULL;
+   intern_pool.size    = 0;
+   intern_pool.count   = 0;
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                        End of File                                  */
+/*---------------------------------------------------------------------*/
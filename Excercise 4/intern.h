@@ -0,0 +1,71 @@
+/*-----------------------------------------------------------------------
+
+File  : intern.h
+
+Authors: Konstantin Kläger, Isabel Staaden, Carolin Rösch
+
+Contents
+
+  Global string intern pool. Every distinct string (identifiers,
+  literals, keywords) is stored exactly once. Interned strings can
+  be compared by pointer, and are never freed individually - the
+  whole pool is released at the end of the compilation.
+
+  This code is released under the GNU General Public Licence.
+
+Changes
+
+<1> Sun Oct 18 00:12:40 CEST 2026
+    New
+
+-----------------------------------------------------------------------*/
+
+#ifndef INTERN
+
+#define INTERN
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "arena.h"
+
+
+/*---------------------------------------------------------------------*/
+/*                    Data type declarations                           */
+/*---------------------------------------------------------------------*/
+
+/* Initial number of slots in the hash table (power of 2) */
+#define INTERN_INIT_SIZE 1024
+
+typedef struct internentry
+{
+   char         *str;   /* NULL for empty slots */
+   unsigned int hash;
+   unsigned int len;
+}InternEntryCell, *InternEntry_p;
+
+typedef struct internpool
+{
+   Arena_p       strings;
+   InternEntry_p table;
+   size_t        size;   /* Number of slots */
+   size_t        count;  /* Number of strings */
+}InternPoolCell, *InternPool_p;
+
+
+/*---------------------------------------------------------------------*/
+/*                Exported Functions and Variables                     */
+/*---------------------------------------------------------------------*/
+
+extern InternPoolCell intern_pool;
+
+char*  StrInternN(const char* str, size_t len);
+#define StrIntern(str) StrInternN((str), strlen(str))
+void   StrInternFree(void);
+
+
+#endif
+
+/*---------------------------------------------------------------------*/
+/*                        End of File                                  */
+/*---------------------------------------------------------------------*/
@@ -0,0 +1,668 @@
+/*-----------------------------------------------------------------------
+
+File  : interp.c
+
+Authors: Konstantin Kläger, Isabel Staaden, Carolin Rösch
+
+Contents
+
+  Tree-walking interpreter for nanoLang.
+
+  This code is released under the GNU General Public Licence.
+
+Changes
+
+<1> Sun Oct 18 03:05:47 CEST 2026
+    New
+
+-----------------------------------------------------------------------*/
+
+#include <ucontext.h>
+#include <sys/mman.h>
+#include "interp.h"
+
+
+
+/*---------------------------------------------------------------------*/
+/*                        Global Variables                             */
+/*---------------------------------------------------------------------*/
+
+/* Values of the global variables, indexed by symbol position */
+static NanoValue *globals   = NULL;
+
+/* Definitions of the global functions, indexed by symbol position */
+static AST_p     *functions = NULL;
+
+/* Value stack holding all frames, and the first free slot */
+static NanoValue *stack     = NULL;
+static NanoValue *stack_top = NULL;
+
+/* Decoded string literals, hashed by the (interned) source text */
+typedef struct litcache
+{
+   char    *lit;  /* NULL = empty */
+   NanoStr str;
+}LitCacheCell, *LitCache_p;
+
+static LitCache_p lit_cache      = NULL;
+static long       lit_cache_size = 0;
+static long       lit_cache_ctr  = 0;
+
+/* Set by a tail call: the function that takes over the current
+ * frame, with the new arguments in it */
+static AST_p     interp_tail = NULL;
+
+/* Depth of nested calls, and the lowest address the native stack may
+ * grow to */
+static long      interp_depth = 0;
+static char      *native_limit = NULL;
+
+/* Contexts of InterpRun() and of the interpreter on its native
+ * stack, the function run there and its result */
+static ucontext_t run_ctx, interp_ctx;
+static AST_p      run_fun = NULL;
+static NanoValue  run_res;
+
+
+/*---------------------------------------------------------------------*/
+/*                      Forward Declarations                           */
+/*---------------------------------------------------------------------*/
+
+static NanoValue interp_call(NanoValue* frame, AST_p call);
+static int       interp_args(NanoValue* frame, NanoValue* callee, AST_p args);
+
+
+/*---------------------------------------------------------------------*/
+/*                         Internal Functions                          */
+/*---------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------
+//
+// Function: lit_hash()
+//
+//   Hash of an interned literal (i.e. of its address).
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static unsigned long lit_hash(char* lit)
+{
+   return ((unsigned long)lit * 0x9E3779B97F4A7C15ul) >> 32;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: lit_cache_grow()
+//
+//   Double the size of the literal cache (or create it).
+//
+// Global Variables: lit_cache, lit_cache_size
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void lit_cache_grow(void)
+{
+   LitCache_p old  = lit_cache;
+   long       size = lit_cache_size, i, j, mask;
+
+   lit_cache_size = size? 2*size : 64;
+   lit_cache      = calloc(lit_cache_size, sizeof(LitCacheCell));
+   if(!lit_cache)
+   {
+      NanoRuntimeError("out of memory");
+   }
+   mask = lit_cache_size-1;
+   for(i=0; i<size; i++)
+   {
+      if(old[i].lit)
+      {
+         for(j = lit_hash(old[i].lit) & mask; lit_cache[j].lit; j = (j+1) & mask)
+         {
+            /* Find free slot */
+         }
+         lit_cache[j] = old[i];
+      }
+   }
+   free(old);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: interp_var()
+//
+//   Return the storage of the variable ident is bound to.
+//
+// Global Variables: globals
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static inline NanoValue* interp_var(NanoValue* frame, AST_p ident)
+{
+   assert(ident->sym_table);
+
+   if(ident->sym_table->depth == 0)
+   {
+      return &globals[ident->sym_slot];
+   }
+   return &frame[STFrameSlot(ident->sym_table, ident->sym_slot)];
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: interp_expr()
+//
+//   Evaluate an expression.
+//
+// Global Variables: -
+//
+// Side Effects    : By calls
+//
+/----------------------------------------------------------------------*/
+
+static NanoValue interp_expr(NanoValue* frame, AST_p ast)
+{
+   NanoValue res, a, b;
+
+   switch(ast->type)
+   {
+   case t_INTLIT:
+         res.i = ast->intval;
+         break;
+   case t_STRINGLIT:
+         res.s = InterpStrLiteral(ast->litval);
+         break;
+   case t_IDENT:
+         res = *interp_var(frame, ast);
+         break;
+   case funcall:
+         res = interp_call(frame, ast);
+         break;
+   case t_PLUS:
+         a = interp_expr(frame, ast->child[0]);
+         b = interp_expr(frame, ast->child[1]);
+         res.i = NanoAdd(a.i, b.i);
+         break;
+   case t_MINUS:
+         a = interp_expr(frame, ast->child[0]);
+         if(!ast->child[1])
+         {
+            res.i = NanoNeg(a.i);
+            break;
+         }
+         b = interp_expr(frame, ast->child[1]);
+         res.i = NanoSub(a.i, b.i);
+         break;
+   case t_MULT:
+         a = interp_expr(frame, ast->child[0]);
+         b = interp_expr(frame, ast->child[1]);
+         res.i = NanoMul(a.i, b.i);
+         break;
+   case t_DIV:
+         a = interp_expr(frame, ast->child[0]);
+         b = interp_expr(frame, ast->child[1]);
+         res.i = NanoDiv(a.i, b.i);
+         break;
+   default:
+         assert(false && "Unexpected AST type in interp_expr()");
+         res.i = 0;
+         break;
+   }
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: interp_cond()
+//
+//   Evaluate a comparison. Strings are compared by content.
+//
+// Global Variables: -
+//
+// Side Effects    : By calls
+//
+/----------------------------------------------------------------------*/
+
+static bool interp_cond(NanoValue* frame, AST_p ast)
+{
+   NanoValue a, b;
+   int       cmp;
+
+   a = interp_expr(frame, ast->child[0]);
+   b = interp_expr(frame, ast->child[1]);
+   if(ast->child[0]->result_type == T_String)
+   {
+      cmp = NanoStrCmp(a.s, b.s);
+   }
+   else
+   {
+      cmp = (a.i > b.i) - (a.i < b.i);
+   }
+   switch(ast->type)
+   {
+   case t_EQ:
+         return cmp == 0;
+   case t_NEQ:
+         return cmp != 0;
+   case t_LT:
+         return cmp < 0;
+   case t_GT:
+         return cmp > 0;
+   case t_LEQ:
+         return cmp <= 0;
+   case t_GEQ:
+         return cmp >= 0;
+   default:
+         assert(false && "Unexpected AST type in interp_cond()");
+         return false;
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: interp_stmt()
+//
+//   Execute a statement (list). Return true if a return statement
+//   was executed, its value is then stored in *retval.
+//
+// Global Variables: -
+//
+// Side Effects    : By the program
+//
+/----------------------------------------------------------------------*/
+
+static bool interp_stmt(NanoValue* frame, AST_p ast, NanoValue* retval)
+{
+   SymbolTable_p scope;
+
+   switch(ast->type)
+   {
+   case nil:
+         return false;
+   case stmts:
+         return interp_stmt(frame, ast->child[0], retval) ||
+            interp_stmt(frame, ast->child[1], retval);
+   case body:
+         /* Locals start out as 0 or the empty string */
+         scope = ast->context;
+         memset(frame+scope->frame_base, 0, scope->symbol_ctr*sizeof(NanoValue));
+         return interp_stmt(frame, ast->child[1], retval);
+   case while_stmt:
+         while(interp_cond(frame, ast->child[1]))
+         {
+            if(interp_stmt(frame, ast->child[2], retval))
+            {
+               return true;
+            }
+         }
+         return false;
+   case if_stmt:
+         if(interp_cond(frame, ast->child[1]))
+         {
+            return interp_stmt(frame, ast->child[2], retval);
+         }
+         return ast->child[3] && interp_stmt(frame, ast->child[3], retval);
+   case ret_stmt:
+         if(ASTIsTailCall(ast))
+         {
+            /* The new arguments are evaluated above the frame and
+               replace it */
+            AST_p     callee = functions[ast->child[1]->sym_slot];
+            NanoValue *args  = stack_top;
+            int       argno;
+
+            scope = callee->child[2]->context;
+            if(stack_top+scope->frame_size > stack+INTERP_STACK_SIZE)
+            {
+               NanoRuntimeError("stack overflow");
+            }
+            stack_top += scope->frame_size;
+            argno = interp_args(frame, args, ast->child[1]->child[1]);
+            memmove(frame, args, argno*sizeof(NanoValue));
+            memset(frame+argno, 0,
+                   (scope->frame_size-argno)*sizeof(NanoValue));
+            stack_top = frame+scope->frame_size;
+            interp_tail = callee;
+            return true;
+         }
+         *retval = interp_expr(frame, ast->child[1]);
+         return true;
+   case print_stmt:
+         if(ast->child[1]->result_type == T_String)
+         {
+            NanoPrintStr(interp_expr(frame, ast->child[1]).s);
+         }
+         else
+         {
+            NanoPrintInt(interp_expr(frame, ast->child[1]).i);
+         }
+         return false;
+   case assign:
+         *interp_var(frame, ast->child[0]) = interp_expr(frame, ast->child[1]);
+         return false;
+   case funcall_stmt:
+         interp_call(frame, ast->child[0]);
+         return false;
+   default:
+         assert(false && "Unexpected AST type in interp_stmt()");
+         return false;
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: interp_args()
+//
+//   Evaluate the actual arguments args (in frame) into the first
+//   slots of the frame callee. Return the number of arguments.
+//
+// Global Variables: -
+//
+// Side Effects    : By calls
+//
+/----------------------------------------------------------------------*/
+
+static int interp_args(NanoValue* frame, NanoValue* callee, AST_p args)
+{
+   int pos;
+
+   switch(args->type)
+   {
+   case nil:
+         return 0;
+   case arglist:
+         pos = interp_args(frame, callee, args->child[0]);
+         if(args->child[1])
+         {
+            callee[pos++] = interp_expr(frame, args->child[1]);
+         }
+         return pos;
+   default:
+         callee[0] = interp_expr(frame, args);
+         return 1;
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: interp_function()
+//
+//   Run the function fun in a frame that already holds the
+//   arguments. Functions that end without return yield 0 (or the
+//   empty string). After a tail call, the body of the called
+//   function runs in the same frame.
+//
+// Global Variables: interp_tail
+//
+// Side Effects    : By the program
+//
+/----------------------------------------------------------------------*/
+
+static NanoValue interp_function(NanoValue* frame, AST_p fun)
+{
+   NanoValue res;
+
+   while(fun)
+   {
+      res.i = 0;
+      interp_tail = NULL;
+      interp_stmt(frame, fun->child[3], &res);
+      fun = interp_tail;
+   }
+
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: interp_call()
+//
+//   Execute a function call. The new frame is reserved before the
+//   arguments are evaluated, so that calls in the arguments get
+//   frames above it.
+//
+// Global Variables: functions, stack, stack_top, interp_depth,
+//                   native_limit
+//
+// Side Effects    : By the program
+//
+/----------------------------------------------------------------------*/
+
+static NanoValue interp_call(NanoValue* frame, AST_p call)
+{
+   AST_p         fun   = functions[call->sym_slot];
+   SymbolTable_p scope = fun->child[2]->context;
+   NanoValue     *callee = stack_top, res;
+   int           argno;
+
+   if(stack_top+scope->frame_size > stack+INTERP_STACK_SIZE ||
+      interp_depth == INTERP_CALL_DEPTH || (char*)&res < native_limit)
+   {
+      NanoRuntimeError("stack overflow");
+   }
+   stack_top += scope->frame_size;
+   argno = interp_args(frame, callee, call->child[1]);
+   memset(callee+argno, 0, (scope->frame_size-argno)*sizeof(NanoValue));
+
+   interp_depth++;
+   res = interp_function(callee, fun);
+   interp_depth--;
+   stack_top = callee;
+
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: interp_main()
+//
+//   Entry of the interpreter context: run run_fun in the first frame
+//   of the value stack. Returning resumes InterpRun().
+//
+// Global Variables: run_fun, run_res, stack
+//
+// Side Effects    : By the program
+//
+/----------------------------------------------------------------------*/
+
+static void interp_main(void)
+{
+   run_res = interp_function(stack, run_fun);
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                         Exported Functions                          */
+/*---------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------
+//
+// Function: InterpStrLiteral()
+//
+//   Return the value of the string literal with the (interned) source
+//   text litval. Every literal is decoded only once.
+//
+// Global Variables: lit_cache, lit_cache_size, lit_cache_ctr
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+NanoStr InterpStrLiteral(char* litval)
+{
+   long mask, i;
+
+   if(2*(lit_cache_ctr+1) > lit_cache_size)
+   {
+      lit_cache_grow();
+   }
+   mask = lit_cache_size-1;
+   for(i = lit_hash(litval) & mask; lit_cache[i].lit; i = (i+1) & mask)
+   {
+      if(lit_cache[i].lit == litval)
+      {
+         return lit_cache[i].str;
+      }
+   }
+   lit_cache[i].lit = litval;
+   lit_cache[i].str = NanoStrLiteral(litval);
+   lit_cache_ctr++;
+
+   return lit_cache[i].str;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: InterpDecodeLiterals()
+//
+//   Decode all string literals in ast (see InterpStrLiteral()), so
+//   that running the program adds none to the string pool.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+void InterpDecodeLiterals(AST_p ast)
+{
+   int i;
+
+   if(!ast)
+   {
+      return;
+   }
+   if(ast->type == t_STRINGLIT)
+   {
+      InterpStrLiteral(ast->litval);
+   }
+   for(i=0; i<MAXCHILD; i++)
+   {
+      InterpDecodeLiterals(ast->child[i]);
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: InterpFunctionTable()
+//
+//   Return a newly allocated array mapping the positions of global
+//   symbols in st to their function definitions in program (NULL for
+//   variables).
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+AST_p* InterpFunctionTable(SymbolTable_p st, AST_p program)
+{
+   AST_p *res = calloc(st->symbol_ctr+1, sizeof(AST_p));
+   AST_p def;
+
+   if(!res)
+   {
+      NanoRuntimeError("out of memory");
+   }
+   for(; program && program->type == prog; program = program->child[0])
+   {
+      def = program->child[1];
+      if(def && def->type == fundef && def->child[1]->sym_table == st)
+      {
+         res[def->child[1]->sym_slot] = def;
+      }
+   }
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: InterpRun()
+//
+//   Run main() of the checked program with global symbol table
+//   st. The String arguments of main() are taken from argv (missing
+//   ones are empty). Return the result of main().
+//
+// Global Variables: globals, functions, stack, stack_top,
+//                   interp_depth, native_limit, run_fun, run_res
+//
+// Side Effects    : By the program
+//
+/----------------------------------------------------------------------*/
+
+NanoInt InterpRun(SymbolTable_p st, AST_p program, int argc, char* argv[])
+{
+   Symbol_p      main_sym = STFindSymbolLocal(st, StrIntern("main"));
+   AST_p         fun;
+   SymbolTable_p scope;
+   char          *native;
+   int           i, argno;
+
+   assert(main_sym);
+
+   globals   = calloc(st->symbol_ctr+1, sizeof(NanoValue));
+   functions = InterpFunctionTable(st, program);
+   stack     = malloc(INTERP_STACK_SIZE*sizeof(NanoValue));
+   native    = mmap(NULL, INTERP_NATIVE_STACK, PROT_READ|PROT_WRITE,
+                    MAP_PRIVATE|MAP_ANONYMOUS|MAP_NORESERVE, -1, 0);
+   if(!globals || !stack || native == MAP_FAILED)
+   {
+      NanoRuntimeError("out of memory");
+   }
+
+   fun   = functions[main_sym - st->symbols];
+   scope = fun->child[2]->context;
+   memset(stack, 0, scope->frame_size*sizeof(NanoValue));
+   stack_top = stack+scope->frame_size;
+
+   /* Parameters are the first symbols of the function scope */
+   argno = scope->symbol_ctr;
+   for(i=0; i<argno && i<argc; i++)
+   {
+      stack[i].s = NanoStrFromC(argv[i]);
+   }
+   run_fun      = fun;
+   interp_depth = 0;
+   native_limit = native+INTERP_NATIVE_RESERVE;
+   getcontext(&interp_ctx);
+   interp_ctx.uc_stack.ss_sp   = native;
+   interp_ctx.uc_stack.ss_size = INTERP_NATIVE_STACK;
+   interp_ctx.uc_link          = &run_ctx;
+   makecontext(&interp_ctx, interp_main, 0);
+   swapcontext(&run_ctx, &interp_ctx);
+   NanoOutFlush();
+
+   munmap(native, INTERP_NATIVE_STACK);
+   free(stack);
+   free(functions);
+   free(globals);
+   stack = stack_top = NULL;
+   functions = NULL;
+   globals   = NULL;
+
+   return run_res.i;
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                        End of File                                  */
+/*---------------------------------------------------------------------*/
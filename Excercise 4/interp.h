@@ -0,0 +1,68 @@
+/*-----------------------------------------------------------------------
+
+File  : interp.h
+
+Authors: Konstantin Kläger, Isabel Staaden, Carolin Rösch
+
+Contents
+
+  Tree-walking interpreter for semantically checked nanoLang
+  programs. It works directly on the annotated AST: identifiers and
+  calls are bound to their symbols, every scope knows its position in
+  the frame of its function (see symbols.h), and result_type selects
+  the operation for print and comparisons. This is the reference
+  engine for all faster ones.
+
+  This code is released under the GNU General Public Licence.
+
+Changes
+
+<1> Sun Oct 18 03:05:47 CEST 2026
+    New
+
+-----------------------------------------------------------------------*/
+
+#ifndef INTERP
+
+#define INTERP
+
+#include "ast.h"
+#include "nanort.h"
+
+
+/*---------------------------------------------------------------------*/
+/*                    Data type declarations                           */
+/*---------------------------------------------------------------------*/
+
+/* Number of value slots for all frames together */
+#define INTERP_STACK_SIZE (4*1024*1024)
+
+/* Maximal depth of nested calls (as in the VM) */
+#define INTERP_CALL_DEPTH (1024*1024)
+
+/* The interpreter runs on its own native stack, so that deep
+   recursion does not depend on the stack limit of the process. A
+   call takes a few recursive C calls of the evaluator (calls in
+   deeply nested expressions more, so the native stack is checked,
+   too). INTERP_NATIVE_RESERVE bytes are kept free for the runtime. */
+#define INTERP_FRAME_BYTES    1024
+#define INTERP_NATIVE_RESERVE (256*1024)
+#define INTERP_NATIVE_STACK   (INTERP_CALL_DEPTH*INTERP_FRAME_BYTES+\
+                               INTERP_NATIVE_RESERVE)
+
+
+/*---------------------------------------------------------------------*/
+/*                Exported Functions and Variables                     */
+/*---------------------------------------------------------------------*/
+
+NanoStr InterpStrLiteral(char* litval);
+void    InterpDecodeLiterals(AST_p ast);
+AST_p*  InterpFunctionTable(SymbolTable_p st, AST_p program);
+NanoInt InterpRun(SymbolTable_p st, AST_p program, int argc, char* argv[]);
+
+
+#endif
+
+/*---------------------------------------------------------------------*/
+/*                        End of File                                  */
+/*---------------------------------------------------------------------*/
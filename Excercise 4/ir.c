@@ -0,0 +1,1387 @@
+/*-----------------------------------------------------------------------
+
+File  : ir.c
+
+Authors: Konstantin Kläger, Isabel Staaden, Carolin Rösch
+
+Contents
+
+  SSA intermediate representation of nanoLang: construction from
+  the checked AST, basic editing operations and printing (see ir.h).
+
+  This code is released under the GNU General Public Licence.
+
+Changes
+
+<1> Sun Oct 18 11:02:13 CEST 2026
+    New
+
+-----------------------------------------------------------------------*/
+
+#include "ir.h"
+#include "interp.h"
+
+
+
+/*---------------------------------------------------------------------*/
+/*                        Global Variables                             */
+/*---------------------------------------------------------------------*/
+
+char* ir_op_name[] =
+{
+   "nop", "const", "str", "param", "phi",
+   "add", "sub", "mul", "div", "neg", "scmp",
+   "getg", "setg", "call", "print", "jmp", "br", "ret"
+};
+
+static char* ir_rel_name[] = {"eq", "ne", "lt", "le", "gt", "ge"};
+
+
+/*---------------------------------------------------------------------*/
+/*                      Forward Declarations                           */
+/*---------------------------------------------------------------------*/
+
+static int ir_read(IRBuild_p b, int block, int var, TypeIndex type);
+
+
+/*---------------------------------------------------------------------*/
+/*                         Internal Functions                          */
+/*---------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_write()
+//
+//   Record val as the current value of the variable (frame slot) var
+//   in block.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static inline void ir_write(IRBuild_p b, int block, int var, int val)
+{
+   b->defs[block][var] = val;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_new_phi()
+//
+//   Create a phi without operands at the start of block.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static int ir_new_phi(IRFun_p fun, int block, TypeIndex type)
+{
+   int phi = IRNewInstr(fun, IR_PHI, type, 0);
+   IRBlock_p blk = &fun->blocks[block];
+   int i;
+
+   IRAppend(fun, block, phi);
+   for(i=blk->code_ctr-1; i>0 && fun->instrs[blk->code[i-1]].op != IR_PHI; i--)
+   {
+      blk->code[i] = blk->code[i-1];
+   }
+   blk->code[i] = phi;
+
+   return phi;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_add_phi_operands()
+//
+//   Give phi (for variable var in block) one operand per
+//   predecessor of block.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void ir_add_phi_operands(IRBuild_p b, int block, int var, int phi)
+{
+   IRFun_p fun = b->fun;
+   int     i;
+
+   for(i=0; i<fun->blocks[block].pred_ctr; i++)
+   {
+      IRAddArg(fun, phi, ir_read(b, fun->blocks[block].preds[i], var,
+                                 fun->instrs[phi].type));
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_read()
+//
+//   Return the current value of the variable (frame slot) var of
+//   type type at the end of block. Where it is not defined in block
+//   itself, it is looked up in the predecessors, and merged by a phi
+//   if there are several. Blocks that are not yet sealed get a phi
+//   whose operands are added by ir_seal().
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static int ir_read(IRBuild_p b, int block, int var, TypeIndex type)
+{
+   IRFun_p   fun = b->fun;
+   IRBlock_p blk = &fun->blocks[block];
+   int       val;
+
+   if(b->defs[block][var] >= 0)
+   {
+      return b->defs[block][var];
+   }
+   if(!b->sealed[block])
+   {
+      val = ir_new_phi(fun, block, type);
+      if(b->incomplete_ctr == b->incomplete_size)
+      {
+         b->incomplete_size = b->incomplete_size? 2*b->incomplete_size : 16;
+         b->incomplete = IRRealloc(b->incomplete, b->incomplete_size*
+                                   sizeof(IRIncompleteCell));
+      }
+      b->incomplete[b->incomplete_ctr].block = block;
+      b->incomplete[b->incomplete_ctr].var   = var;
+      b->incomplete[b->incomplete_ctr].phi   = val;
+      b->incomplete_ctr++;
+   }
+   else if(blk->pred_ctr == 0)
+   {
+      /* Unreachable code */
+      val = IRConst(fun, type, 0);
+   }
+   else if(blk->pred_ctr == 1)
+   {
+      val = ir_read(b, blk->preds[0], var, type);
+   }
+   else
+   {
+      val = ir_new_phi(fun, block, type);
+      ir_write(b, block, var, val);
+      ir_add_phi_operands(b, block, var, val);
+   }
+   ir_write(b, block, var, val);
+
+   return val;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_new_block()
+// Function: ir_seal()
+//
+//   Create a block (for the builder), and declare that all
+//   predecessors of block are known.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static int ir_new_block(IRBuild_p b, bool sealed)
+{
+   int block = IRNewBlock(b->fun), i;
+
+   if(block >= b->def_size)
+   {
+      b->def_size = 2*block+8;
+      b->defs   = IRRealloc(b->defs, b->def_size*sizeof(int*));
+      b->sealed = IRRealloc(b->sealed, b->def_size*sizeof(bool));
+   }
+   b->defs[block] = IRAlloc((b->vars+1)*sizeof(int));
+   for(i=0; i<b->vars; i++)
+   {
+      b->defs[block][i] = -1;
+   }
+   b->sealed[block] = sealed;
+
+   return block;
+}
+
+static void ir_seal(IRBuild_p b, int block)
+{
+   int i;
+
+   for(i=0; i<b->incomplete_ctr; i++)
+   {
+      if(b->incomplete[i].block == block)
+      {
+         ir_add_phi_operands(b, block, b->incomplete[i].var,
+                             b->incomplete[i].phi);
+         b->incomplete[i--] = b->incomplete[--b->incomplete_ctr];
+      }
+   }
+   b->sealed[block] = true;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_emit()
+//
+//   Append a new instruction to the current block and return it.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static int ir_emit(IRBuild_p b, IROp op, TypeIndex type, long k)
+{
+   int instr = IRNewInstr(b->fun, op, type, k);
+
+   IRAppend(b->fun, b->cur, instr);
+   return instr;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_jump()
+// Function: ir_branch()
+//
+//   End the current block with a jump to target, or with a branch
+//   to succ (if a rel b) or fail (otherwise).
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void ir_jump(IRBuild_p b, int target)
+{
+   IRFun_p fun = b->fun;
+
+   ir_emit(b, IR_JMP, T_NoType, 0);
+   fun->blocks[b->cur].succ[0]  = target;
+   fun->blocks[b->cur].succ_ctr = 1;
+   IRAddPred(fun, target, b->cur);
+}
+
+static void ir_branch(IRBuild_p b, IRRel rel, int x, int y, int succ,
+                      int fail)
+{
+   IRFun_p fun = b->fun;
+   int     instr;
+
+   instr = ir_emit(b, IR_BR, T_NoType, rel);
+   IRAddArg(fun, instr, x);
+   IRAddArg(fun, instr, y);
+   fun->blocks[b->cur].succ[0]  = succ;
+   fun->blocks[b->cur].succ[1]  = fail;
+   fun->blocks[b->cur].succ_ctr = 2;
+   IRAddPred(fun, succ, b->cur);
+   IRAddPred(fun, fail, b->cur);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_is_local()
+// Function: ir_var()
+//
+//   Tell if ident denotes a local variable, and return its frame
+//   slot.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static inline bool ir_is_local(AST_p ident)
+{
+   return ident->sym_table->depth > 0;
+}
+
+static inline int ir_var(AST_p ident)
+{
+   return STFrameSlot(ident->sym_table, ident->sym_slot);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_args()
+//
+//   Evaluate the actual arguments args and add them as operands to
+//   instr.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static int ir_expr(IRBuild_p b, AST_p ast);
+
+static void ir_args(IRBuild_p b, int instr, AST_p args)
+{
+   int val;
+
+   switch(args->type)
+   {
+   case nil:
+         break;
+   case arglist:
+         ir_args(b, instr, args->child[0]);
+         if(args->child[1])
+         {
+            ir_args(b, instr, args->child[1]);
+         }
+         break;
+   default:
+         val = ir_expr(b, args);
+         IRAddArg(b->fun, instr, val);
+         break;
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_expr()
+//
+//   Translate an expression (operands from left to right). Return
+//   its value.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static int ir_expr(IRBuild_p b, AST_p ast)
+{
+   IRFun_p fun = b->fun;
+   int     instr, x, y;
+   IROp    op;
+
+   switch(ast->type)
+   {
+   case t_INTLIT:
+         return IRConst(fun, T_Integer, ast->intval);
+   case t_STRINGLIT:
+         instr = IRNewInstr(fun, IR_STR, T_String, 0);
+         fun->instrs[instr].str = InterpStrLiteral(ast->litval);
+         return instr;
+   case t_IDENT:
+         if(ir_is_local(ast))
+         {
+            return ir_read(b, b->cur, ir_var(ast), ast->result_type);
+         }
+         return ir_emit(b, IR_GETG, ast->result_type, ast->sym_slot);
+   case funcall:
+         /* The call goes behind the code of its arguments */
+         instr = IRNewInstr(fun, IR_CALL, ast->result_type, ast->sym_slot);
+         ir_args(b, instr, ast->child[1]);
+         IRAppend(fun, b->cur, instr);
+         return instr;
+   case t_MINUS:
+         if(!ast->child[1])
+         {
+            x     = ir_expr(b, ast->child[0]);
+            instr = ir_emit(b, IR_NEG, T_Integer, 0);
+            IRAddArg(fun, instr, x);
+            return instr;
+         }
+         /* Fall through */
+   case t_PLUS:
+   case t_MULT:
+   case t_DIV:
+         op = ast->type == t_PLUS? IR_ADD : ast->type == t_MINUS? IR_SUB :
+            ast->type == t_MULT? IR_MUL : IR_DIV;
+         x     = ir_expr(b, ast->child[0]);
+         y     = ir_expr(b, ast->child[1]);
+         instr = ir_emit(b, op, T_Integer, 0);
+         IRAddArg(fun, instr, x);
+         IRAddArg(fun, instr, y);
+         return instr;
+   default:
+         assert(false && "Unexpected AST type in ir_expr()");
+         return -1;
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_cond()
+//
+//   Translate a comparison into a branch to succ or fail. Strings
+//   are compared by comparing the result of IR_SCMP with 0.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void ir_cond(IRBuild_p b, AST_p ast, int succ, int fail)
+{
+   IRRel rel;
+   int   x, y, cmp;
+
+   switch(ast->type)
+   {
+   case t_EQ:
+         rel = IR_EQ;
+         break;
+   case t_NEQ:
+         rel = IR_NE;
+         break;
+   case t_LT:
+         rel = IR_LT;
+         break;
+   case t_LEQ:
+         rel = IR_LE;
+         break;
+   case t_GT:
+         rel = IR_GT;
+         break;
+   case t_GEQ:
+         rel = IR_GE;
+         break;
+   default:
+         assert(false && "Unexpected AST type in ir_cond()");
+         rel = IR_EQ;
+         break;
+   }
+   x = ir_expr(b, ast->child[0]);
+   y = ir_expr(b, ast->child[1]);
+   if(ast->child[0]->result_type == T_String)
+   {
+      cmp = ir_emit(b, IR_SCMP, T_Integer, 0);
+      IRAddArg(b->fun, cmp, x);
+      IRAddArg(b->fun, cmp, y);
+      x = cmp;
+      y = IRConst(b->fun, T_Integer, 0);
+   }
+   ir_branch(b, rel, x, y, succ, fail);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_stmt()
+//
+//   Translate a statement (list) into the current block and the
+//   blocks behind it.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void ir_stmt(IRBuild_p b, AST_p ast)
+{
+   IRFun_p       fun = b->fun;
+   SymbolTable_p scope;
+   int           header, loop, after, succ, fail, val, instr, i;
+
+   switch(ast->type)
+   {
+   case nil:
+         break;
+   case stmts:
+         ir_stmt(b, ast->child[0]);
+         ir_stmt(b, ast->child[1]);
+         break;
+   case body:
+         /* Locals start out as 0 or the empty string */
+         scope = ast->context;
+         for(i=0; i<scope->symbol_ctr; i++)
+         {
+            ir_write(b, b->cur, STFrameSlot(scope, i),
+                     IRConst(fun, scope->symbols[i].type, 0));
+         }
+         ir_stmt(b, ast->child[1]);
+         break;
+   case while_stmt:
+         /* Body first, test at the bottom */
+         header = ir_new_block(b, false);
+         loop   = ir_new_block(b, false);
+         after  = ir_new_block(b, false);
+         ir_jump(b, header);
+         b->cur = header;
+         ir_cond(b, ast->child[1], loop, after);
+         ir_seal(b, loop);
+         b->cur = loop;
+         IRPlace(fun, loop, -1);
+         ir_stmt(b, ast->child[2]);
+         ir_jump(b, header);
+         ir_seal(b, header);
+         IRPlace(fun, header, -1);
+         ir_seal(b, after);
+         b->cur = after;
+         IRPlace(fun, after, -1);
+         break;
+   case if_stmt:
+         succ = ir_new_block(b, false);
+         after = ir_new_block(b, false);
+         fail = ast->child[3]? ir_new_block(b, false) : after;
+         ir_cond(b, ast->child[1], succ, fail);
+         ir_seal(b, succ);
+         b->cur = succ;
+         IRPlace(fun, succ, -1);
+         ir_stmt(b, ast->child[2]);
+         ir_jump(b, after);
+         if(ast->child[3])
+         {
+            ir_seal(b, fail);
+            b->cur = fail;
+            IRPlace(fun, fail, -1);
+            ir_stmt(b, ast->child[3]);
+            ir_jump(b, after);
+         }
+         ir_seal(b, after);
+         b->cur = after;
+         IRPlace(fun, after, -1);
+         break;
+   case ret_stmt:
+         if(ASTIsTailCall(ast) && ast->child[1]->sym_slot == fun->sym)
+         {
+            /* New values for the parameters, and start over. Other
+               tail calls are left to the code generators. */
+            instr = IRNewInstr(fun, IR_NOP, T_NoType, 0);
+            ir_args(b, instr, ast->child[1]->child[1]);
+            for(i=0; i<fun->instrs[instr].argc; i++)
+            {
+               ir_write(b, b->cur, i, fun->instrs[instr].args[i]);
+            }
+            fun->instrs[instr].argc = 0;
+            ir_jump(b, b->restart);
+         }
+         else
+         {
+            val   = ir_expr(b, ast->child[1]);
+            instr = ir_emit(b, IR_RET, T_NoType, 0);
+            IRAddArg(fun, instr, val);
+         }
+         /* Anything behind is unreachable */
+         b->cur = ir_new_block(b, true);
+         IRPlace(fun, b->cur, -1);
+         break;
+   case print_stmt:
+         val   = ir_expr(b, ast->child[1]);
+         instr = ir_emit(b, IR_PRINT, T_NoType, 0);
+         IRAddArg(fun, instr, val);
+         break;
+   case assign:
+         val = ir_expr(b, ast->child[1]);
+         if(ir_is_local(ast->child[0]))
+         {
+            ir_write(b, b->cur, ir_var(ast->child[0]), val);
+         }
+         else
+         {
+            instr = ir_emit(b, IR_SETG, T_NoType, ast->child[0]->sym_slot);
+            IRAddArg(fun, instr, val);
+         }
+         break;
+   case funcall_stmt:
+         ir_expr(b, ast->child[0]);
+         break;
+   default:
+         assert(false && "Unexpected AST type in ir_stmt()");
+         break;
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_has_tail()
+//
+//   Return true if the statement (list) ast contains a tail call of
+//   the function at global position sym.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static bool ir_has_tail(AST_p ast, long sym)
+{
+   int i;
+
+   if(!ast)
+   {
+      return false;
+   }
+   if(ASTIsTailCall(ast) && ast->child[1]->sym_slot == sym)
+   {
+      return true;
+   }
+   for(i=0; i<MAXCHILD; i++)
+   {
+      if(ast->type != ret_stmt && ir_has_tail(ast->child[i], sym))
+      {
+         return true;
+      }
+   }
+   return false;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_fundef()
+//
+//   Translate a function definition.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static IRFun_p ir_fundef(AST_p def)
+{
+   SymbolTable_p params = def->child[2]->context;
+   IRFun_p       fun    = IRAlloc(sizeof(IRFunCell));
+   IRBuildCell   b;
+   int           i, instr;
+
+   memset(fun, 0, sizeof(IRFunCell));
+   fun->sym    = def->child[1]->sym_slot;
+   fun->name   = def->child[1]->litval;
+   fun->type   = def->child[0]->type == t_STRING? T_String : T_Integer;
+   fun->arity  = params->symbol_ctr;
+   fun->params = IRAlloc((fun->arity+1)*sizeof(int));
+
+   memset(&b, 0, sizeof(IRBuildCell));
+   b.fun     = fun;
+   b.vars    = params->frame_size;
+   b.restart = -1;
+   b.cur     = ir_new_block(&b, true);
+   IRPlace(fun, b.cur, -1);
+
+   for(i=0; i<fun->arity; i++)
+   {
+      fun->params[i] = ir_emit(&b, IR_PARAM, params->symbols[i].type, i);
+      ir_write(&b, b.cur, STFrameSlot(params, i), fun->params[i]);
+   }
+   if(ir_has_tail(def->child[3], fun->sym))
+   {
+      b.restart = ir_new_block(&b, false);
+      ir_jump(&b, b.restart);
+      b.cur = b.restart;
+      IRPlace(fun, b.cur, -1);
+   }
+   ir_stmt(&b, def->child[3]);
+
+   /* Functions that end without return yield 0 or the empty string */
+   if(!fun->blocks[b.cur].code_ctr ||
+      (fun->instrs[IRTerminator(fun, b.cur)].op != IR_RET &&
+       fun->instrs[IRTerminator(fun, b.cur)].op != IR_JMP))
+   {
+      instr = ir_emit(&b, IR_RET, T_NoType, 0);
+      IRAddArg(fun, instr, IRConst(fun, fun->type, 0));
+   }
+   if(b.restart >= 0)
+   {
+      ir_seal(&b, b.restart);
+   }
+   assert(b.incomplete_ctr == 0);
+
+   for(i=0; i<fun->block_ctr; i++)
+   {
+      free(b.defs[i]);
+   }
+   free(b.defs);
+   free(b.sealed);
+   free(b.incomplete);
+
+   IRRemoveUnreachable(fun);
+   IRCompact(fun);
+
+   return fun;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_fun_free()
+//
+//   Free a function with all its analyses.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void ir_fun_free(IRFun_p junk)
+{
+   int i;
+
+   for(i=0; i<junk->instr_ctr; i++)
+   {
+      free(junk->instrs[i].args);
+   }
+   for(i=0; i<junk->block_ctr; i++)
+   {
+      free(junk->blocks[i].code);
+      free(junk->blocks[i].preds);
+   }
+   free(junk->instrs);
+   free(junk->blocks);
+   free(junk->layout);
+   free(junk->params);
+   free(junk->rpo);
+   free(junk->idom);
+   free(junk->dom_order);
+   free(junk->live_in);
+   free(junk->live_out);
+   free(junk->use_ctr);
+   free(junk->use_start);
+   free(junk->uses);
+   free(junk);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_print_value()
+//
+//   Print a value (constants as themselves).
+//
+// Global Variables: -
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+static void ir_print_value(FILE* out, IRFun_p fun, int v)
+{
+   NanoStr s;
+
+   switch(fun->instrs[v].op)
+   {
+   case IR_CONST:
+         if(fun->instrs[v].type == T_String)
+         {
+            fputs(" \"\"", out);
+         }
+         else
+         {
+            fprintf(out, " %ld", fun->instrs[v].k);
+         }
+         break;
+   case IR_STR:
+         fputs(" \"", out);
+         for(s=fun->instrs[v].str; s && *s; s++)
+         {
+            if(*s == '"' || *s == '\\' || (unsigned char)*s < ' ')
+            {
+               fprintf(out, "\\%03o", (unsigned char)*s);
+            }
+            else
+            {
+               putc(*s, out);
+            }
+         }
+         putc('"', out);
+         break;
+   default:
+         fprintf(out, " v%d", v);
+         break;
+   }
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                         Exported Functions                          */
+/*---------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------
+//
+// Function: IRAlloc()
+// Function: IRRealloc()
+//
+//   malloc() and realloc() that terminate the program if memory runs
+//   out.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+void* IRAlloc(size_t size)
+{
+   return IRRealloc(NULL, size);
+}
+
+void* IRRealloc(void* ptr, size_t size)
+{
+   void *res = realloc(ptr, size? size : 1);
+
+   if(!res)
+   {
+      fprintf(stderr, "Out of memory in IR!\n");
+      exit(EXIT_FAILURE);
+   }
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: IRNewInstr()
+// Function: IRAddArg()
+//
+//   Create an instruction (in no block) and return its value number,
+//   and add the operand v to instr.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+int IRNewInstr(IRFun_p fun, IROp op, TypeIndex type, long k)
+{
+   IRInstr_p instr;
+
+   if(fun->instr_ctr == fun->instr_size)
+   {
+      fun->instr_size = fun->instr_size? 2*fun->instr_size : 64;
+      fun->instrs = IRRealloc(fun->instrs, fun->instr_size*sizeof(IRInstrCell));
+   }
+   instr = &fun->instrs[fun->instr_ctr];
+   instr->op       = op;
+   instr->type     = type;
+   instr->block    = -1;
+   instr->k        = k;
+   instr->str      = NULL;
+   instr->argc     = 0;
+   instr->arg_size = 0;
+   instr->args     = NULL;
+
+   return fun->instr_ctr++;
+}
+
+void IRAddArg(IRFun_p fun, int instr, int v)
+{
+   IRInstr_p i = &fun->instrs[instr];
+
+   if(i->argc == i->arg_size)
+   {
+      i->arg_size = i->arg_size? 2*i->arg_size : 2;
+      i->args = IRRealloc(i->args, i->arg_size*sizeof(int));
+   }
+   i->args[i->argc++] = v;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: IRConst()
+// Function: IRMakeConst()
+//
+//   Create a constant of type type, and turn the Integer value v into
+//   the constant k (it is removed from its block by IRCompact()).
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+int IRConst(IRFun_p fun, TypeIndex type, long k)
+{
+   return IRNewInstr(fun, IR_CONST, type, k);
+}
+
+void IRMakeConst(IRFun_p fun, int v, long k)
+{
+   fun->instrs[v].op   = IR_CONST;
+   fun->instrs[v].k    = k;
+   fun->instrs[v].argc = 0;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: IRAppend()
+// Function: IRInsertBefore()
+//
+//   Append instr to block, or insert it into the block of the
+//   instruction before, in front of it.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+void IRAppend(IRFun_p fun, int block, int instr)
+{
+   IRBlock_p blk = &fun->blocks[block];
+
+   if(blk->code_ctr == blk->code_size)
+   {
+      blk->code_size = blk->code_size? 2*blk->code_size : 8;
+      blk->code = IRRealloc(blk->code, blk->code_size*sizeof(int));
+   }
+   blk->code[blk->code_ctr++] = instr;
+   fun->instrs[instr].block = block;
+}
+
+void IRInsertBefore(IRFun_p fun, int instr, int before)
+{
+   int       block = fun->instrs[before].block, i;
+   IRBlock_p blk   = &fun->blocks[block];
+
+   IRAppend(fun, block, instr);
+   for(i=blk->code_ctr-1; blk->code[i-1] != before; i--)
+   {
+      blk->code[i] = blk->code[i-1];
+   }
+   blk->code[i]   = before;
+   blk->code[i-1] = instr;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: IRNewBlock()
+//
+//   Create an empty block (not yet in the layout) and return it.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+int IRNewBlock(IRFun_p fun)
+{
+   if(fun->block_ctr == fun->block_size)
+   {
+      fun->block_size = fun->block_size? 2*fun->block_size : 16;
+      fun->blocks = IRRealloc(fun->blocks, fun->block_size*sizeof(IRBlockCell));
+      fun->layout = IRRealloc(fun->layout, fun->block_size*sizeof(int));
+   }
+   memset(&fun->blocks[fun->block_ctr], 0, sizeof(IRBlockCell));
+   fun->blocks[fun->block_ctr].trips = -1;
+   return fun->block_ctr++;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: IRAddPred()
+// Function: IRRemovePred()
+//
+//   Add pred as the last predecessor of block, or remove the
+//   predecessor at position pos (and the corresponding phi
+//   operands).
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+void IRAddPred(IRFun_p fun, int block, int pred)
+{
+   IRBlock_p blk = &fun->blocks[block];
+
+   if(blk->pred_ctr == blk->pred_size)
+   {
+      blk->pred_size = blk->pred_size? 2*blk->pred_size : 4;
+      blk->preds = IRRealloc(blk->preds, blk->pred_size*sizeof(int));
+   }
+   blk->preds[blk->pred_ctr++] = pred;
+}
+
+void IRRemovePred(IRFun_p fun, int block, int pos)
+{
+   IRBlock_p blk = &fun->blocks[block];
+   IRInstr_p phi;
+   int       i, j;
+
+   for(i=0; i<blk->code_ctr; i++)
+   {
+      phi = &fun->instrs[blk->code[i]];
+      if(phi->op == IR_PHI)
+      {
+         for(j=pos; j+1<phi->argc; j++)
+         {
+            phi->args[j] = phi->args[j+1];
+         }
+         phi->argc--;
+      }
+   }
+   for(j=pos; j+1<blk->pred_ctr; j++)
+   {
+      blk->preds[j] = blk->preds[j+1];
+   }
+   blk->pred_ctr--;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: IRPlace()
+//
+//   Put block into the layout in front of the block before (at the
+//   end for -1).
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+void IRPlace(IRFun_p fun, int block, int before)
+{
+   int pos = fun->layout_ctr;
+
+   if(before >= 0)
+   {
+      for(pos=0; fun->layout[pos] != before; pos++)
+      {
+      }
+      memmove(fun->layout+pos+1, fun->layout+pos,
+              (fun->layout_ctr-pos)*sizeof(int));
+   }
+   fun->layout[pos] = block;
+   fun->layout_ctr++;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: IRCompact()
+//
+//   Remove removed instructions and constants from the blocks.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+void IRCompact(IRFun_p fun)
+{
+   IRBlock_p blk;
+   IRInstr_p instr;
+   int       b, i, n;
+
+   for(b=0; b<fun->block_ctr; b++)
+   {
+      blk = &fun->blocks[b];
+      for(i=0, n=0; i<blk->code_ctr; i++)
+      {
+         instr = &fun->instrs[blk->code[i]];
+         if(instr->op == IR_NOP || instr->op == IR_CONST ||
+            instr->op == IR_STR)
+         {
+            instr->block = -1;
+         }
+         else
+         {
+            blk->code[n++] = blk->code[i];
+         }
+      }
+      blk->code_ctr = n;
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: IRRemoveUnreachable()
+//
+//   Remove the blocks that cannot be reached from the entry. Return
+//   their number.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+long IRRemoveUnreachable(IRFun_p fun)
+{
+   bool      *seen = IRAlloc((fun->block_ctr+1)*sizeof(bool));
+   int       *stack = IRAlloc((fun->block_ctr+1)*sizeof(int));
+   int       sp = 0, b, s, i, j;
+   long      res = 0;
+   IRBlock_p blk;
+
+   memset(seen, 0, (fun->block_ctr+1)*sizeof(bool));
+   seen[0]    = true;
+   stack[sp++] = 0;
+   while(sp)
+   {
+      blk = &fun->blocks[stack[--sp]];
+      for(i=0; i<blk->succ_ctr; i++)
+      {
+         if(!seen[blk->succ[i]])
+         {
+            seen[blk->succ[i]] = true;
+            stack[sp++] = blk->succ[i];
+         }
+      }
+   }
+   for(b=0; b<fun->block_ctr; b++)
+   {
+      blk = &fun->blocks[b];
+      if(seen[b] || blk->dead)
+      {
+         continue;
+      }
+      res++;
+      blk->dead = true;
+      for(i=0; i<blk->succ_ctr; i++)
+      {
+         s = blk->succ[i];
+         for(j=fun->blocks[s].pred_ctr-1; j>=0; j--)
+         {
+            if(fun->blocks[s].preds[j] == b)
+            {
+               IRRemovePred(fun, s, j);
+            }
+         }
+      }
+      for(i=0; i<blk->code_ctr; i++)
+      {
+         fun->instrs[blk->code[i]].op = IR_NOP;
+      }
+      blk->code_ctr = 0;
+      blk->succ_ctr = 0;
+   }
+   for(i=0, j=0; i<fun->layout_ctr; i++)
+   {
+      if(!fun->blocks[fun->layout[i]].dead)
+      {
+         fun->layout[j++] = fun->layout[i];
+      }
+   }
+   fun->layout_ctr = j;
+   free(seen);
+   free(stack);
+
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: IRHasEffect()
+//
+//   Return true if the instruction v must be kept even if its value
+//   is not used (parameters are kept as part of the signature).
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+bool IRHasEffect(IRFun_p fun, int v)
+{
+   IRInstr_p instr = &fun->instrs[v];
+   IRInstr_p div;
+
+   switch(instr->op)
+   {
+   case IR_PARAM:
+   case IR_SETG:
+   case IR_CALL:
+   case IR_PRINT:
+   case IR_JMP:
+   case IR_BR:
+   case IR_RET:
+         return true;
+   case IR_DIV:
+         /* May fail with division by zero */
+         div = &fun->instrs[instr->args[1]];
+         return div->op != IR_CONST || div->k == 0;
+   default:
+         return false;
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: IRBuild()
+//
+//   Translate the checked program with global symbol table st into
+//   SSA form.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+IRProg_p IRBuild(SymbolTable_p st, AST_p program)
+{
+   IRProg_p handle    = IRProgCellAlloc();
+   AST_p    *functions = InterpFunctionTable(st, program);
+   Symbol_p main_sym;
+   long     i;
+
+   handle->st         = st;
+   handle->global_ctr = st->symbol_ctr;
+   handle->reduce     = true;
+   handle->funs       = IRAlloc((st->symbol_ctr+1)*sizeof(IRFun_p));
+   for(i=0; i<st->symbol_ctr; i++)
+   {
+      handle->funs[i] = functions[i]? ir_fundef(functions[i]) : NULL;
+      if(handle->funs[i])
+      {
+         handle->funs[i]->prog = handle;
+      }
+   }
+   main_sym = STFindSymbolLocal(st, StrIntern("main"));
+   handle->main_fun = main_sym? main_sym - st->symbols : -1;
+   free(functions);
+
+   return handle;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: IRProgFree()
+//
+//   Free an IR program.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+void IRProgFree(IRProg_p junk)
+{
+   long i;
+
+   for(i=0; i<junk->global_ctr; i++)
+   {
+      if(junk->funs[i])
+      {
+         ir_fun_free(junk->funs[i]);
+      }
+   }
+   free(junk->funs);
+   IRProgCellFree(junk);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: IRPrintFun()
+// Function: IRPrint()
+//
+//   Print the IR of a function or a program in readable form.
+//
+// Global Variables: ir_op_name, ir_rel_name
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+void IRPrintFun(FILE* out, IRFun_p fun)
+{
+   IRBlock_p blk;
+   IRInstr_p instr;
+   int       b, i, j;
+
+   fprintf(out, "function %s (%d parameters)\n", fun->name, fun->arity);
+   for(b=0; b<fun->layout_ctr; b++)
+   {
+      blk = &fun->blocks[fun->layout[b]];
+      fprintf(out, "b%d:", fun->layout[b]);
+      if(blk->pred_ctr)
+      {
+         fputs("   <-", out);
+         for(j=0; j<blk->pred_ctr; j++)
+         {
+            fprintf(out, " b%d", blk->preds[j]);
+         }
+      }
+      if(blk->trips >= 0)
+      {
+         fprintf(out, "   (%ld iterations)", blk->trips);
+      }
+      putc('\n', out);
+      for(i=0; i<blk->code_ctr; i++)
+      {
+         instr = &fun->instrs[blk->code[i]];
+         fputs("   ", out);
+         if(instr->type != T_NoType)
+         {
+            fprintf(out, "v%d = ", blk->code[i]);
+         }
+         fputs(ir_op_name[instr->op], out);
+         if(instr->op == IR_BR)
+         {
+            fprintf(out, " %s", ir_rel_name[instr->k]);
+         }
+         else if(instr->op == IR_PARAM || instr->op == IR_GETG ||
+                 instr->op == IR_SETG || instr->op == IR_CALL)
+         {
+            fprintf(out, " %ld", instr->k);
+         }
+         for(j=0; j<instr->argc; j++)
+         {
+            ir_print_value(out, fun, instr->args[j]);
+         }
+         for(j=0; j<blk->succ_ctr && i == blk->code_ctr-1; j++)
+         {
+            fprintf(out, "%s b%d", j? "," : " ->", blk->succ[j]);
+         }
+         putc('\n', out);
+      }
+   }
+}
+
+void IRPrint(FILE* out, IRProg_p prog)
+{
+   long i;
+
+   for(i=0; i<prog->global_ctr; i++)
+   {
+      if(prog->funs[i])
+      {
+         IRPrintFun(out, prog->funs[i]);
+      }
+   }
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                        End of File                                  */
+/*---------------------------------------------------------------------*/
@@ -0,0 +1,232 @@
+/*-----------------------------------------------------------------------
+
+File  : ir.h
+
+Authors: Konstantin Kläger, Isabel Staaden, Carolin Rösch
+
+Contents
+
+  Intermediate representation of checked nanoLang programs: every
+  function is a control flow graph of basic blocks in SSA form. It is
+  built from the annotated AST (after the AST optimizations, see
+  optimize.h), transformed by the passes in irpass.h, and consumed by
+  the code generators (bytecode.h, and through it the VM, the JIT and
+  the assembly backend, and cgen.h). The tree-walking interpreter
+  stays on the AST as the reference engine.
+
+  Values are instructions, named by their position in the
+  instruction array of the function. Local variables (frame slots)
+  exist only during construction: every assignment defines a new
+  value, and phi nodes merge the values of a variable where control
+  flow joins (behind if statements and at loop headers). The
+  construction follows Braun et al., "Simple and Efficient
+  Construction of Static Single Assignment Form" (CC 2013), which
+  needs no dominance information and works directly on the AST.
+
+  Constants (IR_CONST, IR_STR) belong to no block. They are
+  available everywhere, and code generators use them as immediates
+  or rematerialize them where they are needed.
+
+  Blocks hold their instructions in order (phis first, the
+  terminator last) and their predecessors in the order of the phi
+  operands. The layout is the order in which code generators place
+  the blocks: while loops have their test at the bottom, as in the
+  bytecode of the AST compiler before.
+
+  Self tail calls (ASTIsTailCall()) jump back to a restart block
+  behind the entry, where the parameters become phis. Other tail
+  calls stay an IR_CALL followed by the IR_RET of its value; the
+  bytecode compiler turns this pair into BC_TCALL.
+
+  This code is released under the GNU General Public Licence.
+
+Changes
+
+<1> Sun Oct 18 11:02:13 CEST 2026
+    New
+
+-----------------------------------------------------------------------*/
+
+#ifndef IR
+
+#define IR
+
+#include "ast.h"
+#include "nanort.h"
+
+
+/*---------------------------------------------------------------------*/
+/*                    Data type declarations                           */
+/*---------------------------------------------------------------------*/
+
+/* Operand notation: a, b = values, k = the constant field */
+typedef enum
+{
+   IR_NOP,      /*            Removed instruction */
+   IR_CONST,    /* k          Integer constant (0 of type String: "") */
+   IR_STR,      /* str        String literal */
+   IR_PARAM,    /* k          Parameter k */
+   IR_PHI,      /* a ...      One operand per predecessor */
+   IR_ADD,      /* a b */
+   IR_SUB,      /* a b */
+   IR_MUL,      /* a b */
+   IR_DIV,      /* a b */
+   IR_NEG,      /* a */
+   IR_SCMP,     /* a b        String comparison: < 0, 0, > 0 */
+   IR_GETG,     /* k          Global variable k */
+   IR_SETG,     /* k a */
+   IR_CALL,     /* k a ...    Function k (global position) */
+   IR_PRINT,    /* a */
+   IR_JMP,      /*            Goto successor 0 */
+   IR_BR,       /* k a b      Successor 0 if a k b, else successor 1 */
+   IR_RET,      /* a */
+   IR_OPCOUNT
+}IROp;
+
+/* Relations of IR_BR, in the order of BC_JEQ ... BC_JGE */
+typedef enum
+{
+   IR_EQ,
+   IR_NE,
+   IR_LT,
+   IR_LE,
+   IR_GT,
+   IR_GE
+}IRRel;
+
+typedef struct irinstr
+{
+   IROp      op;
+   TypeIndex type;     /* Of the result, T_NoType if there is none */
+   int       block;    /* -1 for constants and removed instructions */
+   long      k;
+   NanoStr   str;
+   int       argc;
+   int       arg_size;
+   int       *args;
+}IRInstrCell, *IRInstr_p;
+
+typedef struct irblock
+{
+   int  *code;         /* Instructions */
+   int  code_ctr;
+   int  code_size;
+   int  *preds;
+   int  pred_ctr;
+   int  pred_size;
+   int  succ[2];       /* Given by the terminator */
+   int  succ_ctr;
+   bool dead;          /* Unreachable, removed */
+   long trips;         /* Loop header: iterations if known, else -1 */
+}IRBlockCell, *IRBlock_p;
+
+/* Analyses, see irpass.h */
+typedef unsigned IRAnalyses;
+
+typedef struct irfun
+{
+   struct irprog *prog;       /* Containing program */
+   long         sym;          /* Global position */
+   char         *name;
+   TypeIndex    type;         /* Result type */
+   int          arity;
+   int          *params;      /* Values of the parameters */
+   IRInstr_p    instrs;
+   int          instr_ctr;
+   int          instr_size;
+   IRBlock_p    blocks;       /* Block 0 is the entry */
+   int          block_ctr;
+   int          block_size;
+   int          *layout;      /* Live blocks in code order */
+   int          layout_ctr;
+   bool         pure;         /* See IRFindPure() */
+
+   /* Cached analyses (valid ones are flagged in valid) */
+   IRAnalyses   valid;
+   int          *rpo;         /* Reachable blocks in reverse postorder */
+   int          rpo_ctr;
+   int          *idom;        /* Immediate dominator, -1 for the entry */
+   int          *dom_order;   /* Preorder of the dominator tree */
+   int          live_words;   /* Per set */
+   unsigned long *live_in;    /* Per block: values live behind the phis */
+   unsigned long *live_out;
+   int          *use_ctr;     /* Per value */
+   int          *use_start;   /* Users of value v: uses[use_start[v]...] */
+   int          *uses;
+}IRFunCell, *IRFun_p;
+
+typedef struct irprog
+{
+   SymbolTable_p st;
+   IRFun_p       *funs;       /* Indexed by global position */
+   long          global_ctr;
+   long          main_fun;
+   bool          reduce;      /* ivsr may add induction variables */
+}IRProgCell, *IRProg_p;
+
+/* Pending operand of a phi in a block that is not yet sealed */
+typedef struct irincomplete
+{
+   int block;
+   int var;
+   int phi;
+}IRIncompleteCell, *IRIncomplete_p;
+
+/* State of the SSA construction for one function */
+typedef struct irbuild
+{
+   IRFun_p        fun;
+   int            cur;          /* Current block */
+   int            restart;      /* Target of tail calls, or -1 */
+   int            vars;         /* Frame slots of the function */
+   int            **defs;       /* Per block: current value of every slot */
+   bool           *sealed;      /* Per block: all predecessors known */
+   int            def_size;
+   IRIncomplete_p incomplete;
+   int            incomplete_ctr;
+   int            incomplete_size;
+}IRBuildCell, *IRBuild_p;
+
+
+/*---------------------------------------------------------------------*/
+/*                Exported Functions and Variables                     */
+/*---------------------------------------------------------------------*/
+
+extern char* ir_op_name[];
+
+#define IRProgCellAlloc()    (IRProgCell*)malloc(sizeof(IRProgCell))
+#define IRProgCellFree(junk) free(junk)
+
+#define IRIsConst(fun, v) ((fun)->instrs[v].op == IR_CONST || \
+                           (fun)->instrs[v].op == IR_STR)
+#define IRTerminator(fun, b) \
+   ((fun)->blocks[b].code[(fun)->blocks[b].code_ctr-1])
+
+void*    IRAlloc(size_t size);
+void*    IRRealloc(void* ptr, size_t size);
+
+int      IRNewInstr(IRFun_p fun, IROp op, TypeIndex type, long k);
+void     IRAddArg(IRFun_p fun, int instr, int v);
+int      IRConst(IRFun_p fun, TypeIndex type, long k);
+void     IRMakeConst(IRFun_p fun, int v, long k);
+void     IRAppend(IRFun_p fun, int block, int instr);
+void     IRInsertBefore(IRFun_p fun, int instr, int before);
+int      IRNewBlock(IRFun_p fun);
+void     IRAddPred(IRFun_p fun, int block, int pred);
+void     IRRemovePred(IRFun_p fun, int block, int pos);
+void     IRPlace(IRFun_p fun, int block, int before);
+void     IRCompact(IRFun_p fun);
+long     IRRemoveUnreachable(IRFun_p fun);
+bool     IRHasEffect(IRFun_p fun, int v);
+
+IRProg_p IRBuild(SymbolTable_p st, AST_p program);
+void     IRProgFree(IRProg_p junk);
+void     IRPrintFun(FILE* out, IRFun_p fun);
+void     IRPrint(FILE* out, IRProg_p prog);
+
+
+#endif
+
+/*---------------------------------------------------------------------*/
+/*                        End of File                                  */
+/*---------------------------------------------------------------------*/
@@ -0,0 +1,1759 @@
+/*-----------------------------------------------------------------------
+
+File  : irpass.c
+
+Authors: Konstantin Kläger, Isabel Staaden, Carolin Rösch
+
+Contents
+
+  Pass manager, analyses and optimization passes on the SSA IR (see
+  irpass.h).
+
+  This code is released under the GNU General Public Licence.
+
+Changes
+
+<1> Sun Oct 18 11:02:13 CEST 2026
+    New
+
+-----------------------------------------------------------------------*/
+
+#include "irpass.h"
+
+
+
+/*---------------------------------------------------------------------*/
+/*                        Global Variables                             */
+/*---------------------------------------------------------------------*/
+
+static long ir_simplify(IRFun_p fun);
+static long ir_licm(IRFun_p fun);
+static long ir_ivsr(IRFun_p fun);
+static long ir_dce(IRFun_p fun);
+
+/* The standard pipeline, terminated by a pass without name */
+IRPassCell ir_pipeline[] =
+{
+   {"simplify", ir_simplify, 0},
+   {"licm",     ir_licm,     IR_DOMINATORS},
+   {"ivsr",     ir_ivsr,     IR_DOMINATORS},
+   {"dce",      ir_dce,      IR_DOMINATORS},
+   {NULL,       NULL,        0}
+};
+
+/* Relations negated, and with swapped operands */
+static IRRel ir_rel_neg[]  = {IR_NE, IR_EQ, IR_GE, IR_GT, IR_LE, IR_LT};
+static IRRel ir_rel_swap[] = {IR_EQ, IR_NE, IR_GT, IR_GE, IR_LT, IR_LE};
+
+/* Basic induction variables of a loop handled at once */
+#define IR_MAX_IVS 16
+
+/* A basic induction variable: phi in the loop header, with start
+   value init, and next = phi + step from the latch */
+typedef struct iriv
+{
+   int  phi;
+   int  init;
+   int  next;
+   long step;
+}IRIVCell, *IRIV_p;
+
+
+/*---------------------------------------------------------------------*/
+/*                      Forward Declarations                           */
+/*---------------------------------------------------------------------*/
+
+
+/*---------------------------------------------------------------------*/
+/*                         Internal Functions                          */
+/*---------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_intersect()
+//
+//   Return the nearest common dominator of a and b (po numbers the
+//   blocks in postorder).
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static int ir_intersect(int* idom, int* po, int a, int b)
+{
+   while(a != b)
+   {
+      while(po[a] < po[b])
+      {
+         a = idom[a];
+      }
+      while(po[b] < po[a])
+      {
+         b = idom[b];
+      }
+   }
+   return a;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_dominators()
+//
+//   Compute the reverse postorder, the immediate dominators and a
+//   preorder of the dominator tree of fun.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void ir_dominators(IRFun_p fun)
+{
+   int       n = fun->block_ctr;
+   int       *po    = IRAlloc((n+1)*sizeof(int));
+   int       *stack = IRAlloc((n+1)*sizeof(int));
+   int       *next  = IRAlloc((n+1)*sizeof(int));
+   int       *first = IRAlloc((n+2)*sizeof(int));
+   int       *kids  = IRAlloc((n+1)*sizeof(int));
+   int       sp = 0, ctr = 0, b, s, i, j, new_idom;
+   bool      changed;
+   IRBlock_p blk;
+
+   fun->rpo       = IRRealloc(fun->rpo, (n+1)*sizeof(int));
+   fun->idom      = IRRealloc(fun->idom, (n+1)*sizeof(int));
+   fun->dom_order = IRRealloc(fun->dom_order, (n+1)*sizeof(int));
+
+   /* Depth first search for the postorder */
+   for(b=0; b<n; b++)
+   {
+      po[b]   = -1;
+      next[b] = 0;
+   }
+   po[0] = n;
+   stack[sp++] = 0;
+   while(sp)
+   {
+      b   = stack[sp-1];
+      blk = &fun->blocks[b];
+      if(next[b] < blk->succ_ctr)
+      {
+         s = blk->succ[next[b]++];
+         if(po[s] < 0)
+         {
+            po[s] = n;
+            stack[sp++] = s;
+         }
+      }
+      else
+      {
+         po[b] = ctr;
+         fun->rpo[n-1-ctr] = b;
+         ctr++;
+         sp--;
+      }
+   }
+   memmove(fun->rpo, fun->rpo+n-ctr, ctr*sizeof(int));
+   fun->rpo_ctr = ctr;
+
+   /* Iterate to the fixpoint, in reverse postorder */
+   for(b=0; b<n; b++)
+   {
+      fun->idom[b] = -1;
+   }
+   fun->idom[0] = 0;
+   do
+   {
+      changed = false;
+      for(i=1; i<fun->rpo_ctr; i++)
+      {
+         b   = fun->rpo[i];
+         blk = &fun->blocks[b];
+         new_idom = -1;
+         for(j=0; j<blk->pred_ctr; j++)
+         {
+            if(fun->idom[blk->preds[j]] >= 0)
+            {
+               new_idom = new_idom < 0? blk->preds[j] :
+                  ir_intersect(fun->idom, po, blk->preds[j], new_idom);
+            }
+         }
+         if(fun->idom[b] != new_idom)
+         {
+            fun->idom[b] = new_idom;
+            changed = true;
+         }
+      }
+   }while(changed);
+   fun->idom[0] = -1;
+
+   /* Children of every block (in reverse postorder), then preorder */
+   memset(first, 0, (n+2)*sizeof(int));
+   for(i=1; i<fun->rpo_ctr; i++)
+   {
+      first[fun->idom[fun->rpo[i]]+2]++;
+   }
+   for(b=0; b<n; b++)
+   {
+      first[b+2] += first[b+1];
+   }
+   for(i=1; i<fun->rpo_ctr; i++)
+   {
+      b = fun->rpo[i];
+      kids[first[fun->idom[b]+1]++] = b;
+   }
+   ctr = 0;
+   stack[sp++] = 0;
+   while(sp)
+   {
+      b = stack[--sp];
+      fun->dom_order[ctr++] = b;
+      for(j=first[b+1]-1; j>=first[b]; j--)
+      {
+         stack[sp++] = kids[j];
+      }
+   }
+   assert(ctr == fun->rpo_ctr);
+
+   free(po);
+   free(stack);
+   free(next);
+   free(first);
+   free(kids);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_tracked()
+//
+//   Return true if the liveness analysis tracks the value v.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static inline bool ir_tracked(IRFun_p fun, int v)
+{
+   return !IRIsConst(fun, v) && fun->instrs[v].op != IR_NOP;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_liveness()
+//
+//   Compute the values live into and out of every block of fun
+//   (needs the dominator analysis for the block order).
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void ir_liveness(IRFun_p fun)
+{
+   int           words = (fun->instr_ctr+63)/64;
+   long          size  = (long)fun->block_ctr*words;
+   unsigned long *gen  = IRAlloc((size+1)*sizeof(unsigned long));
+   unsigned long *kill = IRAlloc((size+1)*sizeof(unsigned long));
+   unsigned long *in, *out, val;
+   IRBlock_p     blk, sblk;
+   IRInstr_p     instr;
+   int           i, j, k, b, s, v, w;
+   bool          changed;
+
+   fun->live_words = words;
+   fun->live_in  = IRRealloc(fun->live_in, (size+1)*sizeof(unsigned long));
+   fun->live_out = IRRealloc(fun->live_out, (size+1)*sizeof(unsigned long));
+   memset(fun->live_in, 0, (size+1)*sizeof(unsigned long));
+   memset(fun->live_out, 0, (size+1)*sizeof(unsigned long));
+   memset(gen, 0, (size+1)*sizeof(unsigned long));
+   memset(kill, 0, (size+1)*sizeof(unsigned long));
+
+   /* Upward exposed uses and definitions of every block */
+   for(i=0; i<fun->rpo_ctr; i++)
+   {
+      b   = fun->rpo[i];
+      blk = &fun->blocks[b];
+      for(j=blk->code_ctr-1; j>=0; j--)
+      {
+         v     = blk->code[j];
+         instr = &fun->instrs[v];
+         gen[(long)b*words+v/64]  &= ~(1ul << (v%64));
+         kill[(long)b*words+v/64] |= 1ul << (v%64);
+         if(instr->op == IR_PHI)
+         {
+            continue;
+         }
+         for(k=0; k<instr->argc; k++)
+         {
+            w = instr->args[k];
+            if(ir_tracked(fun, w))
+            {
+               gen[(long)b*words+w/64] |= 1ul << (w%64);
+            }
+         }
+      }
+   }
+
+   /* Backwards to the fixpoint, blocks in postorder */
+   do
+   {
+      changed = false;
+      for(i=fun->rpo_ctr-1; i>=0; i--)
+      {
+         b   = fun->rpo[i];
+         blk = &fun->blocks[b];
+         out = fun->live_out+(long)b*words;
+         in  = fun->live_in+(long)b*words;
+         for(j=0; j<blk->succ_ctr; j++)
+         {
+            s    = blk->succ[j];
+            sblk = &fun->blocks[s];
+            for(w=0; w<words; w++)
+            {
+               out[w] |= fun->live_in[(long)s*words+w];
+            }
+            for(k=0; k<sblk->pred_ctr; k++)
+            {
+               if(sblk->preds[k] != b)
+               {
+                  continue;
+               }
+               for(w=0; w<sblk->code_ctr &&
+                      fun->instrs[sblk->code[w]].op == IR_PHI; w++)
+               {
+                  v = fun->instrs[sblk->code[w]].args[k];
+                  if(ir_tracked(fun, v))
+                  {
+                     out[v/64] |= 1ul << (v%64);
+                  }
+               }
+            }
+         }
+         for(w=0; w<words; w++)
+         {
+            val = gen[(long)b*words+w] | (out[w] & ~kill[(long)b*words+w]);
+            if(val != in[w])
+            {
+               in[w]   = val;
+               changed = true;
+            }
+         }
+      }
+   }while(changed);
+
+   free(gen);
+   free(kill);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_defuse()
+//
+//   Compute the users of every value of fun.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void ir_defuse(IRFun_p fun)
+{
+   int       n = fun->instr_ctr, b, i, j, v;
+   IRBlock_p blk;
+   IRInstr_p instr;
+
+   fun->use_ctr   = IRRealloc(fun->use_ctr, (n+1)*sizeof(int));
+   fun->use_start = IRRealloc(fun->use_start, (n+2)*sizeof(int));
+   memset(fun->use_ctr, 0, (n+1)*sizeof(int));
+   memset(fun->use_start, 0, (n+2)*sizeof(int));
+
+   for(b=0; b<fun->layout_ctr; b++)
+   {
+      blk = &fun->blocks[fun->layout[b]];
+      for(i=0; i<blk->code_ctr; i++)
+      {
+         instr = &fun->instrs[blk->code[i]];
+         for(j=0; j<instr->argc; j++)
+         {
+            fun->use_ctr[instr->args[j]]++;
+            fun->use_start[instr->args[j]+2]++;
+         }
+      }
+   }
+   for(v=0; v<n; v++)
+   {
+      fun->use_start[v+2] += fun->use_start[v+1];
+   }
+   fun->uses = IRRealloc(fun->uses, (fun->use_start[n+1]+1)*sizeof(int));
+   for(b=0; b<fun->layout_ctr; b++)
+   {
+      blk = &fun->blocks[fun->layout[b]];
+      for(i=0; i<blk->code_ctr; i++)
+      {
+         instr = &fun->instrs[blk->code[i]];
+         for(j=0; j<instr->argc; j++)
+         {
+            fun->uses[fun->use_start[instr->args[j]+1]++] = blk->code[i];
+         }
+      }
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_same()
+//
+//   Return true if the values a and b are known to be equal (the
+//   same value, or equal constants).
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static bool ir_same(IRFun_p fun, int a, int b)
+{
+   IRInstr_p x = &fun->instrs[a], y = &fun->instrs[b];
+
+   if(a == b)
+   {
+      return true;
+   }
+   if(x->op != y->op || x->type != y->type)
+   {
+      return false;
+   }
+   return (x->op == IR_CONST && x->k == y->k) ||
+      (x->op == IR_STR && x->str == y->str);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_is_k()
+//
+//   Return true if the value v is the Integer constant k.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static inline bool ir_is_k(IRFun_p fun, int v, long k)
+{
+   return fun->instrs[v].op == IR_CONST && fun->instrs[v].k == k;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_resolve()
+//
+//   Follow the replacements in fwd from v to its final value.
+//
+// Global Variables: -
+//
+// Side Effects    : Compresses paths in fwd
+//
+/----------------------------------------------------------------------*/
+
+static int ir_resolve(int* fwd, int v)
+{
+   int res = v, next;
+
+   while(fwd[res] >= 0)
+   {
+      res = fwd[res];
+   }
+   while(fwd[v] >= 0)
+   {
+      next   = fwd[v];
+      fwd[v] = res;
+      v      = next;
+   }
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_decide()
+//
+//   Return the outcome of a rel b for known operands (1 or 0), or -1.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static int ir_decide(IRFun_p fun, IRRel rel, int a, int b)
+{
+   long x, y;
+
+   if(ir_same(fun, a, b))
+   {
+      x = y = 0;
+   }
+   else if(fun->instrs[a].op == IR_CONST && fun->instrs[b].op == IR_CONST)
+   {
+      x = fun->instrs[a].k;
+      y = fun->instrs[b].k;
+   }
+   else
+   {
+      return -1;
+   }
+   switch(rel)
+   {
+   case IR_EQ:
+         return x == y;
+   case IR_NE:
+         return x != y;
+   case IR_LT:
+         return x < y;
+   case IR_LE:
+         return x <= y;
+   case IR_GT:
+         return x > y;
+   default:
+         return x >= y;
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_fold()
+//
+//   Simplify the instruction v (operands already resolved). Return
+//   the value replacing it, v itself if it became a constant or
+//   another instruction, or -1 if nothing changed. Arithmetic wraps
+//   around as in nanort.h, divisions by 0 are left for run time.
+//
+// Global Variables: -
+//
+// Side Effects    : Changes v
+//
+/----------------------------------------------------------------------*/
+
+static int ir_fold(IRFun_p fun, int v)
+{
+   IRInstr_p instr = &fun->instrs[v];
+   IRBlock_p blk;
+   int       a = instr->argc > 0? instr->args[0] : -1;
+   int       b = instr->argc > 1? instr->args[1] : -1;
+   int       i, same, taken, other;
+   bool      ka, kb;
+   long      x = 0, y = 0;
+
+   ka = a >= 0 && fun->instrs[a].op == IR_CONST;
+   kb = b >= 0 && fun->instrs[b].op == IR_CONST;
+   if(ka)
+   {
+      x = fun->instrs[a].k;
+   }
+   if(kb)
+   {
+      y = fun->instrs[b].k;
+   }
+
+   switch(instr->op)
+   {
+   case IR_PHI:
+         same = -1;
+         for(i=0; i<instr->argc; i++)
+         {
+            if(instr->args[i] == v || (same >= 0 &&
+                                       ir_same(fun, instr->args[i], same)))
+            {
+               continue;
+            }
+            if(same >= 0)
+            {
+               return -1;
+            }
+            same = instr->args[i];
+         }
+         return same >= 0? same : IRConst(fun, instr->type, 0);
+   case IR_ADD:
+         if(ka && kb)
+         {
+            IRMakeConst(fun, v, NanoAdd(x, y));
+            return v;
+         }
+         return ka && x == 0? b : kb && y == 0? a : -1;
+   case IR_SUB:
+         if(ka && kb)
+         {
+            IRMakeConst(fun, v, NanoSub(x, y));
+            return v;
+         }
+         if(a == b)
+         {
+            IRMakeConst(fun, v, 0);
+            return v;
+         }
+         return kb && y == 0? a : -1;
+   case IR_MUL:
+         if((ka && kb) || (ka && x == 0) || (kb && y == 0))
+         {
+            IRMakeConst(fun, v, NanoMul(x, y));
+            return v;
+         }
+         return ka && x == 1? b : kb && y == 1? a : -1;
+   case IR_DIV:
+         if(ka && kb && y != 0)
+         {
+            IRMakeConst(fun, v, NanoDiv(x, y));
+            return v;
+         }
+         return kb && y == 1? a : -1;
+   case IR_NEG:
+         if(ka)
+         {
+            IRMakeConst(fun, v, NanoNeg(x));
+            return v;
+         }
+         return -1;
+   case IR_SCMP:
+         if(ir_same(fun, a, b))
+         {
+            IRMakeConst(fun, v, 0);
+            return v;
+         }
+         if(IRIsConst(fun, a) && IRIsConst(fun, b))
+         {
+            IRMakeConst(fun, v, NanoStrCmp(fun->instrs[a].op == IR_STR?
+                                           fun->instrs[a].str : NULL,
+                                           fun->instrs[b].op == IR_STR?
+                                           fun->instrs[b].str : NULL));
+            return v;
+         }
+         return -1;
+   case IR_BR:
+         taken = ir_decide(fun, instr->k, a, b);
+         if(taken < 0)
+         {
+            return -1;
+         }
+         /* Drop the edge that is never taken */
+         blk   = &fun->blocks[instr->block];
+         other = blk->succ[taken? 1 : 0];
+         for(i=0; fun->blocks[other].preds[i] != instr->block; i++)
+         {
+         }
+         IRRemovePred(fun, other, i);
+         blk->succ[0]  = blk->succ[taken? 0 : 1];
+         blk->succ_ctr = 1;
+         instr->op     = IR_JMP;
+         instr->argc   = 0;
+         return v;
+   default:
+         return -1;
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_simplify()
+//
+//   Simplification pass (see irpass.h). Replaced values are recorded
+//   in a forwarding table and the operands rewritten through it.
+//
+// Global Variables: -
+//
+// Side Effects    : Changes fun
+//
+/----------------------------------------------------------------------*/
+
+static long ir_simplify(IRFun_p fun)
+{
+   int       *fwd;
+   int       b, i, j, v, res, n;
+   long      changes = 0;
+   bool      changed, cfg = false;
+   IRBlock_p blk;
+   IRInstr_p instr;
+
+   n   = fun->instr_ctr;
+   fwd = IRAlloc((n+1)*sizeof(int));
+   for(v=0; v<n; v++)
+   {
+      fwd[v] = -1;
+   }
+   do
+   {
+      changed = false;
+      for(b=0; b<fun->layout_ctr; b++)
+      {
+         blk = &fun->blocks[fun->layout[b]];
+         for(i=0; i<blk->code_ctr; i++)
+         {
+            v     = blk->code[i];
+            instr = &fun->instrs[v];
+            if(instr->op == IR_NOP || IRIsConst(fun, v))
+            {
+               continue;
+            }
+            for(j=0; j<instr->argc; j++)
+            {
+               instr->args[j] = ir_resolve(fwd, instr->args[j]);
+            }
+            res = ir_fold(fun, v);
+            instr = &fun->instrs[v];   /* IRConst() may move it */
+            if(res < 0)
+            {
+               continue;
+            }
+            changes++;
+            changed = true;
+            if(instr->op == IR_JMP)
+            {
+               cfg = true;
+            }
+            else if(res != v)
+            {
+               /* Replaced - the new value has no entry yet */
+               if(res >= n)
+               {
+                  fwd = IRRealloc(fwd, (fun->instr_ctr+1)*sizeof(int));
+                  for(; n<fun->instr_ctr; n++)
+                  {
+                     fwd[n] = -1;
+                  }
+               }
+               fwd[v]    = res;
+               instr->op = IR_NOP;
+            }
+         }
+      }
+   }while(changed);
+
+   /* Rewrite the rest */
+   for(b=0; b<fun->layout_ctr; b++)
+   {
+      blk = &fun->blocks[fun->layout[b]];
+      for(i=0; i<blk->code_ctr; i++)
+      {
+         instr = &fun->instrs[blk->code[i]];
+         for(j=0; j<instr->argc; j++)
+         {
+            instr->args[j] = ir_resolve(fwd, instr->args[j]);
+         }
+      }
+   }
+   free(fwd);
+   if(cfg)
+   {
+      IRRemoveUnreachable(fun);
+   }
+   IRCompact(fun);
+
+   return changes;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_dce()
+//
+//   Dead code elimination: mark the instructions with an effect and
+//   everything they use, remove the rest.
+//
+// Global Variables: -
+//
+// Side Effects    : Changes fun
+//
+/----------------------------------------------------------------------*/
+
+static long ir_dce(IRFun_p fun)
+{
+   bool      *mark  = IRAlloc((fun->instr_ctr+1)*sizeof(bool));
+   int       *stack = IRAlloc((fun->instr_ctr+1)*sizeof(int));
+   int       sp = 0, b, i, v, w;
+   long      res = 0;
+   IRBlock_p blk;
+   IRInstr_p instr;
+
+   memset(mark, 0, (fun->instr_ctr+1)*sizeof(bool));
+   for(b=0; b<fun->layout_ctr; b++)
+   {
+      blk = &fun->blocks[fun->layout[b]];
+      for(i=0; i<blk->code_ctr; i++)
+      {
+         if(IRHasEffect(fun, blk->code[i]))
+         {
+            mark[blk->code[i]] = true;
+            stack[sp++] = blk->code[i];
+         }
+      }
+   }
+   while(sp)
+   {
+      instr = &fun->instrs[stack[--sp]];
+      for(i=0; i<instr->argc; i++)
+      {
+         w = instr->args[i];
+         if(!mark[w])
+         {
+            mark[w] = true;
+            stack[sp++] = w;
+         }
+      }
+   }
+   for(b=0; b<fun->layout_ctr; b++)
+   {
+      blk = &fun->blocks[fun->layout[b]];
+      for(i=0; i<blk->code_ctr; i++)
+      {
+         v = blk->code[i];
+         if(!mark[v])
+         {
+            fun->instrs[v].op = IR_NOP;
+            res++;
+         }
+      }
+   }
+   free(mark);
+   free(stack);
+   IRCompact(fun);
+
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_dominates()
+//
+//   Return true if block a dominates block b (needs the dominator
+//   analysis).
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static bool ir_dominates(IRFun_p fun, int a, int b)
+{
+   while(b >= 0 && b != a)
+   {
+      b = fun->idom[b];
+   }
+   return b == a;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_loop()
+//
+//   If block h is the header of a natural loop, flag the blocks of
+//   the loop in in_loop (those that reach a back edge to h without
+//   passing h) and return its preheader: the only block outside the
+//   loop that jumps to h, and only there. Return -1 if h is no loop
+//   header or the loop has no preheader. Needs the dominator
+//   analysis, stack has room for all blocks.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static int ir_loop(IRFun_p fun, int h, bool* in_loop, int* stack)
+{
+   IRBlock_p hblk = &fun->blocks[h], blk;
+   int       sp = 0, pre = -1, i;
+   bool      latch = false;
+
+   memset(in_loop, 0, (fun->block_ctr+1)*sizeof(bool));
+   in_loop[h] = true;
+   for(i=0; i<hblk->pred_ctr; i++)
+   {
+      if(ir_dominates(fun, h, hblk->preds[i]))
+      {
+         latch = true;
+         if(!in_loop[hblk->preds[i]])
+         {
+            in_loop[hblk->preds[i]] = true;
+            stack[sp++] = hblk->preds[i];
+         }
+      }
+   }
+   if(!latch)
+   {
+      return -1;
+   }
+   while(sp)
+   {
+      blk = &fun->blocks[stack[--sp]];
+      for(i=0; i<blk->pred_ctr; i++)
+      {
+         if(!in_loop[blk->preds[i]])
+         {
+            in_loop[blk->preds[i]] = true;
+            stack[sp++] = blk->preds[i];
+         }
+      }
+   }
+   for(i=0; i<hblk->pred_ctr; i++)
+   {
+      if(!in_loop[hblk->preds[i]])
+      {
+         if(pre >= 0)
+         {
+            return -1;
+         }
+         pre = hblk->preds[i];
+      }
+   }
+   if(pre < 0 || fun->blocks[pre].succ_ctr != 1)
+   {
+      return -1;
+   }
+   return pre;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_invariant()
+//
+//   Return true if the value v computed in a loop (the blocks flagged
+//   in in_loop) can be computed once in front of it: it is pure,
+//   cannot fail, and all operands are computed outside of the
+//   loop. Global variables are only read if the loop does not write
+//   them (globals is true).
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static bool ir_invariant(IRFun_p fun, int v, bool* in_loop, bool globals)
+{
+   IRInstr_p instr = &fun->instrs[v];
+   IRFun_p   callee;
+   int       i, w;
+
+   switch(instr->op)
+   {
+   case IR_ADD:
+   case IR_SUB:
+   case IR_MUL:
+   case IR_NEG:
+   case IR_SCMP:
+         break;
+   case IR_DIV:
+         if(!IRIsConst(fun, instr->args[1]) ||
+            fun->instrs[instr->args[1]].k == 0)
+         {
+            return false;
+         }
+         break;
+   case IR_GETG:
+         if(!globals)
+         {
+            return false;
+         }
+         break;
+   case IR_CALL:
+         callee = fun->prog->funs[instr->k];
+         if(!callee || !callee->pure)
+         {
+            return false;
+         }
+         break;
+   default:
+         return false;
+   }
+   for(i=0; i<instr->argc; i++)
+   {
+      w = instr->args[i];
+      if(!IRIsConst(fun, w) && in_loop[fun->instrs[w].block])
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_licm()
+//
+//   Loop invariant code motion: move the invariant values of every
+//   loop (see ir_invariant()) to the end of its preheader. Inner
+//   loops come first, so that their invariants can move on through
+//   the enclosing loops.
+//
+//   The moved values are computed even if the loop body never runs,
+//   which is why they must be pure and unable to fail.
+//
+// Global Variables: -
+//
+// Side Effects    : Changes fun
+//
+/----------------------------------------------------------------------*/
+
+static long ir_licm(IRFun_p fun)
+{
+   bool      *in_loop = IRAlloc((fun->block_ctr+1)*sizeof(bool));
+   int       *stack   = IRAlloc((fun->block_ctr+1)*sizeof(int));
+   int       h, pre, b, x, i, j, v, pos;
+   long      res = 0;
+   bool      globals, changed;
+   IRBlock_p blk;
+   IRInstr_p instr;
+
+   IRRequire(fun, IR_DOMINATORS);
+   /* Headers in reverse postorder come after the enclosing ones */
+   for(pos=fun->rpo_ctr-1; pos>=0; pos--)
+   {
+      h = fun->rpo[pos];
+      if((pre = ir_loop(fun, h, in_loop, stack)) < 0)
+      {
+         continue;
+      }
+
+      /* Does the loop change global variables? */
+      globals = true;
+      for(i=0; i<fun->rpo_ctr && globals; i++)
+      {
+         blk = &fun->blocks[fun->rpo[i]];
+         for(j=0; in_loop[fun->rpo[i]] && j<blk->code_ctr; j++)
+         {
+            instr = &fun->instrs[blk->code[j]];
+            if(instr->op == IR_SETG ||
+               (instr->op == IR_CALL &&
+                (!fun->prog->funs[instr->k] ||
+                 !fun->prog->funs[instr->k]->pure)))
+            {
+               globals = false;
+               break;
+            }
+         }
+      }
+
+      /* Move values until nothing more moves (in reverse postorder
+         operands mostly come first) */
+      do
+      {
+         changed = false;
+         for(i=0; i<fun->rpo_ctr; i++)
+         {
+            b = fun->rpo[i];
+            if(!in_loop[b])
+            {
+               continue;
+            }
+            blk = &fun->blocks[b];
+            for(j=0; j<blk->code_ctr; j++)
+            {
+               v = blk->code[j];
+               if(fun->instrs[v].block == b &&
+                  ir_invariant(fun, v, in_loop, globals))
+               {
+                  IRInsertBefore(fun, v, IRTerminator(fun, pre));
+                  changed = true;
+                  res++;
+               }
+            }
+         }
+      }while(changed);
+
+      /* Drop the moved values from the loop blocks */
+      for(i=0; i<fun->rpo_ctr; i++)
+      {
+         b = fun->rpo[i];
+         if(!in_loop[b])
+         {
+            continue;
+         }
+         blk = &fun->blocks[b];
+         for(j=0, x=0; j<blk->code_ctr; j++)
+         {
+            if(fun->instrs[blk->code[j]].block == b)
+            {
+               blk->code[x++] = blk->code[j];
+            }
+         }
+         blk->code_ctr = x;
+      }
+   }
+   free(in_loop);
+   free(stack);
+
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_induction()
+//
+//   Return true if the phi v in a loop header is a basic induction
+//   variable: the operand from the latch (operand number latch) is v
+//   plus or minus a constant. Store that operand in iv.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static bool ir_induction(IRFun_p fun, int v, int latch, IRIV_p iv)
+{
+   IRInstr_p instr = &fun->instrs[v], next;
+   int       a, b;
+
+   if(instr->op != IR_PHI || instr->argc != 2)
+   {
+      return false;
+   }
+   iv->phi  = v;
+   iv->next = instr->args[latch];
+   iv->init = instr->args[1-latch];
+   next     = &fun->instrs[iv->next];
+   if(next->op != IR_ADD && next->op != IR_SUB)
+   {
+      return false;
+   }
+   a = next->args[0];
+   b = next->args[1];
+   if(a == v && fun->instrs[b].op == IR_CONST)
+   {
+      iv->step = fun->instrs[b].k;
+      if(next->op == IR_SUB)
+      {
+         if(iv->step == LONG_MIN)
+         {
+            return false;
+         }
+         iv->step = -iv->step;
+      }
+   }
+   else if(b == v && next->op == IR_ADD && fun->instrs[a].op == IR_CONST)
+   {
+      iv->step = fun->instrs[a].k;
+   }
+   else
+   {
+      return false;
+   }
+   return iv->step != 0;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_trips()
+//
+//   Compute the number of iterations of the loop with header h (the
+//   blocks flagged in in_loop), if its exit test compares a basic
+//   induction variable with a constant start value to a constant
+//   bound, and the variable does not wrap around. A return can still
+//   leave the loop earlier. Return the number, or -1 if it is
+//   unknown. Store the induction variable in iv, the operand of
+//   the test it is in in *pos.
+//
+// Global Variables: ir_rel_neg, ir_rel_swap
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static long ir_trips(IRFun_p fun, int h, int latch, bool* in_loop,
+                     IRIV_p iv, int* pos)
+{
+   IRBlock_p blk  = &fun->blocks[h];
+   IRInstr_p test = &fun->instrs[IRTerminator(fun, h)];
+   IRRel     rel;
+   __int128  x, bound, step, trips, last;
+   int       sign;
+
+   iv->phi = -1;
+   *pos    = 0;
+   if(test->op != IR_BR || in_loop[blk->succ[0]] == in_loop[blk->succ[1]])
+   {
+      return -1;
+   }
+   /* Relation under which the loop goes on, variable on the left */
+   rel = in_loop[blk->succ[0]]? test->k : ir_rel_neg[test->k];
+   if(fun->instrs[test->args[0]].op == IR_CONST)
+   {
+      rel  = ir_rel_swap[rel];
+      *pos = 1;
+   }
+   if(fun->instrs[test->args[1-*pos]].op != IR_CONST ||
+      fun->instrs[test->args[*pos]].block != h ||
+      !ir_induction(fun, test->args[*pos], latch, iv) ||
+      fun->instrs[iv->init].op != IR_CONST)
+   {
+      return -1;
+   }
+   x     = fun->instrs[iv->init].k;
+   bound = fun->instrs[test->args[1-*pos]].k;
+   step  = iv->step;
+
+   /* Count upwards */
+   sign = 1;
+   if(step < 0)
+   {
+      sign  = -1;
+      x     = -x;
+      bound = -bound;
+      step  = -step;
+      rel   = ir_rel_swap[rel];
+   }
+   switch(rel)
+   {
+   case IR_LT:
+         trips = x < bound? (bound-x+step-1)/step : 0;
+         break;
+   case IR_LE:
+         trips = x <= bound? (bound-x)/step+1 : 0;
+         break;
+   case IR_EQ:
+         trips = x == bound;
+         break;
+   case IR_NE:
+         if(x > bound || (bound-x)%step)
+         {
+            return -1;
+         }
+         trips = (bound-x)/step;
+         break;
+   default:
+         /* Runs until the variable wraps around, unless never */
+         if(rel == IR_GT? x > bound : x >= bound)
+         {
+            return -1;
+         }
+         trips = 0;
+         break;
+   }
+   last = sign*(x+trips*step);
+   if(trips > LONG_MAX || last < LONG_MIN || last > LONG_MAX)
+   {
+      return -1;
+   }
+   return trips;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_only_used_by()
+//
+//   Return true if all remaining users of v (from the def-use
+//   analysis, instructions removed since are skipped) are a or b.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static bool ir_only_used_by(IRFun_p fun, int v, int a, int b)
+{
+   int i, u;
+
+   for(i=fun->use_start[v]; i<fun->use_start[v+1]; i++)
+   {
+      u = fun->uses[i];
+      if(u != a && u != b && fun->instrs[u].op != IR_NOP)
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_reduce()
+//
+//   Strength reduction of the product v of the induction variable iv
+//   (of the loop with header h and preheader pre) and a loop invariant
+//   factor: a new induction variable steps by the factor times the
+//   step of iv and replaces v. Return the new variable. The def-use
+//   analysis is recomputed to cover the new instructions.
+//
+// Global Variables: -
+//
+// Side Effects    : Changes fun, memory operations
+//
+/----------------------------------------------------------------------*/
+
+static int ir_reduce(IRFun_p fun, int v, int h, int pre, int latch,
+                     IRIV_p iv)
+{
+   IRInstr_p instr = &fun->instrs[v];
+   IRBlock_p blk;
+   int       factor, start, inc, phi, next, i, u;
+
+   factor = instr->args[instr->args[0] == iv->phi? 1 : 0];
+   if(fun->instrs[factor].op == IR_CONST &&
+      fun->instrs[iv->init].op == IR_CONST)
+   {
+      start = IRConst(fun, T_Integer, NanoMul(fun->instrs[iv->init].k,
+                                              fun->instrs[factor].k));
+   }
+   else
+   {
+      start = IRNewInstr(fun, IR_MUL, T_Integer, 0);
+      IRAddArg(fun, start, iv->init);
+      IRAddArg(fun, start, factor);
+      IRInsertBefore(fun, start, IRTerminator(fun, pre));
+   }
+   if(fun->instrs[factor].op == IR_CONST)
+   {
+      inc = IRConst(fun, T_Integer, NanoMul(fun->instrs[factor].k,
+                                            iv->step));
+   }
+   else
+   {
+      inc = IRNewInstr(fun, IR_MUL, T_Integer, 0);
+      IRAddArg(fun, inc, factor);
+      IRAddArg(fun, inc, IRConst(fun, T_Integer, iv->step));
+      IRInsertBefore(fun, inc, IRTerminator(fun, pre));
+   }
+
+   /* The new phi goes first, its update behind the old one */
+   phi  = IRNewInstr(fun, IR_PHI, T_Integer, 0);
+   next = IRNewInstr(fun, IR_ADD, T_Integer, 0);
+   IRAddArg(fun, phi, latch? start : next);
+   IRAddArg(fun, phi, latch? next : start);
+   IRAddArg(fun, next, phi);
+   IRAddArg(fun, next, inc);
+   IRInsertBefore(fun, phi, fun->blocks[h].code[0]);
+   blk = &fun->blocks[fun->instrs[iv->next].block];
+   for(i=0; blk->code[i] != iv->next; i++)
+   {
+   }
+   IRInsertBefore(fun, next, blk->code[i+1]);
+
+   /* Replace v */
+   for(i=fun->use_start[v]; i<fun->use_start[v+1]; i++)
+   {
+      instr = &fun->instrs[fun->uses[i]];
+      for(u=0; u<instr->argc; u++)
+      {
+         if(instr->args[u] == v)
+         {
+            instr->args[u] = phi;
+         }
+      }
+   }
+   fun->instrs[v].op = IR_NOP;
+
+   /* The new values need users, too (the outer loop may reduce them) */
+   IRInvalidate(fun, IR_DEFUSE);
+   IRRequire(fun, IR_DEFUSE);
+
+   return phi;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_ivsr()
+//
+//   Induction variable analysis and strength reduction: record the
+//   number of iterations of every loop in its header (see
+//   ir_trips()), and replace products of basic induction variables
+//   and loop invariants by new induction variables (see
+//   ir_reduce()). If the exit test is the only other use of the old
+//   variable, the number of iterations is known and the factor is a
+//   positive constant, the test is rewritten to the new variable, and
+//   the old one is left to dead code elimination. Strength reduction
+//   is skipped if the program is not flagged for it (a back end that
+//   keeps every variable in memory pays for a new induction variable
+//   with a store and reload in every iteration, more than the
+//   multiplication costs).
+//
+// Global Variables: -
+//
+// Side Effects    : Changes fun
+//
+/----------------------------------------------------------------------*/
+
+static long ir_ivsr(IRFun_p fun)
+{
+   bool        *in_loop = IRAlloc((fun->block_ctr+1)*sizeof(bool));
+   int         *stack   = IRAlloc((fun->block_ctr+1)*sizeof(int));
+   IRIVCell    ivs[IR_MAX_IVS], test_iv;
+   IRBlock_p   blk;
+   IRInstr_p   instr, test;
+   int         h, pre, latch, iv_ctr, b, i, j, k, v, w, pos, phi, f, c;
+   long        res = 0, trips, factor, bound;
+   __int128    lo, hi;
+
+   IRRequire(fun, IR_DOMINATORS|IR_DEFUSE);
+   for(b=0; b<fun->block_ctr; b++)
+   {
+      fun->blocks[b].trips = -1;
+   }
+   for(pos=fun->rpo_ctr-1; pos>=0; pos--)
+   {
+      h = fun->rpo[pos];
+      if((pre = ir_loop(fun, h, in_loop, stack)) < 0 ||
+         fun->blocks[h].pred_ctr != 2)
+      {
+         continue;
+      }
+      latch = fun->blocks[h].preds[0] == pre? 1 : 0;
+      trips = ir_trips(fun, h, latch, in_loop, &test_iv, &k);
+
+      /* Basic induction variables */
+      iv_ctr = 0;
+      blk = &fun->blocks[h];
+      for(i=0; i<blk->code_ctr && iv_ctr<IR_MAX_IVS; i++)
+      {
+         if(ir_induction(fun, blk->code[i], latch, &ivs[iv_ctr]))
+         {
+            iv_ctr++;
+         }
+      }
+
+      /* Products in the loop */
+      for(i=0; i<fun->rpo_ctr && iv_ctr && fun->prog->reduce; i++)
+      {
+         b = fun->rpo[i];
+         if(!in_loop[b])
+         {
+            continue;
+         }
+         for(j=0; j<fun->blocks[b].code_ctr; j++)
+         {
+            v     = fun->blocks[b].code[j];
+            instr = &fun->instrs[v];
+            if(instr->op != IR_MUL)
+            {
+               continue;
+            }
+            for(w=0; w<iv_ctr; w++)
+            {
+               if(instr->args[0] == ivs[w].phi ||
+                  instr->args[1] == ivs[w].phi)
+               {
+                  break;
+               }
+            }
+            if(w == iv_ctr)
+            {
+               continue;
+            }
+            f = instr->args[instr->args[0] == ivs[w].phi? 1 : 0];
+            if(!IRIsConst(fun, f) && in_loop[fun->instrs[f].block])
+            {
+               continue;
+            }
+            factor = fun->instrs[f].op == IR_CONST? fun->instrs[f].k : 0;
+            phi = ir_reduce(fun, v, h, pre, latch, &ivs[w]);
+            res++;
+
+            /* Linear function test replacement */
+            test = &fun->instrs[IRTerminator(fun, h)];
+            if(trips < 0 || factor <= 0 || test_iv.phi != ivs[w].phi ||
+               !ir_only_used_by(fun, ivs[w].phi, ivs[w].next,
+                                IRTerminator(fun, h)) ||
+               !ir_only_used_by(fun, ivs[w].next, ivs[w].phi, -1))
+            {
+               continue;
+            }
+            bound = fun->instrs[test->args[1-k]].k;
+            lo    = (__int128)fun->instrs[ivs[w].init].k*factor;
+            hi    = ((__int128)fun->instrs[ivs[w].init].k +
+                     (__int128)trips*ivs[w].step)*factor;
+            if(lo < LONG_MIN || lo > LONG_MAX || hi < LONG_MIN ||
+               hi > LONG_MAX || (__int128)bound*factor < LONG_MIN ||
+               (__int128)bound*factor > LONG_MAX)
+            {
+               continue;
+            }
+            c    = IRConst(fun, T_Integer, bound*factor);
+            test = &fun->instrs[IRTerminator(fun, h)];
+            test->args[k]   = phi;
+            test->args[1-k] = c;
+            test_iv.phi     = phi;
+         }
+      }
+      fun->blocks[h].trips = trips;
+   }
+   free(in_loop);
+   free(stack);
+   IRCompact(fun);
+
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ir_find_pure()
+//
+//   Flag the functions of prog that always return a value without any
+//   other effect: they neither print nor access global variables,
+//   contain no loops, divide only by nonzero constants and call only
+//   such functions (which excludes recursion). A call to them can be
+//   computed earlier, or not at all.
+//
+// Global Variables: -
+//
+// Side Effects    : Changes prog
+//
+/----------------------------------------------------------------------*/
+
+static void ir_find_pure(IRProg_p prog)
+{
+   int       *order = NULL;
+   IRFun_p   fun, callee;
+   IRBlock_p blk;
+   IRInstr_p instr;
+   long      f;
+   int       i, j, size = 0;
+   bool      changed, pure;
+
+   for(f=0; f<prog->global_ctr; f++)
+   {
+      if(prog->funs[f])
+      {
+         prog->funs[f]->pure = false;
+      }
+   }
+   do
+   {
+      changed = false;
+      for(f=0; f<prog->global_ctr; f++)
+      {
+         if(!(fun = prog->funs[f]) || fun->pure)
+         {
+            continue;
+         }
+         IRRequire(fun, IR_DOMINATORS);
+         if(size < fun->block_ctr)
+         {
+            size  = fun->block_ctr;
+            order = IRRealloc(order, (size+1)*sizeof(int));
+         }
+         for(i=0; i<fun->rpo_ctr; i++)
+         {
+            order[fun->rpo[i]] = i;
+         }
+         pure = true;
+         for(i=0; i<fun->rpo_ctr && pure; i++)
+         {
+            blk = &fun->blocks[fun->rpo[i]];
+            /* An edge back in reverse postorder closes a loop */
+            for(j=0; j<blk->succ_ctr; j++)
+            {
+               if(order[blk->succ[j]] <= i)
+               {
+                  pure = false;
+               }
+            }
+            for(j=0; j<blk->code_ctr && pure; j++)
+            {
+               instr = &fun->instrs[blk->code[j]];
+               switch(instr->op)
+               {
+               case IR_GETG:
+               case IR_SETG:
+               case IR_PRINT:
+                     pure = false;
+                     break;
+               case IR_DIV:
+                     pure = IRIsConst(fun, instr->args[1]) &&
+                        fun->instrs[instr->args[1]].k != 0;
+                     break;
+               case IR_CALL:
+                     callee = prog->funs[instr->k];
+                     pure   = callee && callee != fun && callee->pure;
+                     break;
+               default:
+                     break;
+               }
+            }
+         }
+         if(pure)
+         {
+            fun->pure = true;
+            changed   = true;
+         }
+      }
+   }while(changed);
+   free(order);
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                         Exported Functions                          */
+/*---------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------
+//
+// Function: IRRequire()
+// Function: IRInvalidate()
+//
+//   Make sure that the given analyses of fun are up to date, and
+//   mark them as outdated.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+void IRRequire(IRFun_p fun, IRAnalyses analyses)
+{
+   if(analyses & IR_LIVENESS)
+   {
+      analyses |= IR_DOMINATORS;
+   }
+   if((analyses & IR_DOMINATORS) && !(fun->valid & IR_DOMINATORS))
+   {
+      ir_dominators(fun);
+      fun->valid |= IR_DOMINATORS;
+   }
+   if((analyses & IR_LIVENESS) && !(fun->valid & IR_LIVENESS))
+   {
+      ir_liveness(fun);
+      fun->valid |= IR_LIVENESS;
+   }
+   if((analyses & IR_DEFUSE) && !(fun->valid & IR_DEFUSE))
+   {
+      ir_defuse(fun);
+      fun->valid |= IR_DEFUSE;
+   }
+}
+
+void IRInvalidate(IRFun_p fun, IRAnalyses analyses)
+{
+   fun->valid &= ~analyses;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: IRRunPass()
+//
+//   Run pass on fun and drop the analyses it does not preserve if it
+//   changed anything. Return the number of changes.
+//
+// Global Variables: -
+//
+// Side Effects    : Changes fun
+//
+/----------------------------------------------------------------------*/
+
+long IRRunPass(IRFun_p fun, IRPass_p pass)
+{
+   long changes = pass->run(fun);
+
+   if(changes)
+   {
+      IRInvalidate(fun, IR_ALL & ~pass->preserves);
+   }
+   return changes;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: IROptimize()
+//
+//   Run the standard pipeline on all functions of prog, until it
+//   changes nothing (at most IR_MAX_ROUNDS rounds). The pure
+//   functions are determined anew before every round, as the
+//   previous one may have removed what kept a function from being
+//   pure. Count the changes of every pass in stats.
+//
+// Global Variables: ir_pipeline
+//
+// Side Effects    : Changes prog
+//
+/----------------------------------------------------------------------*/
+
+void IROptimize(IRProg_p prog, IRStats_p stats)
+{
+   IRFun_p fun;
+   long    i, n, total;
+   int     round, p;
+
+   for(round=0; round<IR_MAX_ROUNDS; round++)
+   {
+      ir_find_pure(prog);
+      total = 0;
+      for(i=0; i<prog->global_ctr; i++)
+      {
+         if(!(fun = prog->funs[i]))
+         {
+            continue;
+         }
+         for(p=0; ir_pipeline[p].name; p++)
+         {
+            n = IRRunPass(fun, &ir_pipeline[p]);
+            stats->changes[p] += n;
+            total += n;
+         }
+      }
+      if(!total)
+      {
+         break;
+      }
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: IRPrintStats()
+//
+//   Print the changes of all passes of the pipeline.
+//
+// Global Variables: ir_pipeline
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+void IRPrintStats(FILE* out, IRStats_p stats)
+{
+   int p;
+
+   fputs("# IR passes:", out);
+   for(p=0; ir_pipeline[p].name; p++)
+   {
+      fprintf(out, "%s %s %ld", p? "," : "", ir_pipeline[p].name,
+              stats->changes[p]);
+   }
+   fputs(" changes\n", out);
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                        End of File                                  */
+/*---------------------------------------------------------------------*/
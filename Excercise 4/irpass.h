@@ -0,0 +1,108 @@
+/*-----------------------------------------------------------------------
+
+File  : irpass.h
+
+Authors: Konstantin Kläger, Isabel Staaden, Carolin Rösch
+
+Contents
+
+  Pass manager, analyses and transformations on the SSA IR (see
+  ir.h).
+
+  Analyses are computed on demand (IRRequire()) and cached in the
+  function until a pass invalidates them:
+
+    IR_DOMINATORS  Reverse postorder, immediate dominators and a
+                   preorder of the dominator tree (Cooper, Harvey and
+                   Kennedy, "A Simple, Fast Dominance Algorithm").
+    IR_LIVENESS    Values live at the start (behind the phis) and at
+                   the end of every block. Constants are never live,
+                   phi operands are live at the end of the
+                   predecessor they come from.
+    IR_DEFUSE      Number and list of the users of every value.
+
+  A pass reports the number of changes it made. If it changed
+  anything, the manager drops the analyses the pass does not
+  declare as preserved. The standard pipeline is run on all
+  functions until nothing changes any more (at most IR_MAX_ROUNDS
+  times):
+
+    simplify  Constant folding, algebraic identities, removal of
+              trivial phis (all operands equal) and of branches with
+              a constant outcome.
+    licm      Loop invariant code motion: arithmetic on values from
+              outside the loop, reads of global variables the loop
+              does not write and calls of pure functions (no effect,
+              no loops, no recursion) are moved in front of the loop.
+    ivsr      Induction variables: the number of iterations of
+              counting loops with constant bounds is stored in the
+              loop header (IRBlockCell.trips, for the back ends),
+              products of an induction variable and a loop invariant
+              become induction variables of their own (additions
+              instead of multiplications), and the exit test moves
+              over to them where possible.
+    dce       Removal of instructions without effect whose value is
+              not used (also cycles of phis).
+
+  This code is released under the GNU General Public Licence.
+
+Changes
+
+<1> Sun Oct 18 11:02:13 CEST 2026
+    New
+
+-----------------------------------------------------------------------*/
+
+#ifndef IRPASS
+
+#define IRPASS
+
+#include "ir.h"
+
+
+/*---------------------------------------------------------------------*/
+/*                    Data type declarations                           */
+/*---------------------------------------------------------------------*/
+
+#define IR_DOMINATORS  1
+#define IR_LIVENESS    2
+#define IR_DEFUSE      4
+#define IR_ALL         (IR_DOMINATORS|IR_LIVENESS|IR_DEFUSE)
+
+#define IR_MAX_ROUNDS  8
+
+typedef struct irpass
+{
+   char       *name;
+   long       (*run)(IRFun_p fun);  /* Return the number of changes */
+   IRAnalyses preserves;
+}IRPassCell, *IRPass_p;
+
+/* Changes of every pass of the pipeline (for --stats) */
+typedef struct irstats
+{
+   long changes[8];
+}IRStatsCell, *IRStats_p;
+
+
+/*---------------------------------------------------------------------*/
+/*                Exported Functions and Variables                     */
+/*---------------------------------------------------------------------*/
+
+extern IRPassCell ir_pipeline[];
+
+#define IRIsLive(fun, set, b, v) \
+   (((set)[(long)(b)*(fun)->live_words+(v)/64] >> ((v)%64)) & 1)
+
+void IRRequire(IRFun_p fun, IRAnalyses analyses);
+void IRInvalidate(IRFun_p fun, IRAnalyses analyses);
+long IRRunPass(IRFun_p fun, IRPass_p pass);
+void IROptimize(IRProg_p prog, IRStats_p stats);
+void IRPrintStats(FILE* out, IRStats_p stats);
+
+
+#endif
+
+/*---------------------------------------------------------------------*/
+/*                        End of File                                  */
+/*---------------------------------------------------------------------*/
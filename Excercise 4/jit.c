@@ -0,0 +1,884 @@
+/*-----------------------------------------------------------------------
+
+File  : jit.c
+
+Authors: Konstantin Kläger, Isabel Staaden, Carolin Rösch
+
+Contents
+
+  x86-64 code generation for nanoLang bytecode. Code is generated
+  into a growing buffer (all jumps and calls inside it are relative,
+  helpers are called through absolute addresses), then copied into
+  a fresh mapping that is made executable (and no longer writable).
+
+  This code is released under the GNU General Public Licence.
+
+Changes
+
+<1> Sun Oct 18 06:02:41 CEST 2026
+    New
+
+-----------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "jit.h"
+
+
+
+/*---------------------------------------------------------------------*/
+/*                        Global Variables                             */
+/*---------------------------------------------------------------------*/
+
+/* Register numbers (as encoded in ModRM) */
+#define RAX 0
+#define RCX 1
+#define RDX 2
+#define RSI 6
+#define RDI 7
+
+/* Second opcode byte of jcc rel32 for jeq ... jge */
+static unsigned char jit_jcc[] = {0x84, 0x85, 0x8c, 0x8e, 0x8f, 0x8d};
+
+/* A rel32 field waiting for its destination: a bytecode position
+   (jumps) or a global position (calls) */
+typedef struct jitfix
+{
+   long at;
+   long target;
+   bool call;
+}JITFixCell, *JITFix_p;
+
+/* Code buffer and bookkeeping during compilation */
+typedef struct jitbuf
+{
+   unsigned char *code;
+   long          ctr;
+   long          size;
+   long          *native;    /* Native offset of every bytecode position */
+   bool          *label;     /* Jump targets */
+   long          rax_slot;   /* Slot whose value is in rax, or -1 */
+   JITFix_p      fixes;
+   long          fix_ctr;
+   long          fix_size;
+}JITBufCell, *JITBuf_p;
+
+/* Entry code: NanoInt entry(fp, stack_end, native_limit, fun,
+   native_top) saves the callee saved registers, switches to the
+   native stack and calls fun(fp) */
+static unsigned char jit_trampoline[] =
+{
+   0x53,                   /* push rbx */
+   0x41, 0x54,             /* push r12 */
+   0x41, 0x55,             /* push r13 */
+   0x55,                   /* push rbp */
+   0x48, 0x89, 0xe5,       /* mov  rbp, rsp */
+   0x4c, 0x89, 0xc4,       /* mov  rsp, r8 */
+   0x49, 0x89, 0xf4,       /* mov  r12, rsi */
+   0x49, 0x89, 0xd5,       /* mov  r13, rdx */
+   0xff, 0xd1,             /* call rcx */
+   0x48, 0x89, 0xec,       /* mov  rsp, rbp */
+   0x5d,                   /* pop  rbp */
+   0x41, 0x5d,             /* pop  r13 */
+   0x41, 0x5c,             /* pop  r12 */
+   0x5b,                   /* pop  rbx */
+   0xc3                    /* ret */
+};
+
+typedef NanoInt (*JITEntry)(NanoValue* fp, NanoValue* stack_end,
+                            void* native_limit, void* fun,
+                            void* native_top);
+
+
+/*---------------------------------------------------------------------*/
+/*                      Forward Declarations                           */
+/*---------------------------------------------------------------------*/
+
+
+/*---------------------------------------------------------------------*/
+/*                         Internal Functions                          */
+/*---------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------
+//
+// Function: jit_stack_overflow()
+//
+//   Called from generated code if a frame does not fit.
+//
+// Global Variables: -
+//
+// Side Effects    : Terminates the program
+//
+/----------------------------------------------------------------------*/
+
+static void jit_stack_overflow(void)
+{
+   NanoRuntimeError("stack overflow");
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: jit_byte()
+//
+//   Append one byte to the code.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void jit_byte(JITBuf_p b, int byte)
+{
+   if(b->ctr == b->size)
+   {
+      b->size = b->size? 2*b->size : 4096;
+      b->code = realloc(b->code, b->size);
+      if(!b->code)
+      {
+         fprintf(stderr, "Out of memory in JIT compiler!\n");
+         exit(EXIT_FAILURE);
+      }
+   }
+   b->code[b->ctr++] = byte;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: jit_int()
+//
+//   Append a little endian integer of len bytes.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void jit_int(JITBuf_p b, long val, int len)
+{
+   int i;
+
+   for(i=0; i<len; i++)
+   {
+      jit_byte(b, (unsigned long)val >> (8*i));
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: jit_patch()
+//
+//   Let the rel32 field at offset at point to offset dest.
+//
+// Global Variables: -
+//
+// Side Effects    : Changes the code
+//
+/----------------------------------------------------------------------*/
+
+static void jit_patch(JITBuf_p b, long at, long dest)
+{
+   int32_t rel = dest-(at+4);
+
+   memcpy(b->code+at, &rel, 4);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: jit_fixup()
+//
+//   Append a rel32 field to be resolved later.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void jit_fixup(JITBuf_p b, long target, bool call)
+{
+   if(b->fix_ctr == b->fix_size)
+   {
+      b->fix_size = b->fix_size? 2*b->fix_size : 256;
+      b->fixes = realloc(b->fixes, b->fix_size*sizeof(JITFixCell));
+      if(!b->fixes)
+      {
+         fprintf(stderr, "Out of memory in JIT compiler!\n");
+         exit(EXIT_FAILURE);
+      }
+   }
+   b->fixes[b->fix_ctr].at     = b->ctr;
+   b->fixes[b->fix_ctr].target = target;
+   b->fixes[b->fix_ctr].call   = call;
+   b->fix_ctr++;
+   jit_int(b, 0, 4);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: jit_rm()
+//
+//   Emit a 64 bit instruction opcode (one or two bytes) with register
+//   reg and the memory operand frame slot slot, i.e. [rbx+8*slot].
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void jit_rm(JITBuf_p b, int opcode, int reg, long slot)
+{
+   long disp = slot*sizeof(NanoValue);
+
+   jit_byte(b, 0x48);
+   if(opcode > 0xff)
+   {
+      jit_byte(b, opcode >> 8);
+   }
+   jit_byte(b, opcode & 0xff);
+   if(disp == (int8_t)disp)
+   {
+      jit_byte(b, 0x43 | reg << 3);
+      jit_int(b, disp, 1);
+   }
+   else
+   {
+      jit_byte(b, 0x83 | reg << 3);
+      jit_int(b, disp, 4);
+   }
+}
+
+#define jit_load(b, reg, slot)  jit_rm((b), 0x8b, (reg), (slot))
+#define jit_store(b, slot, reg) jit_rm((b), 0x89, (reg), (slot))
+
+/* Load rax unless it already holds the slot */
+#define jit_load_rax(b, cached, slot) \
+   ((cached) != (slot)? jit_load((b), RAX, (slot)) : (void)0)
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: jit_imm64()
+//
+//   Emit mov reg, val.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void jit_imm64(JITBuf_p b, int reg, long val)
+{
+   jit_byte(b, 0x48);
+   jit_byte(b, 0xb8+reg);
+   jit_int(b, val, 8);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: jit_call_helper()
+//
+//   Emit a call of a C function (arguments are already in place).
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void jit_call_helper(JITBuf_p b, void* fun)
+{
+   jit_imm64(b, RAX, (long)fun);
+   jit_byte(b, 0xff);   /* call rax */
+   jit_byte(b, 0xd0);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: jit_rax_k()
+//
+//   Emit the ALU operation rax = rax op k for add, sub and cmp, given
+//   the opcode of "op rax, imm32" and of "op rax, rcx".
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void jit_rax_k(JITBuf_p b, int op_imm, int op_rcx, long k)
+{
+   if(k == (int32_t)k)
+   {
+      jit_byte(b, 0x48);
+      jit_byte(b, op_imm);
+      jit_int(b, k, 4);
+   }
+   else
+   {
+      jit_imm64(b, RCX, k);
+      jit_byte(b, 0x48);
+      jit_byte(b, op_rcx);
+      jit_byte(b, 0xc8);
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: jit_log2()
+//
+//   Return s if k is 2^s with 0 < s < 63, 0 otherwise.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static int jit_log2(long k)
+{
+   int s;
+
+   for(s=1; s<63; s++)
+   {
+      if(k == 1l << s)
+      {
+         return s;
+      }
+   }
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: jit_prologue()
+//
+//   Emit the entry code of a function with frame size frame_size: save
+//   the frame pointer of the caller, set up our own and check that the
+//   frame fits on the value stack and there is native stack left.
+//   The stack overflow handler is at offset 0.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void jit_prologue(JITBuf_p b, int frame_size)
+{
+   jit_byte(b, 0x53);                          /* push rbx */
+   jit_byte(b, 0x48);                          /* mov  rbx, rdi */
+   jit_byte(b, 0x89);
+   jit_byte(b, 0xfb);
+   jit_byte(b, 0x48);                          /* lea  rax, [rdi+size] */
+   jit_byte(b, 0x8d);
+   jit_byte(b, 0x87);
+   jit_int(b, frame_size*sizeof(NanoValue), 4);
+   jit_byte(b, 0x4c);                          /* cmp  rax, r12 */
+   jit_byte(b, 0x39);
+   jit_byte(b, 0xe0);
+   jit_byte(b, 0x0f);                          /* ja   overflow */
+   jit_byte(b, 0x87);
+   jit_int(b, 0, 4);
+   jit_patch(b, b->ctr-4, 0);
+   jit_byte(b, 0x4c);                          /* cmp  rsp, r13 */
+   jit_byte(b, 0x39);
+   jit_byte(b, 0xec);
+   jit_byte(b, 0x0f);                          /* jb   overflow */
+   jit_byte(b, 0x82);
+   jit_int(b, 0, 4);
+   jit_patch(b, b->ctr-4, 0);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: jit_instr()
+//
+//   Emit the machine code for the bytecode instruction at pc. Values
+//   live in the frame, but a value just stored from rax is not
+//   loaded again by the next instruction (unless that is a jump
+//   target).
+//
+// Global Variables: jit_jcc
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void jit_instr(JITBuf_p b, JITProg_p jit, VMInstr* pc)
+{
+   long op     = pc[0].arg;
+   long cached = b->rax_slot;
+   long slow, done;
+   int  i, shift;
+
+   b->rax_slot = -1;
+   switch(op)
+   {
+   case BC_MOV:
+         jit_load_rax(b, cached, pc[2].arg);
+         jit_store(b, pc[1].arg, RAX);
+         b->rax_slot = pc[1].arg;
+         break;
+   case BC_LOADI:
+         if(pc[2].arg == (int32_t)pc[2].arg)
+         {
+            jit_rm(b, 0xc7, 0, pc[1].arg);    /* mov qword [slot], imm32 */
+            jit_int(b, pc[2].arg, 4);
+         }
+         else
+         {
+            jit_imm64(b, RAX, pc[2].arg);
+            jit_store(b, pc[1].arg, RAX);
+            b->rax_slot = pc[1].arg;
+         }
+         break;
+   case BC_LOADS:
+         jit_imm64(b, RAX, (long)pc[2].str);
+         jit_store(b, pc[1].arg, RAX);
+         b->rax_slot = pc[1].arg;
+         break;
+   case BC_GETG:
+         jit_byte(b, 0x48);                    /* mov rax, [moffs64] */
+         jit_byte(b, 0xa1);
+         jit_int(b, (long)&jit->globals[pc[2].arg], 8);
+         jit_store(b, pc[1].arg, RAX);
+         b->rax_slot = pc[1].arg;
+         break;
+   case BC_SETG:
+         jit_load_rax(b, cached, pc[2].arg);
+         jit_byte(b, 0x48);                    /* mov [moffs64], rax */
+         jit_byte(b, 0xa3);
+         jit_int(b, (long)&jit->globals[pc[1].arg], 8);
+         b->rax_slot = pc[2].arg;
+         break;
+   case BC_ADD:
+   case BC_SUB:
+   case BC_MUL:
+         jit_load_rax(b, cached, pc[2].arg);
+         jit_rm(b, op==BC_ADD? 0x03 : op==BC_SUB? 0x2b : 0x0faf,
+                RAX, pc[3].arg);
+         jit_store(b, pc[1].arg, RAX);
+         b->rax_slot = pc[1].arg;
+         break;
+   case BC_DIV:
+         /* Divisors 0 and -1 are left to the runtime */
+         jit_load(b, RCX, pc[3].arg);
+         jit_int(b, 0x01518d48, 4);            /* lea  rdx, [rcx+1] */
+         jit_int(b, 0x01fa8348, 4);            /* cmp  rdx, 1 */
+         jit_byte(b, 0x0f);                    /* jbe  slow */
+         jit_byte(b, 0x86);
+         slow = b->ctr;
+         jit_int(b, 0, 4);
+         jit_load(b, RAX, pc[2].arg);
+         jit_byte(b, 0x48);                    /* cqo */
+         jit_byte(b, 0x99);
+         jit_byte(b, 0x48);                    /* idiv rcx */
+         jit_byte(b, 0xf7);
+         jit_byte(b, 0xf9);
+         jit_byte(b, 0xe9);                    /* jmp  done */
+         done = b->ctr;
+         jit_int(b, 0, 4);
+         jit_patch(b, slow, b->ctr);
+         jit_load(b, RDI, pc[2].arg);
+         jit_byte(b, 0x48);                    /* mov  rsi, rcx */
+         jit_byte(b, 0x89);
+         jit_byte(b, 0xce);
+         jit_call_helper(b, NanoDiv);
+         jit_patch(b, done, b->ctr);
+         jit_store(b, pc[1].arg, RAX);
+         b->rax_slot = pc[1].arg;
+         break;
+   case BC_ADDK:
+         jit_load_rax(b, cached, pc[2].arg);
+         jit_rax_k(b, 0x05, 0x01, pc[3].arg);
+         jit_store(b, pc[1].arg, RAX);
+         b->rax_slot = pc[1].arg;
+         break;
+   case BC_SUBK:
+         jit_load_rax(b, cached, pc[2].arg);
+         jit_rax_k(b, 0x2d, 0x29, pc[3].arg);
+         jit_store(b, pc[1].arg, RAX);
+         b->rax_slot = pc[1].arg;
+         break;
+   case BC_MULK:
+         jit_load_rax(b, cached, pc[2].arg);
+         if((shift = jit_log2(pc[3].arg)))
+         {
+            jit_int(b, 0xe0c148, 3);           /* shl  rax, shift */
+            jit_byte(b, shift);
+         }
+         else if(pc[3].arg == (int32_t)pc[3].arg)
+         {
+            jit_byte(b, 0x48);                 /* imul rax, rax, imm32 */
+            jit_byte(b, 0x69);
+            jit_byte(b, 0xc0);
+            jit_int(b, pc[3].arg, 4);
+         }
+         else
+         {
+            jit_imm64(b, RCX, pc[3].arg);
+            jit_int(b, 0xc1af0f48, 4);         /* imul rax, rcx */
+         }
+         jit_store(b, pc[1].arg, RAX);
+         b->rax_slot = pc[1].arg;
+         break;
+   case BC_DIVK:
+         jit_load_rax(b, cached, pc[2].arg);
+         if((shift = jit_log2(pc[3].arg)))
+         {
+            /* Round towards zero: add 2^shift-1 to negative dividends */
+            jit_int(b, 0xc28948, 3);           /* mov  rdx, rax */
+            jit_int(b, 0x3ffac148, 4);         /* sar  rdx, 63 */
+            jit_int(b, 0xeac148, 3);           /* shr  rdx, 64-shift */
+            jit_byte(b, 64-shift);
+            jit_int(b, 0xd00148, 3);           /* add  rax, rdx */
+            jit_int(b, 0xf8c148, 3);           /* sar  rax, shift */
+            jit_byte(b, shift);
+         }
+         else
+         {
+            jit_imm64(b, RCX, pc[3].arg);
+            jit_byte(b, 0x48);                 /* cqo */
+            jit_byte(b, 0x99);
+            jit_byte(b, 0x48);                 /* idiv rcx */
+            jit_byte(b, 0xf7);
+            jit_byte(b, 0xf9);
+         }
+         jit_store(b, pc[1].arg, RAX);
+         b->rax_slot = pc[1].arg;
+         break;
+   case BC_NEG:
+         jit_load_rax(b, cached, pc[2].arg);
+         jit_byte(b, 0x48);                    /* neg rax */
+         jit_byte(b, 0xf7);
+         jit_byte(b, 0xd8);
+         jit_store(b, pc[1].arg, RAX);
+         b->rax_slot = pc[1].arg;
+         break;
+   case BC_SCMP:
+         jit_load(b, RDI, pc[2].arg);
+         jit_load(b, RSI, pc[3].arg);
+         jit_call_helper(b, NanoStrCmp);
+         jit_byte(b, 0x85);                    /* test  eax, eax */
+         jit_byte(b, 0xc0);
+         jit_int(b, 0xc19f0f, 3);              /* setg  cl */
+         jit_int(b, 0xc09c0f, 3);              /* setl  al */
+         jit_byte(b, 0x28);                    /* sub   cl, al */
+         jit_byte(b, 0xc1);
+         jit_int(b, 0xc1be0f48, 4);            /* movsx rax, cl */
+         jit_store(b, pc[1].arg, RAX);
+         b->rax_slot = pc[1].arg;
+         break;
+   case BC_JMP:
+         jit_byte(b, 0xe9);
+         jit_fixup(b, pc[1].arg, false);
+         break;
+   case BC_JEQ:
+   case BC_JNE:
+   case BC_JLT:
+   case BC_JLE:
+   case BC_JGT:
+   case BC_JGE:
+         jit_load_rax(b, cached, pc[1].arg);
+         jit_rm(b, 0x3b, RAX, pc[2].arg);     /* cmp rax, [slot] */
+         jit_byte(b, 0x0f);
+         jit_byte(b, jit_jcc[op-BC_JEQ]);
+         jit_fixup(b, pc[3].arg, false);
+         b->rax_slot = pc[1].arg;
+         break;
+   case BC_JEQK:
+   case BC_JNEK:
+   case BC_JLTK:
+   case BC_JLEK:
+   case BC_JGTK:
+   case BC_JGEK:
+         jit_load_rax(b, cached, pc[1].arg);
+         jit_rax_k(b, 0x3d, 0x39, pc[2].arg);
+         jit_byte(b, 0x0f);
+         jit_byte(b, jit_jcc[op-BC_JEQK]);
+         jit_fixup(b, pc[3].arg, false);
+         b->rax_slot = pc[1].arg;
+         break;
+   case BC_CLEAR:
+         if(pc[2].arg <= 8)
+         {
+            for(i=0; i<pc[2].arg; i++)
+            {
+               jit_rm(b, 0xc7, 0, pc[1].arg+i);
+               jit_int(b, 0, 4);
+            }
+         }
+         else
+         {
+            jit_rm(b, 0x8d, RDI, pc[1].arg);  /* lea rdi, [slot] */
+            jit_imm64(b, RCX, pc[2].arg);
+            jit_byte(b, 0x31);                 /* xor eax, eax */
+            jit_byte(b, 0xc0);
+            jit_int(b, 0xab48f3, 3);           /* rep stosq */
+         }
+         break;
+   case BC_PRINTI:
+         jit_load(b, RDI, pc[1].arg);
+         jit_call_helper(b, NanoPrintInt);
+         break;
+   case BC_PRINTS:
+         jit_load(b, RDI, pc[1].arg);
+         jit_call_helper(b, NanoPrintStr);
+         break;
+   case BC_CALL:
+         jit_rm(b, 0x8d, RDI, pc[3].arg);     /* lea rdi, [slot] */
+         jit_byte(b, 0xe8);
+         jit_fixup(b, pc[2].arg, true);
+         jit_store(b, pc[1].arg, RAX);
+         b->rax_slot = pc[1].arg;
+         break;
+   case BC_TCALL:
+         for(i=0; i<pc[3].arg; i++)
+         {
+            jit_load(b, RAX, pc[2].arg+i);
+            jit_store(b, i, RAX);
+         }
+         jit_byte(b, 0x48);                    /* mov rdi, rbx */
+         jit_byte(b, 0x89);
+         jit_byte(b, 0xdf);
+         jit_byte(b, 0x5b);                    /* pop rbx */
+         jit_byte(b, 0xe9);                    /* jmp f */
+         jit_fixup(b, pc[1].arg, true);
+         break;
+   case BC_RET:
+         jit_load_rax(b, cached, pc[1].arg);
+         jit_byte(b, 0x5b);                    /* pop rbx */
+         jit_byte(b, 0xc3);                    /* ret */
+         break;
+   case BC_RETNIL:
+         jit_byte(b, 0x31);                    /* xor eax, eax */
+         jit_byte(b, 0xc0);
+         jit_byte(b, 0x5b);
+         jit_byte(b, 0xc3);
+         break;
+   default:
+         assert(false && "Unknown opcode");
+         break;
+   }
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                         Exported Functions                          */
+/*---------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------
+//
+// Function: JITCompile()
+//
+//   Compile the (not threaded) bytecode program prog into machine
+//   code. Return NULL if native code is not supported here (other
+//   architectures, or no executable memory available).
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+JITProg_p JITCompile(VMProg_p prog)
+{
+   JITBufCell b = {NULL, 0, 0, NULL, NULL, -1, NULL, 0, 0};
+   JITProg_p  handle;
+   long       *fun_at, pc, op, i, dest;
+   int        target;
+   size_t     page;
+
+   assert(!prog->threaded);
+#ifndef __x86_64__
+   return NULL;
+#endif
+
+   handle = JITProgCellAlloc();
+   handle->global_ctr = prog->global_ctr;
+   handle->main_fun   = prog->main_fun;
+   handle->main_arity = prog->main_fun>=0? prog->funs[prog->main_fun].arity : 0;
+   handle->globals    = calloc(prog->global_ctr+1, sizeof(NanoValue));
+   handle->fun_entry  = malloc((prog->global_ctr+1)*sizeof(long));
+   b.native           = malloc((prog->code_ctr+1)*sizeof(long));
+   b.label            = calloc(prog->code_ctr+1, sizeof(bool));
+   fun_at             = malloc((prog->code_ctr+1)*sizeof(long));
+   if(!handle->globals || !handle->fun_entry || !b.native || !b.label ||
+      !fun_at)
+   {
+      fprintf(stderr, "Out of memory in JIT compiler!\n");
+      exit(EXIT_FAILURE);
+   }
+   for(pc=0; pc<=prog->code_ctr; pc++)
+   {
+      fun_at[pc] = -1;
+   }
+   for(i=0; i<prog->global_ctr; i++)
+   {
+      handle->fun_entry[i] = -1;
+      if(prog->funs[i].entry >= 0)
+      {
+         fun_at[prog->funs[i].entry] = i;
+      }
+   }
+   for(pc=0; pc<prog->code_ctr; pc += bc_op_len[op])
+   {
+      op     = prog->code[pc].arg;
+      target = BCJumpOperand(op);
+      if(target)
+      {
+         b.label[prog->code[pc+target].arg] = true;
+      }
+   }
+
+   /* Stack overflow handler at offset 0, then the entry code */
+   jit_call_helper(&b, jit_stack_overflow);
+   handle->trampoline = b.ctr;
+   for(i=0; i<(long)sizeof(jit_trampoline); i++)
+   {
+      jit_byte(&b, jit_trampoline[i]);
+   }
+
+   for(pc=0; pc<prog->code_ctr; pc += bc_op_len[prog->code[pc].arg])
+   {
+      if(fun_at[pc] >= 0)
+      {
+         handle->fun_entry[fun_at[pc]] = b.ctr;
+         jit_prologue(&b, prog->funs[fun_at[pc]].frame_size);
+      }
+      if(fun_at[pc] >= 0 || b.label[pc])
+      {
+         b.rax_slot = -1;
+      }
+      b.native[pc] = b.ctr;
+      jit_instr(&b, handle, prog->code+pc);
+   }
+   for(i=0; i<b.fix_ctr; i++)
+   {
+      dest = b.fixes[i].call? handle->fun_entry[b.fixes[i].target]
+                            : b.native[b.fixes[i].target];
+      assert(dest >= 0);
+      jit_patch(&b, b.fixes[i].at, dest);
+   }
+   free(fun_at);
+   free(b.label);
+   free(b.native);
+   free(b.fixes);
+
+   /* Copy into executable memory */
+   page              = sysconf(_SC_PAGESIZE);
+   handle->used      = b.ctr;
+   handle->code_size = (b.ctr+page-1)/page*page;
+   handle->code      = mmap(NULL, handle->code_size, PROT_READ|PROT_WRITE,
+                            MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+   if(handle->code == MAP_FAILED)
+   {
+      handle->code = NULL;
+   }
+   else
+   {
+      memcpy(handle->code, b.code, b.ctr);
+      if(mprotect(handle->code, handle->code_size, PROT_READ|PROT_EXEC) != 0)
+      {
+         munmap(handle->code, handle->code_size);
+         handle->code = NULL;
+      }
+   }
+   free(b.code);
+   if(!handle->code)
+   {
+      JITProgFree(handle);
+      return NULL;
+   }
+   return handle;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: JITProgFree()
+//
+//   Free a compiled program and its executable memory.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+void JITProgFree(JITProg_p junk)
+{
+   if(junk->code)
+   {
+      munmap(junk->code, junk->code_size);
+   }
+   free(junk->globals);
+   free(junk->fun_entry);
+   JITProgCellFree(junk);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: JITRun()
+//
+//   Run main() of prog. The String arguments of main() are taken
+//   from argv (missing ones are empty). Return the result of main().
+//
+// Global Variables: -
+//
+// Side Effects    : By the program
+//
+/----------------------------------------------------------------------*/
+
+NanoInt JITRun(JITProg_p prog, int argc, char* argv[])
+{
+   NanoValue     *stack;
+   unsigned char *native;
+   JITEntry      entry;
+   NanoInt       res;
+   int           i;
+
+   assert(prog->main_fun >= 0);
+
+   stack  = malloc(VM_STACK_SIZE*sizeof(NanoValue));
+   native = mmap(NULL, JIT_NATIVE_STACK, PROT_READ|PROT_WRITE,
+                 MAP_PRIVATE|MAP_ANONYMOUS|MAP_NORESERVE, -1, 0);
+   if(!stack || native == MAP_FAILED)
+   {
+      NanoRuntimeError("out of memory");
+   }
+   for(i=0; i<prog->main_arity; i++)
+   {
+      stack[i].s = i<argc? NanoStrFromC(argv[i]) : NULL;
+   }
+   entry = (JITEntry)(prog->code+prog->trampoline);
+   res   = entry(stack, stack+VM_STACK_SIZE, native+JIT_HELPER_RESERVE,
+                 prog->code+prog->fun_entry[prog->main_fun],
+                 native+JIT_NATIVE_STACK);
+   NanoOutFlush();
+   munmap(native, JIT_NATIVE_STACK);
+   free(stack);
+
+   return res;
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                        End of File                                  */
+/*---------------------------------------------------------------------*/
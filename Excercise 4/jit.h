@@ -0,0 +1,83 @@
+/*-----------------------------------------------------------------------
+
+File  : jit.h
+
+Authors: Konstantin Kläger, Isabel Staaden, Carolin Rösch
+
+Contents
+
+  Just-in-time compiler from nanoLang bytecode (see bytecode.h) to
+  x86-64 machine code. Every function becomes one native function
+  in mmap()ed executable memory. Frames stay in memory, so slots,
+  calls and the frame layout are the same as in the VM, but integers
+  are untagged machine words, arithmetic is done inline and the
+  compare-and-branch instructions become direct conditional jumps.
+  print and string comparisons call the helpers in nanort.h.
+
+  Register conventions inside generated code:
+
+    rbx  Frame pointer (callee saved by every function)
+    r12  End of the value stack
+    r13  Lowest allowed native stack pointer
+    rax, rcx, rdx, rsi, rdi scratch
+
+  Generated code runs on its own native stack (deep recursion must
+  not depend on the stack limit of the process).
+
+  This code is released under the GNU General Public Licence.
+
+Changes
+
+<1> Sun Oct 18 06:02:41 CEST 2026
+    New
+
+-----------------------------------------------------------------------*/
+
+#ifndef JIT
+
+#define JIT
+
+#include "vm.h"
+
+
+/*---------------------------------------------------------------------*/
+/*                    Data type declarations                           */
+/*---------------------------------------------------------------------*/
+
+/* Native stack: every nanoLang call needs a return address and the
+   saved frame pointer, the helpers need some headroom */
+#define JIT_FRAME_BYTES    16
+#define JIT_HELPER_RESERVE (256*1024)
+#define JIT_NATIVE_STACK   (VM_CALL_DEPTH*JIT_FRAME_BYTES+JIT_HELPER_RESERVE)
+
+typedef struct jitprog
+{
+   unsigned char *code;      /* Executable memory */
+   size_t        code_size;  /* Mapped length */
+   long          used;       /* Bytes of generated code */
+   long          trampoline; /* Offset of the entry code */
+   long          *fun_entry; /* Offsets, indexed by global position */
+   NanoValue     *globals;
+   long          global_ctr;
+   long          main_fun;
+   int           main_arity;
+}JITProgCell, *JITProg_p;
+
+
+/*---------------------------------------------------------------------*/
+/*                Exported Functions and Variables                     */
+/*---------------------------------------------------------------------*/
+
+#define JITProgCellAlloc()    (JITProgCell*)malloc(sizeof(JITProgCell))
+#define JITProgCellFree(junk) free(junk)
+
+JITProg_p JITCompile(VMProg_p prog);
+void      JITProgFree(JITProg_p junk);
+NanoInt   JITRun(JITProg_p prog, int argc, char* argv[]);
+
+
+#endif
+
+/*---------------------------------------------------------------------*/
+/*                        End of File                                  */
+/*---------------------------------------------------------------------*/
@@ -1,8 +1,9 @@
-/* A Bison parser, made by GNU Bison 3.0.4.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison implementation for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2015 Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
    This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
@@ -15,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -33,6 +34,10 @@
 /* C LALR(1) parser skeleton written by Richard Stallman, by
    simplifying the original so-called "semantic" parser.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 /* All symbols defined below should begin with yy or YY, to avoid
    infringing on user name space.  This should be done even for local
    variables, as they might otherwise be expanded by user macros.
@@ -40,11 +45,11 @@
    define necessary library symbols; they are noted "INFRINGES ON
    USER NAME SPACE" below.  */
 
-/* Identify Bison output.  */
-#define YYBISON 1
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
 
-/* Bison version.  */
-#define YYBISON_VERSION "3.0.4"
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
@@ -61,149 +66,213 @@
 
 
 
-/* Copy the first part of user declarations.  */
-#line 6 "nanoLangParser.y" /* yacc.c:339  */
+/* First part of user prologue.  */
+#line 6 "nanoLangParser.y"
 
    #include <stdio.h>
    #include <stdlib.h>
    #include <stdarg.h>
+   #include <unistd.h>
    #include "ast.h"
    #include "types.h"
    #include "semantic.h"
+   #include "compactast.h"
+   #include "interp.h"
+   #include "vm.h"
+   #include "jit.h"
+   #include "cgen.h"
+   #include "asmgen.h"
+   #include "optimize.h"
+   #include "irpass.h"
 
    extern int yylex(void);
    extern int yylineno;
    extern int yycolno;
+   extern long yyscanned;
    extern FILE *yyin;
+   extern bool yyscan_mmap(const char* path);
+   extern void yyscan_unmap(void);
    void yyerror(const char *err, ...);
 
    AST_p ast;
 
 
-#line 84 "nanoLangParser.tab.c" /* yacc.c:339  */
+#line 101 "nanoLangParser.tab.c"
 
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
 # ifndef YY_NULLPTR
-#  if defined __cplusplus && 201103L <= __cplusplus
-#   define YY_NULLPTR nullptr
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
 #  else
-#   define YY_NULLPTR 0
+#   define YY_NULLPTR ((void*)0)
 #  endif
 # endif
 
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-# undef YYERROR_VERBOSE
-# define YYERROR_VERBOSE 1
-#else
-# define YYERROR_VERBOSE 1
-#endif
-
-/* In a future release of Bison, this section will be replaced
-   by #include "nanoLangParser.tab.h".  */
-#ifndef YY_YY_NANOLANGPARSER_TAB_H_INCLUDED
-# define YY_YY_NANOLANGPARSER_TAB_H_INCLUDED
-/* Debug traces.  */
-#ifndef YYDEBUG
-# define YYDEBUG 0
-#endif
-#if YYDEBUG
-extern int yydebug;
-#endif
-
-/* Token type.  */
-#ifndef YYTOKENTYPE
-# define YYTOKENTYPE
-  enum yytokentype
-  {
-    IDENT = 258,
-    STRINGLIT = 259,
-    INTLIT = 260,
-    INTEGER = 261,
-    STRING = 262,
-    IF = 263,
-    WHILE = 264,
-    RETURN = 265,
-    PRINT = 266,
-    ELSE = 267,
-    EQ = 268,
-    NEQ = 269,
-    LT = 270,
-    GT = 271,
-    LEQ = 272,
-    GEQ = 273,
-    PLUS = 274,
-    MINUS = 275,
-    MULT = 276,
-    DIV = 277,
-    UMINUS = 278,
-    OPENPAR = 279,
-    CLOSEPAR = 280,
-    SEMICOLON = 281,
-    COMMA = 282,
-    OPENCURLY = 283,
-    CLOSECURLY = 284,
-    ERROR = 285
-  };
-#endif
-
-/* Value type.  */
-#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef AST_p YYSTYPE;
-# define YYSTYPE_IS_TRIVIAL 1
-# define YYSTYPE_IS_DECLARED 1
-#endif
-
-/* Location type.  */
-#if ! defined YYLTYPE && ! defined YYLTYPE_IS_DECLARED
-typedef struct YYLTYPE YYLTYPE;
-struct YYLTYPE
+#include "nanoLangParser.tab.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
 {
-  int first_line;
-  int first_column;
-  int last_line;
-  int last_column;
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_IDENT = 3,                      /* IDENT  */
+  YYSYMBOL_STRINGLIT = 4,                  /* STRINGLIT  */
+  YYSYMBOL_INTLIT = 5,                     /* INTLIT  */
+  YYSYMBOL_INTEGER = 6,                    /* INTEGER  */
+  YYSYMBOL_STRING = 7,                     /* STRING  */
+  YYSYMBOL_IF = 8,                         /* IF  */
+  YYSYMBOL_WHILE = 9,                      /* WHILE  */
+  YYSYMBOL_RETURN = 10,                    /* RETURN  */
+  YYSYMBOL_PRINT = 11,                     /* PRINT  */
+  YYSYMBOL_ELSE = 12,                      /* ELSE  */
+  YYSYMBOL_EQ = 13,                        /* EQ  */
+  YYSYMBOL_NEQ = 14,                       /* NEQ  */
+  YYSYMBOL_LT = 15,                        /* LT  */
+  YYSYMBOL_GT = 16,                        /* GT  */
+  YYSYMBOL_LEQ = 17,                       /* LEQ  */
+  YYSYMBOL_GEQ = 18,                       /* GEQ  */
+  YYSYMBOL_PLUS = 19,                      /* PLUS  */
+  YYSYMBOL_MINUS = 20,                     /* MINUS  */
+  YYSYMBOL_MULT = 21,                      /* MULT  */
+  YYSYMBOL_DIV = 22,                       /* DIV  */
+  YYSYMBOL_UMINUS = 23,                    /* UMINUS  */
+  YYSYMBOL_OPENPAR = 24,                   /* OPENPAR  */
+  YYSYMBOL_CLOSEPAR = 25,                  /* CLOSEPAR  */
+  YYSYMBOL_SEMICOLON = 26,                 /* SEMICOLON  */
+  YYSYMBOL_COMMA = 27,                     /* COMMA  */
+  YYSYMBOL_OPENCURLY = 28,                 /* OPENCURLY  */
+  YYSYMBOL_CLOSECURLY = 29,                /* CLOSECURLY  */
+  YYSYMBOL_ERROR = 30,                     /* ERROR  */
+  YYSYMBOL_YYACCEPT = 31,                  /* $accept  */
+  YYSYMBOL_start = 32,                     /* start  */
+  YYSYMBOL_prog = 33,                      /* prog  */
+  YYSYMBOL_def = 34,                       /* def  */
+  YYSYMBOL_vardef = 35,                    /* vardef  */
+  YYSYMBOL_idlist = 36,                    /* idlist  */
+  YYSYMBOL_fundef = 37,                    /* fundef  */
+  YYSYMBOL_type = 38,                      /* type  */
+  YYSYMBOL_params = 39,                    /* params  */
+  YYSYMBOL_paramlist = 40,                 /* paramlist  */
+  YYSYMBOL_param = 41,                     /* param  */
+  YYSYMBOL_body = 42,                      /* body  */
+  YYSYMBOL_vardefs = 43,                   /* vardefs  */
+  YYSYMBOL_stmts = 44,                     /* stmts  */
+  YYSYMBOL_stmt = 45,                      /* stmt  */
+  YYSYMBOL_while_stmt = 46,                /* while_stmt  */
+  YYSYMBOL_if_stmt = 47,                   /* if_stmt  */
+  YYSYMBOL_ret_stmt = 48,                  /* ret_stmt  */
+  YYSYMBOL_print_stmt = 49,                /* print_stmt  */
+  YYSYMBOL_assign = 50,                    /* assign  */
+  YYSYMBOL_funcall_stmt = 51,              /* funcall_stmt  */
+  YYSYMBOL_boolexpr = 52,                  /* boolexpr  */
+  YYSYMBOL_expr = 53,                      /* expr  */
+  YYSYMBOL_funcall = 54,                   /* funcall  */
+  YYSYMBOL_args = 55,                      /* args  */
+  YYSYMBOL_arglist = 56                    /* arglist  */
 };
-# define YYLTYPE_IS_DECLARED 1
-# define YYLTYPE_IS_TRIVIAL 1
-#endif
-
-
-extern YYSTYPE yylval;
-extern YYLTYPE yylloc;
-int yyparse (void);
+typedef enum yysymbol_kind_t yysymbol_kind_t;
 
-#endif /* !YY_YY_NANOLANGPARSER_TAB_H_INCLUDED  */
 
-/* Copy the second part of user declarations.  */
 
-#line 180 "nanoLangParser.tab.c" /* yacc.c:358  */
 
 #ifdef short
 # undef short
 #endif
 
-#ifdef YYTYPE_UINT8
-typedef YYTYPE_UINT8 yytype_uint8;
-#else
-typedef unsigned char yytype_uint8;
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
 #endif
 
-#ifdef YYTYPE_INT8
-typedef YYTYPE_INT8 yytype_int8;
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
 #else
 typedef signed char yytype_int8;
 #endif
 
-#ifdef YYTYPE_UINT16
-typedef YYTYPE_UINT16 yytype_uint16;
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
+#else
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
 #else
-typedef unsigned short int yytype_uint16;
+typedef short yytype_uint8;
 #endif
 
-#ifdef YYTYPE_INT16
-typedef YYTYPE_INT16 yytype_int16;
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
 #else
-typedef short int yytype_int16;
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
 #endif
 
 #ifndef YYSIZE_T
@@ -211,15 +280,28 @@ typedef short int yytype_int16;
 #  define YYSIZE_T __SIZE_TYPE__
 # elif defined size_t
 #  define YYSIZE_T size_t
-# elif ! defined YYSIZE_T
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
 #  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
 #  define YYSIZE_T size_t
 # else
-#  define YYSIZE_T unsigned int
+#  define YYSIZE_T unsigned
 # endif
 #endif
 
-#define YYSIZE_MAXIMUM ((YYSIZE_T) -1)
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_int8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
 
 #ifndef YY_
 # if defined YYENABLE_NLS && YYENABLE_NLS
@@ -233,47 +315,43 @@ typedef short int yytype_int16;
 # endif
 #endif
 
-#ifndef YY_ATTRIBUTE
-# if (defined __GNUC__                                               \
-      && (2 < __GNUC__ || (__GNUC__ == 2 && 96 <= __GNUC_MINOR__)))  \
-     || defined __SUNPRO_C && 0x5110 <= __SUNPRO_C
-#  define YY_ATTRIBUTE(Spec) __attribute__(Spec)
-# else
-#  define YY_ATTRIBUTE(Spec) /* empty */
-# endif
-#endif
 
 #ifndef YY_ATTRIBUTE_PURE
-# define YY_ATTRIBUTE_PURE   YY_ATTRIBUTE ((__pure__))
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
 #endif
 
 #ifndef YY_ATTRIBUTE_UNUSED
-# define YY_ATTRIBUTE_UNUSED YY_ATTRIBUTE ((__unused__))
-#endif
-
-#if !defined _Noreturn \
-     && (!defined __STDC_VERSION__ || __STDC_VERSION__ < 201112)
-# if defined _MSC_VER && 1200 <= _MSC_VER
-#  define _Noreturn __declspec (noreturn)
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
 # else
-#  define _Noreturn YY_ATTRIBUTE ((__noreturn__))
+#  define YY_ATTRIBUTE_UNUSED
 # endif
 #endif
 
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(E) ((void) (E))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(E) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-#if defined __GNUC__ && 407 <= __GNUC__ * 100 + __GNUC_MINOR__
 /* Suppress an incorrect diagnostic about yylval being uninitialized.  */
-# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN \
-    _Pragma ("GCC diagnostic push") \
-    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")\
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
     _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
-# define YY_IGNORE_MAYBE_UNINITIALIZED_END \
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
     _Pragma ("GCC diagnostic pop")
 #else
 # define YY_INITIAL_VALUE(Value) Value
@@ -286,8 +364,22 @@ typedef short int yytype_int16;
 # define YY_INITIAL_VALUE(Value) /* Nothing. */
 #endif
 
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
 
-#if ! defined yyoverflow || YYERROR_VERBOSE
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if 1
 
 /* The parser invokes alloca or malloc; define the necessary symbols.  */
 
@@ -352,8 +444,7 @@ void free (void *); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 # endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
-
+#endif /* 1 */
 
 #if (! defined yyoverflow \
      && (! defined __cplusplus \
@@ -363,18 +454,19 @@ void free (void *); /* INFRINGES ON USER NAME SPACE */
 /* A type that is properly aligned for any stack member.  */
 union yyalloc
 {
-  yytype_int16 yyss_alloc;
+  yy_state_t yyss_alloc;
   YYSTYPE yyvs_alloc;
   YYLTYPE yyls_alloc;
 };
 
 /* The size of the maximum gap between one aligned stack and the next.  */
-# define YYSTACK_GAP_MAXIMUM (sizeof (union yyalloc) - 1)
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
 
 /* The size of an array large to enough to hold all stacks, each with
    N elements.  */
 # define YYSTACK_BYTES(N) \
-     ((N) * (sizeof (yytype_int16) + sizeof (YYSTYPE) + sizeof (YYLTYPE)) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE) \
+             + YYSIZEOF (YYLTYPE)) \
       + 2 * YYSTACK_GAP_MAXIMUM)
 
 # define YYCOPY_NEEDED 1
@@ -387,11 +479,11 @@ union yyalloc
 # define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
     do                                                                  \
       {                                                                 \
-        YYSIZE_T yynewbytes;                                            \
+        YYPTRDIFF_T yynewbytes;                                         \
         YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
         Stack = &yyptr->Stack_alloc;                                    \
-        yynewbytes = yystacksize * sizeof (*Stack) + YYSTACK_GAP_MAXIMUM; \
-        yyptr += yynewbytes / sizeof (*yyptr);                          \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
       }                                                                 \
     while (0)
 
@@ -403,12 +495,12 @@ union yyalloc
 # ifndef YYCOPY
 #  if defined __GNUC__ && 1 < __GNUC__
 #   define YYCOPY(Dst, Src, Count) \
-      __builtin_memcpy (Dst, Src, (Count) * sizeof (*(Src)))
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
 #  else
 #   define YYCOPY(Dst, Src, Count)              \
       do                                        \
         {                                       \
-          YYSIZE_T yyi;                         \
+          YYPTRDIFF_T yyi;                      \
           for (yyi = 0; yyi < (Count); yyi++)   \
             (Dst)[yyi] = (Src)[yyi];            \
         }                                       \
@@ -431,17 +523,20 @@ union yyalloc
 /* YYNSTATES -- Number of states.  */
 #define YYNSTATES  106
 
-/* YYTRANSLATE[YYX] -- Symbol number corresponding to YYX as returned
-   by yylex, with out-of-bounds checking.  */
-#define YYUNDEFTOK  2
+/* YYMAXUTOK -- Last valid token kind.  */
 #define YYMAXUTOK   285
 
-#define YYTRANSLATE(YYX)                                                \
-  ((unsigned int) (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
 
 /* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
-   as returned by yylex, without out-of-bounds checking.  */
-static const yytype_uint8 yytranslate[] =
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
 {
        0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -475,26 +570,33 @@ static const yytype_uint8 yytranslate[] =
 };
 
 #if YYDEBUG
-  /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_uint8 yyrline[] =
 {
-       0,    49,    49,    51,    52,    53,    56,    57,    60,    61,
-      64,    65,    68,    69,    72,    73,    76,    77,    80,    81,
-      84,    87,    90,    91,    94,    95,    98,    99,   100,   101,
-     102,   103,   106,   109,   110,   113,   116,   119,   122,   125,
-     126,   127,   128,   129,   130,   133,   134,   135,   136,   137,
-     138,   139,   140,   141,   142,   145,   148,   149,   152,   153
+       0,    61,    61,    63,    64,    65,    68,    69,    72,    73,
+      76,    77,    80,    81,    84,    85,    88,    89,    92,    93,
+      96,    99,   102,   103,   106,   107,   110,   111,   112,   113,
+     114,   115,   118,   121,   122,   125,   128,   131,   134,   137,
+     138,   139,   140,   141,   142,   145,   146,   147,   148,   149,
+     150,   151,   152,   153,   154,   157,   162,   163,   166,   169
 };
 #endif
 
-#if YYDEBUG || YYERROR_VERBOSE || 1
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if 1
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
 static const char *const yytname[] =
 {
-  "$end", "error", "$undefined", "IDENT", "STRINGLIT", "INTLIT",
-  "INTEGER", "STRING", "IF", "WHILE", "RETURN", "PRINT", "ELSE", "EQ",
-  "NEQ", "LT", "GT", "LEQ", "GEQ", "PLUS", "MINUS", "MULT", "DIV",
+  "\"end of file\"", "error", "\"invalid token\"", "IDENT", "STRINGLIT",
+  "INTLIT", "INTEGER", "STRING", "IF", "WHILE", "RETURN", "PRINT", "ELSE",
+  "EQ", "NEQ", "LT", "GT", "LEQ", "GEQ", "PLUS", "MINUS", "MULT", "DIV",
   "UMINUS", "OPENPAR", "CLOSEPAR", "SEMICOLON", "COMMA", "OPENCURLY",
   "CLOSECURLY", "ERROR", "$accept", "start", "prog", "def", "vardef",
   "idlist", "fundef", "type", "params", "paramlist", "param", "body",
@@ -502,32 +604,26 @@ static const char *const yytname[] =
   "print_stmt", "assign", "funcall_stmt", "boolexpr", "expr", "funcall",
   "args", "arglist", YY_NULLPTR
 };
-#endif
 
-# ifdef YYPRINT
-/* YYTOKNUM[NUM] -- (External) token number corresponding to the
-   (internal) symbol number NUM (which must be that of a token).  */
-static const yytype_uint16 yytoknum[] =
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
 {
-       0,   256,   257,   258,   259,   260,   261,   262,   263,   264,
-     265,   266,   267,   268,   269,   270,   271,   272,   273,   274,
-     275,   276,   277,   278,   279,   280,   281,   282,   283,   284,
-     285
-};
-# endif
+  return yytname[yysymbol];
+}
+#endif
 
-#define YYPACT_NINF -48
+#define YYPACT_NINF (-48)
 
-#define yypact_value_is_default(Yystate) \
-  (!!((Yystate) == (-48)))
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
 
-#define YYTABLE_NINF -25
+#define YYTABLE_NINF (-25)
 
-#define yytable_value_is_error(Yytable_value) \
+#define yytable_value_is_error(Yyn) \
   0
 
-  /* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
-     STATE-NUM.  */
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
 static const yytype_int8 yypact[] =
 {
       88,    22,     5,    92,    42,   -48,   -48,   -48,   -48,   -48,
@@ -543,10 +639,10 @@ static const yytype_int8 yypact[] =
       25,    25,    25,   -48,    87,   -48
 };
 
-  /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
-     Performed when YYTABLE does not specify something else to do.  Zero
-     means the default is an error.  */
-static const yytype_uint8 yydefact[] =
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_int8 yydefact[] =
 {
        0,     0,     0,     0,     0,    15,    14,     5,     6,     7,
        0,     1,     4,     9,    22,    13,    10,     0,     0,    16,
@@ -561,7 +657,7 @@ static const yytype_uint8 yydefact[] =
       42,    43,    44,    32,     0,    34
 };
 
-  /* YYPGOTO[NTERM-NUM].  */
+/* YYPGOTO[NTERM-NUM].  */
 static const yytype_int8 yypgoto[] =
 {
      -48,   -48,   -48,   108,    96,   -48,   -48,   -15,   -48,   -48,
@@ -569,17 +665,17 @@ static const yytype_int8 yypgoto[] =
      -48,    71,   -25,    97,   -48,   -48
 };
 
-  /* YYDEFGOTO[NTERM-NUM].  */
+/* YYDEFGOTO[NTERM-NUM].  */
 static const yytype_int8 yydefgoto[] =
 {
-      -1,     2,     3,     7,     8,    17,     9,    10,    27,    28,
+       0,     2,     3,     7,     8,    17,     9,    10,    27,    28,
       29,    15,    18,    25,    38,    39,    40,    41,    42,    43,
       44,    68,    69,    59,    66,    67
 };
 
-  /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
-     positive, shift that token.  If negative, reduce the rule whose
-     number is the opposite.  If YYTABLE_NINF, syntax error.  */
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_int8 yytable[] =
 {
       62,    32,    49,    24,    26,    11,    33,    34,    35,    36,
@@ -614,9 +710,9 @@ static const yytype_int8 yycheck[] =
       48,    -1,    25,    52
 };
 
-  /* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-     symbol of state STATE-NUM.  */
-static const yytype_uint8 yystos[] =
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
 {
        0,     1,    32,    33,     1,     6,     7,    34,    35,    37,
       38,     0,    34,    26,    28,    42,     3,    36,    43,    24,
@@ -631,8 +727,8 @@ static const yytype_uint8 yystos[] =
       53,    53,    53,    42,    12,    42
 };
 
-  /* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
-static const yytype_uint8 yyr1[] =
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
 {
        0,    31,    32,    33,    33,    33,    34,    34,    35,    35,
       36,    36,    37,    37,    38,    38,    39,    39,    40,    40,
@@ -642,8 +738,8 @@ static const yytype_uint8 yyr1[] =
       53,    53,    53,    53,    53,    54,    55,    55,    56,    56
 };
 
-  /* YYR2[YYN] -- Number of symbols on the right hand side of rule YYN.  */
-static const yytype_uint8 yyr2[] =
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
 {
        0,     2,     1,     0,     2,     2,     1,     1,     3,     2,
        1,     3,     6,     2,     1,     1,     0,     1,     1,     3,
@@ -654,39 +750,39 @@ static const yytype_uint8 yyr2[] =
 };
 
 
+enum { YYENOMEM = -2 };
+
 #define yyerrok         (yyerrstatus = 0)
 #define yyclearin       (yychar = YYEMPTY)
-#define YYEMPTY         (-2)
-#define YYEOF           0
 
 #define YYACCEPT        goto yyacceptlab
 #define YYABORT         goto yyabortlab
 #define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
 
 
 #define YYRECOVERING()  (!!yyerrstatus)
 
-#define YYBACKUP(Token, Value)                                  \
-do                                                              \
-  if (yychar == YYEMPTY)                                        \
-    {                                                           \
-      yychar = (Token);                                         \
-      yylval = (Value);                                         \
-      YYPOPSTACK (yylen);                                       \
-      yystate = *yyssp;                                         \
-      goto yybackup;                                            \
-    }                                                           \
-  else                                                          \
-    {                                                           \
-      yyerror (YY_("syntax error: cannot back up")); \
-      YYERROR;                                                  \
-    }                                                           \
-while (0)
-
-/* Error token number */
-#define YYTERROR        1
-#define YYERRCODE       256
-
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
 
 /* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
    If N is 0, then set CURRENT to the empty location which ends
@@ -730,20 +826,27 @@ do {                                            \
 } while (0)
 
 
-/* YY_LOCATION_PRINT -- Print the location on the stream.
+/* YYLOCATION_PRINT -- Print the location on the stream.
    This macro was not mandated originally: define only if we know
    we won't break user code: when these are the locations we know.  */
 
-#ifndef YY_LOCATION_PRINT
-# if defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
+# ifndef YYLOCATION_PRINT
+
+#  if defined YY_LOCATION_PRINT
+
+   /* Temporary convenience wrapper in case some people defined the
+      undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YYLOCATION_PRINT(File, Loc)  YY_LOCATION_PRINT(File, *(Loc))
+
+#  elif defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
 
 /* Print *YYLOCP on YYO.  Private, do not rely on its existence. */
 
 YY_ATTRIBUTE_UNUSED
-static unsigned
+static int
 yy_location_print_ (FILE *yyo, YYLTYPE const * const yylocp)
 {
-  unsigned res = 0;
+  int res = 0;
   int end_col = 0 != yylocp->last_column ? yylocp->last_column - 1 : 0;
   if (0 <= yylocp->first_line)
     {
@@ -763,63 +866,71 @@ yy_location_print_ (FILE *yyo, YYLTYPE const * const yylocp)
         res += YYFPRINTF (yyo, "-%d", end_col);
     }
   return res;
- }
+}
 
-#  define YY_LOCATION_PRINT(File, Loc)          \
-  yy_location_print_ (File, &(Loc))
+#   define YYLOCATION_PRINT  yy_location_print_
 
-# else
-#  define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-# endif
-#endif
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT(File, Loc)  YYLOCATION_PRINT(File, &(Loc))
+
+#  else
+
+#   define YYLOCATION_PRINT(File, Loc) ((void) 0)
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT  YYLOCATION_PRINT
+
+#  endif
+# endif /* !defined YYLOCATION_PRINT */
 
 
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)                    \
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
 do {                                                                      \
   if (yydebug)                                                            \
     {                                                                     \
       YYFPRINTF (stderr, "%s ", Title);                                   \
       yy_symbol_print (stderr,                                            \
-                  Type, Value, Location); \
+                  Kind, Value, Location); \
       YYFPRINTF (stderr, "\n");                                           \
     }                                                                     \
 } while (0)
 
 
-/*----------------------------------------.
-| Print this symbol's value on YYOUTPUT.  |
-`----------------------------------------*/
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
 
 static void
-yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp)
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp)
 {
-  FILE *yyo = yyoutput;
-  YYUSE (yyo);
-  YYUSE (yylocationp);
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  YY_USE (yylocationp);
   if (!yyvaluep)
     return;
-# ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT (yyoutput, yytoknum[yytype], *yyvaluep);
-# endif
-  YYUSE (yytype);
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
 
 static void
-yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp)
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp)
 {
-  YYFPRINTF (yyoutput, "%s %s (",
-             yytype < YYNTOKENS ? "token" : "nterm", yytname[yytype]);
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  YY_LOCATION_PRINT (yyoutput, *yylocationp);
-  YYFPRINTF (yyoutput, ": ");
-  yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp);
-  YYFPRINTF (yyoutput, ")");
+  YYLOCATION_PRINT (yyo, yylocationp);
+  YYFPRINTF (yyo, ": ");
+  yy_symbol_value_print (yyo, yykind, yyvaluep, yylocationp);
+  YYFPRINTF (yyo, ")");
 }
 
 /*------------------------------------------------------------------.
@@ -828,7 +939,7 @@ yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYL
 `------------------------------------------------------------------*/
 
 static void
-yy_stack_print (yytype_int16 *yybottom, yytype_int16 *yytop)
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
 {
   YYFPRINTF (stderr, "Stack now");
   for (; yybottom <= yytop; yybottom++)
@@ -851,21 +962,22 @@ do {                                                            \
 `------------------------------------------------*/
 
 static void
-yy_reduce_print (yytype_int16 *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp, int yyrule)
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp,
+                 int yyrule)
 {
-  unsigned long int yylno = yyrline[yyrule];
+  int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
   int yyi;
-  YYFPRINTF (stderr, "Reducing stack by rule %d (line %lu):\n",
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
              yyrule - 1, yylno);
   /* The symbols being reduced.  */
   for (yyi = 0; yyi < yynrhs; yyi++)
     {
       YYFPRINTF (stderr, "   $%d = ", yyi + 1);
       yy_symbol_print (stderr,
-                       yystos[yyssp[yyi + 1 - yynrhs]],
-                       &(yyvsp[(yyi + 1) - (yynrhs)])
-                       , &(yylsp[(yyi + 1) - (yynrhs)])                       );
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)],
+                       &(yylsp[(yyi + 1) - (yynrhs)]));
       YYFPRINTF (stderr, "\n");
     }
 }
@@ -880,8 +992,8 @@ do {                                    \
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !YYDEBUG */
-# define YYDPRINTF(Args)
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
 # define YY_STACK_PRINT(Bottom, Top)
 # define YY_REDUCE_PRINT(Rule)
 #endif /* !YYDEBUG */
@@ -904,28 +1016,77 @@ int yydebug;
 #endif
 
 
-#if YYERROR_VERBOSE
+/* Context of a parse error.  */
+typedef struct
+{
+  yy_state_t *yyssp;
+  yysymbol_kind_t yytoken;
+  YYLTYPE *yylloc;
+} yypcontext_t;
+
+/* Put in YYARG at most YYARGN of the expected tokens given the
+   current YYCTX, and return the number of tokens stored in YYARG.  If
+   YYARG is null, return the number of expected tokens (guaranteed to
+   be less than YYNTOKENS).  Return YYENOMEM on memory exhaustion.
+   Return 0 if there are more than YYARGN expected tokens, yet fill
+   YYARG up to YYARGN. */
+static int
+yypcontext_expected_tokens (const yypcontext_t *yyctx,
+                            yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  int yyn = yypact[+*yyctx->yyssp];
+  if (!yypact_value_is_default (yyn))
+    {
+      /* Start YYX at -YYN if negative to avoid negative indexes in
+         YYCHECK.  In other words, skip the first -YYN actions for
+         this state because they are default actions.  */
+      int yyxbegin = yyn < 0 ? -yyn : 0;
+      /* Stay within bounds of both yycheck and yytname.  */
+      int yychecklim = YYLAST - yyn + 1;
+      int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
+      int yyx;
+      for (yyx = yyxbegin; yyx < yyxend; ++yyx)
+        if (yycheck[yyx + yyn] == yyx && yyx != YYSYMBOL_YYerror
+            && !yytable_value_is_error (yytable[yyx + yyn]))
+          {
+            if (!yyarg)
+              ++yycount;
+            else if (yycount == yyargn)
+              return 0;
+            else
+              yyarg[yycount++] = YY_CAST (yysymbol_kind_t, yyx);
+          }
+    }
+  if (yyarg && yycount == 0 && 0 < yyargn)
+    yyarg[0] = YYSYMBOL_YYEMPTY;
+  return yycount;
+}
 
-# ifndef yystrlen
-#  if defined __GLIBC__ && defined _STRING_H
-#   define yystrlen strlen
-#  else
+
+
+
+#ifndef yystrlen
+# if defined __GLIBC__ && defined _STRING_H
+#  define yystrlen(S) (YY_CAST (YYPTRDIFF_T, strlen (S)))
+# else
 /* Return the length of YYSTR.  */
-static YYSIZE_T
+static YYPTRDIFF_T
 yystrlen (const char *yystr)
 {
-  YYSIZE_T yylen;
+  YYPTRDIFF_T yylen;
   for (yylen = 0; yystr[yylen]; yylen++)
     continue;
   return yylen;
 }
-#  endif
 # endif
+#endif
 
-# ifndef yystpcpy
-#  if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#   define yystpcpy stpcpy
-#  else
+#ifndef yystpcpy
+# if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
+#  define yystpcpy stpcpy
+# else
 /* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
    YYDEST.  */
 static char *
@@ -939,10 +1100,10 @@ yystpcpy (char *yydest, const char *yysrc)
 
   return yyd - 1;
 }
-#  endif
 # endif
+#endif
 
-# ifndef yytnamerr
+#ifndef yytnamerr
 /* Copy to YYRES the contents of YYSTR after stripping away unnecessary
    quotes and backslashes, so that it's suitable for yyerror.  The
    heuristic is that double-quoting is unnecessary unless the string
@@ -950,14 +1111,13 @@ yystpcpy (char *yydest, const char *yysrc)
    backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
    null, do not copy; instead, return the length of what the result
    would have been.  */
-static YYSIZE_T
+static YYPTRDIFF_T
 yytnamerr (char *yyres, const char *yystr)
 {
   if (*yystr == '"')
     {
-      YYSIZE_T yyn = 0;
+      YYPTRDIFF_T yyn = 0;
       char const *yyp = yystr;
-
       for (;;)
         switch (*++yyp)
           {
@@ -968,7 +1128,10 @@ yytnamerr (char *yyres, const char *yystr)
           case '\\':
             if (*++yyp != '\\')
               goto do_not_strip_quotes;
-            /* Fall through.  */
+            else
+              goto append;
+
+          append:
           default:
             if (yyres)
               yyres[yyn] = *yyp;
@@ -983,36 +1146,20 @@ yytnamerr (char *yyres, const char *yystr)
     do_not_strip_quotes: ;
     }
 
-  if (! yyres)
+  if (yyres)
+    return yystpcpy (yyres, yystr) - yyres;
+  else
     return yystrlen (yystr);
-
-  return yystpcpy (yyres, yystr) - yyres;
 }
-# endif
+#endif
 
-/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
-   about the unexpected token YYTOKEN for the state stack whose top is
-   YYSSP.
 
-   Return 0 if *YYMSG was successfully written.  Return 1 if *YYMSG is
-   not large enough to hold the message.  In that case, also set
-   *YYMSG_ALLOC to the required number of bytes.  Return 2 if the
-   required number of bytes is too large to store.  */
 static int
-yysyntax_error (YYSIZE_T *yymsg_alloc, char **yymsg,
-                yytype_int16 *yyssp, int yytoken)
+yy_syntax_error_arguments (const yypcontext_t *yyctx,
+                           yysymbol_kind_t yyarg[], int yyargn)
 {
-  YYSIZE_T yysize0 = yytnamerr (YY_NULLPTR, yytname[yytoken]);
-  YYSIZE_T yysize = yysize0;
-  enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-  /* Internationalized format string. */
-  const char *yyformat = YY_NULLPTR;
-  /* Arguments of yyformat. */
-  char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
-  /* Number of reported tokens (one for the "unexpected", one per
-     "expected"). */
+  /* Actual size of YYARG. */
   int yycount = 0;
-
   /* There are many possibilities here to consider:
      - If this state is a consistent state with a default action, then
        the only way this function was invoked is if the default action
@@ -1036,63 +1183,78 @@ yysyntax_error (YYSIZE_T *yymsg_alloc, char **yymsg,
        one exception: it will still contain any token that will not be
        accepted due to an error action in a later state.
   */
-  if (yytoken != YYEMPTY)
+  if (yyctx->yytoken != YYSYMBOL_YYEMPTY)
     {
-      int yyn = yypact[*yyssp];
-      yyarg[yycount++] = yytname[yytoken];
-      if (!yypact_value_is_default (yyn))
-        {
-          /* Start YYX at -YYN if negative to avoid negative indexes in
-             YYCHECK.  In other words, skip the first -YYN actions for
-             this state because they are default actions.  */
-          int yyxbegin = yyn < 0 ? -yyn : 0;
-          /* Stay within bounds of both yycheck and yytname.  */
-          int yychecklim = YYLAST - yyn + 1;
-          int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-          int yyx;
-
-          for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-            if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR
-                && !yytable_value_is_error (yytable[yyx + yyn]))
-              {
-                if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-                  {
-                    yycount = 1;
-                    yysize = yysize0;
-                    break;
-                  }
-                yyarg[yycount++] = yytname[yyx];
-                {
-                  YYSIZE_T yysize1 = yysize + yytnamerr (YY_NULLPTR, yytname[yyx]);
-                  if (! (yysize <= yysize1
-                         && yysize1 <= YYSTACK_ALLOC_MAXIMUM))
-                    return 2;
-                  yysize = yysize1;
-                }
-              }
-        }
+      int yyn;
+      if (yyarg)
+        yyarg[yycount] = yyctx->yytoken;
+      ++yycount;
+      yyn = yypcontext_expected_tokens (yyctx,
+                                        yyarg ? yyarg + 1 : yyarg, yyargn - 1);
+      if (yyn == YYENOMEM)
+        return YYENOMEM;
+      else
+        yycount += yyn;
     }
+  return yycount;
+}
+
+/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
+   about the unexpected token YYTOKEN for the state stack whose top is
+   YYSSP.
+
+   Return 0 if *YYMSG was successfully written.  Return -1 if *YYMSG is
+   not large enough to hold the message.  In that case, also set
+   *YYMSG_ALLOC to the required number of bytes.  Return YYENOMEM if the
+   required number of bytes is too large to store.  */
+static int
+yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
+                const yypcontext_t *yyctx)
+{
+  enum { YYARGS_MAX = 5 };
+  /* Internationalized format string. */
+  const char *yyformat = YY_NULLPTR;
+  /* Arguments of yyformat: reported tokens (one for the "unexpected",
+     one per "expected"). */
+  yysymbol_kind_t yyarg[YYARGS_MAX];
+  /* Cumulated lengths of YYARG.  */
+  YYPTRDIFF_T yysize = 0;
+
+  /* Actual size of YYARG. */
+  int yycount = yy_syntax_error_arguments (yyctx, yyarg, YYARGS_MAX);
+  if (yycount == YYENOMEM)
+    return YYENOMEM;
 
   switch (yycount)
     {
-# define YYCASE_(N, S)                      \
+#define YYCASE_(N, S)                       \
       case N:                               \
         yyformat = S;                       \
-      break
+        break
+    default: /* Avoid compiler warnings. */
       YYCASE_(0, YY_("syntax error"));
       YYCASE_(1, YY_("syntax error, unexpected %s"));
       YYCASE_(2, YY_("syntax error, unexpected %s, expecting %s"));
       YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
       YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
       YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
-# undef YYCASE_
+#undef YYCASE_
     }
 
+  /* Compute error message size.  Don't count the "%s"s, but reserve
+     room for the terminator.  */
+  yysize = yystrlen (yyformat) - 2 * yycount + 1;
   {
-    YYSIZE_T yysize1 = yysize + yystrlen (yyformat);
-    if (! (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM))
-      return 2;
-    yysize = yysize1;
+    int yyi;
+    for (yyi = 0; yyi < yycount; ++yyi)
+      {
+        YYPTRDIFF_T yysize1
+          = yysize + yytnamerr (YY_NULLPTR, yytname[yyarg[yyi]]);
+        if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
+          yysize = yysize1;
+        else
+          return YYENOMEM;
+      }
   }
 
   if (*yymsg_alloc < yysize)
@@ -1101,7 +1263,7 @@ yysyntax_error (YYSIZE_T *yymsg_alloc, char **yymsg,
       if (! (yysize <= *yymsg_alloc
              && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
         *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
-      return 1;
+      return -1;
     }
 
   /* Avoid sprintf, as that infringes on the user's name space.
@@ -1113,41 +1275,40 @@ yysyntax_error (YYSIZE_T *yymsg_alloc, char **yymsg,
     while ((*yyp = *yyformat) != '\0')
       if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
         {
-          yyp += yytnamerr (yyp, yyarg[yyi++]);
+          yyp += yytnamerr (yyp, yytname[yyarg[yyi++]]);
           yyformat += 2;
         }
       else
         {
-          yyp++;
-          yyformat++;
+          ++yyp;
+          ++yyformat;
         }
   }
   return 0;
 }
-#endif /* YYERROR_VERBOSE */
+
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
 static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, YYLTYPE *yylocationp)
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, YYLTYPE *yylocationp)
 {
-  YYUSE (yyvaluep);
-  YYUSE (yylocationp);
+  YY_USE (yyvaluep);
+  YY_USE (yylocationp);
   if (!yymsg)
     yymsg = "Deleting";
-  YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE (yytype);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
-
-
-/* The lookahead symbol.  */
+/* Lookahead token kind.  */
 int yychar;
 
 /* The semantic value of the lookahead symbol.  */
@@ -1162,6 +1323,8 @@ YYLTYPE yylloc
 int yynerrs;
 
 
+
+
 /*----------.
 | yyparse.  |
 `----------*/
@@ -1169,53 +1332,48 @@ int yynerrs;
 int
 yyparse (void)
 {
-    int yystate;
+    yy_state_fast_t yystate = 0;
     /* Number of tokens to shift before error messages enabled.  */
-    int yyerrstatus;
-
-    /* The stacks and their tools:
-       'yyss': related to states.
-       'yyvs': related to semantic values.
-       'yyls': related to locations.
+    int yyerrstatus = 0;
 
-       Refer to the stacks through separate pointers, to allow yyoverflow
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
        to reallocate them elsewhere.  */
 
-    /* The state stack.  */
-    yytype_int16 yyssa[YYINITDEPTH];
-    yytype_int16 *yyss;
-    yytype_int16 *yyssp;
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
 
-    /* The semantic value stack.  */
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
+
+    /* The semantic value stack: array, bottom, top.  */
     YYSTYPE yyvsa[YYINITDEPTH];
-    YYSTYPE *yyvs;
-    YYSTYPE *yyvsp;
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
 
-    /* The location stack.  */
+    /* The location stack: array, bottom, top.  */
     YYLTYPE yylsa[YYINITDEPTH];
-    YYLTYPE *yyls;
-    YYLTYPE *yylsp;
-
-    /* The locations where the error started and ended.  */
-    YYLTYPE yyerror_range[3];
-
-    YYSIZE_T yystacksize;
+    YYLTYPE *yyls = yylsa;
+    YYLTYPE *yylsp = yyls;
 
   int yyn;
+  /* The return value of yyparse.  */
   int yyresult;
-  /* Lookahead token as an internal (translated) token number.  */
-  int yytoken = 0;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
   /* The variables used to return semantic value and location from the
      action routines.  */
   YYSTYPE yyval;
   YYLTYPE yyloc;
 
-#if YYERROR_VERBOSE
+  /* The locations where the error started and ended.  */
+  YYLTYPE yyerror_range[3];
+
   /* Buffer for error messages, and its allocated size.  */
   char yymsgbuf[128];
   char *yymsg = yymsgbuf;
-  YYSIZE_T yymsg_alloc = sizeof yymsgbuf;
-#endif
+  YYPTRDIFF_T yymsg_alloc = sizeof yymsgbuf;
 
 #define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N), yylsp -= (N))
 
@@ -1223,43 +1381,49 @@ yyparse (void)
      Keep to zero when no symbol should be popped.  */
   int yylen = 0;
 
-  yyssp = yyss = yyssa;
-  yyvsp = yyvs = yyvsa;
-  yylsp = yyls = yylsa;
-  yystacksize = YYINITDEPTH;
-
   YYDPRINTF ((stderr, "Starting parse\n"));
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
   yychar = YYEMPTY; /* Cause a token to be read.  */
+
   yylsp[0] = yylloc;
   goto yysetstate;
 
+
 /*------------------------------------------------------------.
-| yynewstate -- Push a new state, which is found in yystate.  |
+| yynewstate -- push a new state, which is found in yystate.  |
 `------------------------------------------------------------*/
- yynewstate:
+yynewstate:
   /* In all cases, when you get here, the value and location stacks
      have just been pushed.  So pushing a state here evens the stacks.  */
   yyssp++;
 
- yysetstate:
-  *yyssp = yystate;
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
 
   if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
     {
       /* Get the current used size of the three stacks, in elements.  */
-      YYSIZE_T yysize = yyssp - yyss + 1;
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
 
-#ifdef yyoverflow
+# if defined yyoverflow
       {
         /* Give user a chance to reallocate the stack.  Use copies of
            these so that the &'s don't force the real ones into
            memory.  */
+        yy_state_t *yyss1 = yyss;
         YYSTYPE *yyvs1 = yyvs;
-        yytype_int16 *yyss1 = yyss;
         YYLTYPE *yyls1 = yyls;
 
         /* Each stack pointer address is followed by the size of the
@@ -1267,32 +1431,29 @@ yyparse (void)
            conditional around just the two extra args, but that might
            be undefined if yyoverflow is a macro.  */
         yyoverflow (YY_("memory exhausted"),
-                    &yyss1, yysize * sizeof (*yyssp),
-                    &yyvs1, yysize * sizeof (*yyvsp),
-                    &yyls1, yysize * sizeof (*yylsp),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yyls1, yysize * YYSIZEOF (*yylsp),
                     &yystacksize);
-
-        yyls = yyls1;
         yyss = yyss1;
         yyvs = yyvs1;
+        yyls = yyls1;
       }
-#else /* no yyoverflow */
-# ifndef YYSTACK_RELOCATE
-      goto yyexhaustedlab;
-# else
+# else /* defined YYSTACK_RELOCATE */
       /* Extend the stack our own way.  */
       if (YYMAXDEPTH <= yystacksize)
-        goto yyexhaustedlab;
+        YYNOMEM;
       yystacksize *= 2;
       if (YYMAXDEPTH < yystacksize)
         yystacksize = YYMAXDEPTH;
 
       {
-        yytype_int16 *yyss1 = yyss;
+        yy_state_t *yyss1 = yyss;
         union yyalloc *yyptr =
-          (union yyalloc *) YYSTACK_ALLOC (YYSTACK_BYTES (yystacksize));
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
         if (! yyptr)
-          goto yyexhaustedlab;
+          YYNOMEM;
         YYSTACK_RELOCATE (yyss_alloc, yyss);
         YYSTACK_RELOCATE (yyvs_alloc, yyvs);
         YYSTACK_RELOCATE (yyls_alloc, yyls);
@@ -1301,31 +1462,32 @@ yyparse (void)
           YYSTACK_FREE (yyss1);
       }
 # endif
-#endif /* no yyoverflow */
 
       yyssp = yyss + yysize - 1;
       yyvsp = yyvs + yysize - 1;
       yylsp = yyls + yysize - 1;
 
-      YYDPRINTF ((stderr, "Stack size increased to %lu\n",
-                  (unsigned long int) yystacksize));
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
 
       if (yyss + yystacksize - 1 <= yyssp)
         YYABORT;
     }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
-  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
 
   if (yystate == YYFINAL)
     YYACCEPT;
 
   goto yybackup;
 
+
 /*-----------.
 | yybackup.  |
 `-----------*/
 yybackup:
-
   /* Do appropriate processing given the current state.  Read a
      lookahead token if we need one and don't already have one.  */
 
@@ -1336,18 +1498,30 @@ yybackup:
 
   /* Not known => get a lookahead token if don't already have one.  */
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid lookahead symbol.  */
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
   if (yychar == YYEMPTY)
     {
-      YYDPRINTF ((stderr, "Reading a token: "));
+      YYDPRINTF ((stderr, "Reading a token\n"));
       yychar = yylex ();
     }
 
   if (yychar <= YYEOF)
     {
-      yychar = yytoken = YYEOF;
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
       YYDPRINTF ((stderr, "Now at end of input.\n"));
     }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      yyerror_range[1] = yylloc;
+      goto yyerrlab1;
+    }
   else
     {
       yytoken = YYTRANSLATE (yychar);
@@ -1375,15 +1549,14 @@ yybackup:
 
   /* Shift the lookahead token.  */
   YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
-
-  /* Discard the shifted token.  */
-  yychar = YYEMPTY;
-
   yystate = yyn;
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
   YY_IGNORE_MAYBE_UNINITIALIZED_END
   *++yylsp = yylloc;
+
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
   goto yynewstate;
 
 
@@ -1398,7 +1571,7 @@ yydefault:
 
 
 /*-----------------------------.
-| yyreduce -- Do a reduction.  |
+| yyreduce -- do a reduction.  |
 `-----------------------------*/
 yyreduce:
   /* yyn is the number of a rule to reduce with.  */
@@ -1414,361 +1587,369 @@ yyreduce:
      GCC warning that YYVAL may be used uninitialized.  */
   yyval = yyvsp[1-yylen];
 
-  /* Default location.  */
+  /* Default location. */
   YYLLOC_DEFAULT (yyloc, (yylsp - yylen), yylen);
+  yyerror_range[1] = yyloc;
   YY_REDUCE_PRINT (yyn);
   switch (yyn)
     {
-        case 2:
-#line 49 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); ast = (yyvsp[0]); }
-#line 1426 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 2: /* start: prog  */
+#line 61 "nanoLangParser.y"
+            { yyval = yyvsp[0]; ast = yyvsp[0]; }
+#line 1600 "nanoLangParser.tab.c"
     break;
 
-  case 3:
-#line 51 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTEmptyAlloc(); }
-#line 1432 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 3: /* prog: %empty  */
+#line 63 "nanoLangParser.y"
+      { yyval = ASTEmptyAlloc(); }
+#line 1606 "nanoLangParser.tab.c"
     break;
 
-  case 4:
-#line 52 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(prog, NULL, 0, (yyvsp[-1]), (yyvsp[0])); }
-#line 1438 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 4: /* prog: prog def  */
+#line 64 "nanoLangParser.y"
+               { yyval = ASTAlloc2(prog, NULL, 0, yyvsp[-1], yyvsp[0]); }
+#line 1612 "nanoLangParser.tab.c"
     break;
 
-  case 5:
-#line 53 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = 0; }
-#line 1444 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 5: /* prog: error def  */
+#line 65 "nanoLangParser.y"
+                { yyval = 0; }
+#line 1618 "nanoLangParser.tab.c"
     break;
 
-  case 6:
-#line 56 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1450 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 6: /* def: vardef  */
+#line 68 "nanoLangParser.y"
+            { yyval = yyvsp[0]; }
+#line 1624 "nanoLangParser.tab.c"
     break;
 
-  case 7:
-#line 57 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1456 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 7: /* def: fundef  */
+#line 69 "nanoLangParser.y"
+            { yyval = yyvsp[0]; }
+#line 1630 "nanoLangParser.tab.c"
     break;
 
-  case 8:
-#line 60 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(vardef, NULL, 0, (yyvsp[-2]), (yyvsp[-1])); ASTFree((yyvsp[0])); }
-#line 1462 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 8: /* vardef: type idlist SEMICOLON  */
+#line 72 "nanoLangParser.y"
+                              { yyval = ASTAlloc2(vardef, NULL, 0, yyvsp[-2], yyvsp[-1]); }
+#line 1636 "nanoLangParser.tab.c"
     break;
 
-  case 9:
-#line 61 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = 0; }
-#line 1468 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 9: /* vardef: error SEMICOLON  */
+#line 73 "nanoLangParser.y"
+                        { yyval = 0; }
+#line 1642 "nanoLangParser.tab.c"
     break;
 
-  case 10:
-#line 64 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1474 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 10: /* idlist: IDENT  */
+#line 76 "nanoLangParser.y"
+              { yyval = yyvsp[0]; }
+#line 1648 "nanoLangParser.tab.c"
     break;
 
-  case 11:
-#line 65 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(idlist, NULL, 0, (yyvsp[-2]), (yyvsp[0])); ASTFree((yyvsp[-1])); }
-#line 1480 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 11: /* idlist: idlist COMMA IDENT  */
+#line 77 "nanoLangParser.y"
+                           { yyval = ASTAlloc2(idlist, NULL, 0, yyvsp[-2], yyvsp[0]); }
+#line 1654 "nanoLangParser.tab.c"
     break;
 
-  case 12:
-#line 68 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc(fundef, NULL, 0, (yyvsp[-5]), (yyvsp[-4]), (yyvsp[-2]), (yyvsp[0])); ASTFree((yyvsp[-3])); ASTFree((yyvsp[-1])); }
-#line 1486 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 12: /* fundef: type IDENT OPENPAR params CLOSEPAR body  */
+#line 80 "nanoLangParser.y"
+                                                { yyval = ASTAlloc(fundef, NULL, 0, yyvsp[-5], yyvsp[-4], yyvsp[-2], yyvsp[0]); }
+#line 1660 "nanoLangParser.tab.c"
     break;
 
-  case 13:
-#line 69 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = 0; }
-#line 1492 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 13: /* fundef: error body  */
+#line 81 "nanoLangParser.y"
+                   { yyval = 0; }
+#line 1666 "nanoLangParser.tab.c"
     break;
 
-  case 14:
-#line 72 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1498 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 14: /* type: STRING  */
+#line 84 "nanoLangParser.y"
+             { yyval = yyvsp[0]; }
+#line 1672 "nanoLangParser.tab.c"
     break;
 
-  case 15:
-#line 73 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1504 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 15: /* type: INTEGER  */
+#line 85 "nanoLangParser.y"
+              { yyval = yyvsp[0]; }
+#line 1678 "nanoLangParser.tab.c"
     break;
 
-  case 16:
-#line 76 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(params, NULL, 0, NULL, NULL); }
-#line 1510 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 16: /* params: %empty  */
+#line 88 "nanoLangParser.y"
+        { yyval = ASTAlloc2(params, NULL, 0, NULL, NULL); }
+#line 1684 "nanoLangParser.tab.c"
     break;
 
-  case 17:
-#line 77 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(params, NULL, 0, (yyvsp[0]), NULL); }
-#line 1516 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 17: /* params: paramlist  */
+#line 89 "nanoLangParser.y"
+                  { yyval = ASTAlloc2(params, NULL, 0, yyvsp[0], NULL); }
+#line 1690 "nanoLangParser.tab.c"
     break;
 
-  case 18:
-#line 80 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1522 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 18: /* paramlist: param  */
+#line 92 "nanoLangParser.y"
+                 { yyval = yyvsp[0]; }
+#line 1696 "nanoLangParser.tab.c"
     break;
 
-  case 19:
-#line 81 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(paramlist, NULL, 0, (yyvsp[-2]), (yyvsp[0])); ASTFree((yyvsp[-1])); }
-#line 1528 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 19: /* paramlist: paramlist COMMA param  */
+#line 93 "nanoLangParser.y"
+                                 { yyval = ASTAlloc2(paramlist, NULL, 0, yyvsp[-2], yyvsp[0]); }
+#line 1702 "nanoLangParser.tab.c"
     break;
 
-  case 20:
-#line 84 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(param, NULL, 0, (yyvsp[-1]), (yyvsp[0])); }
-#line 1534 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 20: /* param: type IDENT  */
+#line 96 "nanoLangParser.y"
+                  { yyval = ASTAlloc2(param, NULL, 0, yyvsp[-1], yyvsp[0]); }
+#line 1708 "nanoLangParser.tab.c"
     break;
 
-  case 21:
-#line 87 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(body, NULL, 0, (yyvsp[-2]), (yyvsp[-1])); ASTFree((yyvsp[-3])); ASTFree((yyvsp[0])); }
-#line 1540 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 21: /* body: OPENCURLY vardefs stmts CLOSECURLY  */
+#line 99 "nanoLangParser.y"
+                                         { yyval = ASTAlloc2(body, NULL, 0, yyvsp[-2], yyvsp[-1]); }
+#line 1714 "nanoLangParser.tab.c"
     break;
 
-  case 22:
-#line 90 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTEmptyAlloc(); }
-#line 1546 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 22: /* vardefs: %empty  */
+#line 102 "nanoLangParser.y"
+         { yyval = ASTEmptyAlloc(); }
+#line 1720 "nanoLangParser.tab.c"
     break;
 
-  case 23:
-#line 91 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(vardefs, NULL, 0, (yyvsp[-1]), (yyvsp[0])); }
-#line 1552 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 23: /* vardefs: vardefs vardef  */
+#line 103 "nanoLangParser.y"
+                        { yyval = ASTAlloc2(vardefs, NULL, 0, yyvsp[-1], yyvsp[0]); }
+#line 1726 "nanoLangParser.tab.c"
     break;
 
-  case 24:
-#line 94 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTEmptyAlloc(); }
-#line 1558 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 24: /* stmts: %empty  */
+#line 106 "nanoLangParser.y"
+       { yyval = ASTEmptyAlloc(); }
+#line 1732 "nanoLangParser.tab.c"
     break;
 
-  case 25:
-#line 95 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(stmts, NULL, 0, (yyvsp[-1]), (yyvsp[0])); }
-#line 1564 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 25: /* stmts: stmts stmt  */
+#line 107 "nanoLangParser.y"
+                  { yyval = ASTAlloc2(stmts, NULL, 0, yyvsp[-1], yyvsp[0]); }
+#line 1738 "nanoLangParser.tab.c"
     break;
 
-  case 26:
-#line 98 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1570 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 26: /* stmt: while_stmt  */
+#line 110 "nanoLangParser.y"
+                 { yyval = yyvsp[0]; }
+#line 1744 "nanoLangParser.tab.c"
     break;
 
-  case 27:
-#line 99 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1576 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 27: /* stmt: if_stmt  */
+#line 111 "nanoLangParser.y"
+              { yyval = yyvsp[0]; }
+#line 1750 "nanoLangParser.tab.c"
     break;
 
-  case 28:
-#line 100 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1582 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 28: /* stmt: ret_stmt  */
+#line 112 "nanoLangParser.y"
+               { yyval = yyvsp[0]; }
+#line 1756 "nanoLangParser.tab.c"
     break;
 
-  case 29:
-#line 101 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1588 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 29: /* stmt: print_stmt  */
+#line 113 "nanoLangParser.y"
+                 { yyval = yyvsp[0]; }
+#line 1762 "nanoLangParser.tab.c"
     break;
 
-  case 30:
-#line 102 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1594 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 30: /* stmt: assign  */
+#line 114 "nanoLangParser.y"
+             { yyval = yyvsp[0]; }
+#line 1768 "nanoLangParser.tab.c"
     break;
 
-  case 31:
-#line 103 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1600 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 31: /* stmt: funcall_stmt  */
+#line 115 "nanoLangParser.y"
+                   { yyval = yyvsp[0]; }
+#line 1774 "nanoLangParser.tab.c"
     break;
 
-  case 32:
-#line 106 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc(while_stmt, NULL, 0, (yyvsp[-4]), (yyvsp[-2]), (yyvsp[0]), NULL); ASTFree((yyvsp[-3]));ASTFree((yyvsp[-1])); }
-#line 1606 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 32: /* while_stmt: WHILE OPENPAR boolexpr CLOSEPAR body  */
+#line 118 "nanoLangParser.y"
+                                                 { yyval = ASTAlloc(while_stmt, NULL, 0, yyvsp[-4], yyvsp[-2], yyvsp[0], NULL); }
+#line 1780 "nanoLangParser.tab.c"
     break;
 
-  case 33:
-#line 109 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc(if_stmt, NULL, 0, (yyvsp[-4]), (yyvsp[-2]), (yyvsp[0]), NULL); ASTFree((yyvsp[-3])); ASTFree((yyvsp[-1])); }
-#line 1612 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 33: /* if_stmt: IF OPENPAR boolexpr CLOSEPAR body  */
+#line 121 "nanoLangParser.y"
+                                           { yyval = ASTAlloc(if_stmt, NULL, 0, yyvsp[-4], yyvsp[-2], yyvsp[0], NULL); }
+#line 1786 "nanoLangParser.tab.c"
     break;
 
-  case 34:
-#line 110 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc(if_stmt, NULL, 0, (yyvsp[-6]), (yyvsp[-4]), (yyvsp[-2]), (yyvsp[0])); ASTFree((yyvsp[-5])); ASTFree((yyvsp[-3])); ASTFree((yyvsp[-1])); }
-#line 1618 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 34: /* if_stmt: IF OPENPAR boolexpr CLOSEPAR body ELSE body  */
+#line 122 "nanoLangParser.y"
+                                                     { yyval = ASTAlloc(if_stmt, NULL, 0, yyvsp[-6], yyvsp[-4], yyvsp[-2], yyvsp[0]); }
+#line 1792 "nanoLangParser.tab.c"
     break;
 
-  case 35:
-#line 113 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(ret_stmt, NULL, 0, (yyvsp[-2]), (yyvsp[-1])); ASTFree((yyvsp[0])); }
-#line 1624 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 35: /* ret_stmt: RETURN expr SEMICOLON  */
+#line 125 "nanoLangParser.y"
+                                { yyval = ASTAlloc2(ret_stmt, NULL, 0, yyvsp[-2], yyvsp[-1]); }
+#line 1798 "nanoLangParser.tab.c"
     break;
 
-  case 36:
-#line 116 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(print_stmt, NULL, 0, (yyvsp[-2]), (yyvsp[-1])); ASTFree((yyvsp[0])); }
-#line 1630 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 36: /* print_stmt: PRINT expr SEMICOLON  */
+#line 128 "nanoLangParser.y"
+                                 { yyval = ASTAlloc2(print_stmt, NULL, 0, yyvsp[-2], yyvsp[-1]); }
+#line 1804 "nanoLangParser.tab.c"
     break;
 
-  case 37:
-#line 119 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(assign, NULL, 0, (yyvsp[-3]), (yyvsp[-1])); ASTFree((yyvsp[-2])); ASTFree((yyvsp[0])); }
-#line 1636 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 37: /* assign: IDENT EQ expr SEMICOLON  */
+#line 131 "nanoLangParser.y"
+                                { yyval = ASTTokenNode2(yyvsp[-2], assign, yyvsp[-3], yyvsp[-1]); }
+#line 1810 "nanoLangParser.tab.c"
     break;
 
-  case 38:
-#line 122 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(funcall_stmt, NULL, 0, (yyvsp[-1]), NULL); ASTFree((yyvsp[0])); }
-#line 1642 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 38: /* funcall_stmt: funcall SEMICOLON  */
+#line 134 "nanoLangParser.y"
+                                { yyval = ASTAlloc2(funcall_stmt, NULL, 0, yyvsp[-1], NULL); }
+#line 1816 "nanoLangParser.tab.c"
     break;
 
-  case 39:
-#line 125 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(t_EQ, NULL, 0, (yyvsp[-2]), (yyvsp[0])); ASTFree((yyvsp[-1])); }
-#line 1648 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 39: /* boolexpr: expr EQ expr  */
+#line 137 "nanoLangParser.y"
+                        { yyval = ASTTokenNode2(yyvsp[-1], t_EQ, yyvsp[-2], yyvsp[0]); }
+#line 1822 "nanoLangParser.tab.c"
     break;
 
-  case 40:
-#line 126 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(t_NEQ, NULL, 0, (yyvsp[-2]), (yyvsp[0])); ASTFree((yyvsp[-1])); }
-#line 1654 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 40: /* boolexpr: expr NEQ expr  */
+#line 138 "nanoLangParser.y"
+                        { yyval = ASTTokenNode2(yyvsp[-1], t_NEQ, yyvsp[-2], yyvsp[0]); }
+#line 1828 "nanoLangParser.tab.c"
     break;
 
-  case 41:
-#line 127 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(t_LT, NULL, 0, (yyvsp[-2]), (yyvsp[0])); ASTFree((yyvsp[-1])); }
-#line 1660 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 41: /* boolexpr: expr LT expr  */
+#line 139 "nanoLangParser.y"
+                       { yyval = ASTTokenNode2(yyvsp[-1], t_LT, yyvsp[-2], yyvsp[0]); }
+#line 1834 "nanoLangParser.tab.c"
     break;
 
-  case 42:
-#line 128 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(t_GT, NULL, 0, (yyvsp[-2]), (yyvsp[0])); ASTFree((yyvsp[-1])); }
-#line 1666 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 42: /* boolexpr: expr GT expr  */
+#line 140 "nanoLangParser.y"
+                       { yyval = ASTTokenNode2(yyvsp[-1], t_GT, yyvsp[-2], yyvsp[0]); }
+#line 1840 "nanoLangParser.tab.c"
     break;
 
-  case 43:
-#line 129 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(t_LEQ, NULL, 0, (yyvsp[-2]), (yyvsp[0])); ASTFree((yyvsp[-1])); }
-#line 1672 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 43: /* boolexpr: expr LEQ expr  */
+#line 141 "nanoLangParser.y"
+                        { yyval = ASTTokenNode2(yyvsp[-1], t_LEQ, yyvsp[-2], yyvsp[0]); }
+#line 1846 "nanoLangParser.tab.c"
     break;
 
-  case 44:
-#line 130 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(t_GEQ, NULL, 0, (yyvsp[-2]), (yyvsp[0])); ASTFree((yyvsp[-1])); }
-#line 1678 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 44: /* boolexpr: expr GEQ expr  */
+#line 142 "nanoLangParser.y"
+                        { yyval = ASTTokenNode2(yyvsp[-1], t_GEQ, yyvsp[-2], yyvsp[0]); }
+#line 1852 "nanoLangParser.tab.c"
     break;
 
-  case 45:
-#line 133 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1684 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 45: /* expr: funcall  */
+#line 145 "nanoLangParser.y"
+              { yyval = yyvsp[0]; }
+#line 1858 "nanoLangParser.tab.c"
     break;
 
-  case 46:
-#line 134 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1690 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 46: /* expr: INTLIT  */
+#line 146 "nanoLangParser.y"
+              { yyval = yyvsp[0]; }
+#line 1864 "nanoLangParser.tab.c"
     break;
 
-  case 47:
-#line 135 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1696 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 47: /* expr: IDENT  */
+#line 147 "nanoLangParser.y"
+              { yyval = yyvsp[0]; }
+#line 1870 "nanoLangParser.tab.c"
     break;
 
-  case 48:
-#line 136 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1702 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 48: /* expr: STRINGLIT  */
+#line 148 "nanoLangParser.y"
+                { yyval = yyvsp[0]; }
+#line 1876 "nanoLangParser.tab.c"
     break;
 
-  case 49:
-#line 137 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[-1]);ASTFree((yyvsp[-2])); ASTFree((yyvsp[0])); }
-#line 1708 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 49: /* expr: OPENPAR expr CLOSEPAR  */
+#line 149 "nanoLangParser.y"
+                            { yyval = yyvsp[-1]; }
+#line 1882 "nanoLangParser.tab.c"
     break;
 
-  case 50:
-#line 138 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(t_PLUS, NULL, 0, (yyvsp[-2]), (yyvsp[0])); ASTFree((yyvsp[-1])); }
-#line 1714 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 50: /* expr: expr PLUS expr  */
+#line 150 "nanoLangParser.y"
+                      { yyval = ASTTokenNode2(yyvsp[-1], t_PLUS, yyvsp[-2], yyvsp[0]); }
+#line 1888 "nanoLangParser.tab.c"
     break;
 
-  case 51:
-#line 139 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(t_MINUS, NULL, 0, (yyvsp[-2]), (yyvsp[0])); ASTFree((yyvsp[-1])); }
-#line 1720 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 51: /* expr: expr MINUS expr  */
+#line 151 "nanoLangParser.y"
+                      { yyval = ASTTokenNode2(yyvsp[-1], t_MINUS, yyvsp[-2], yyvsp[0]); }
+#line 1894 "nanoLangParser.tab.c"
     break;
 
-  case 52:
-#line 140 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(t_MULT, NULL, 0, (yyvsp[-2]), (yyvsp[0])); ASTFree((yyvsp[-1])); }
-#line 1726 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 52: /* expr: expr MULT expr  */
+#line 152 "nanoLangParser.y"
+                      { yyval = ASTTokenNode2(yyvsp[-1], t_MULT, yyvsp[-2], yyvsp[0]); }
+#line 1900 "nanoLangParser.tab.c"
     break;
 
-  case 53:
-#line 141 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(t_DIV, NULL, 0, (yyvsp[-2]), (yyvsp[0])); ASTFree((yyvsp[-1])); }
-#line 1732 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 53: /* expr: expr DIV expr  */
+#line 153 "nanoLangParser.y"
+                      { yyval = ASTTokenNode2(yyvsp[-1], t_DIV, yyvsp[-2], yyvsp[0]); }
+#line 1906 "nanoLangParser.tab.c"
     break;
 
-  case 54:
-#line 142 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(t_MINUS, NULL, 0, (yyvsp[0]), NULL); ASTFree((yyvsp[-1])); }
-#line 1738 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 54: /* expr: MINUS expr  */
+#line 154 "nanoLangParser.y"
+                              { yyval = ASTTokenNode2(yyvsp[-1], t_MINUS, yyvsp[0], NULL); }
+#line 1912 "nanoLangParser.tab.c"
     break;
 
-  case 55:
-#line 145 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(funcall, NULL, 0, (yyvsp[-3]), (yyvsp[-1])); ASTFree((yyvsp[-2])); ASTFree((yyvsp[0])); }
-#line 1744 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 55: /* funcall: IDENT OPENPAR args CLOSEPAR  */
+#line 157 "nanoLangParser.y"
+                                     { yyval = ASTAlloc2(funcall, NULL, 0, yyvsp[-3], yyvsp[-1]);
+                                       yyval->line = yyvsp[-3]->line;
+                                       yyval->column = yyvsp[-3]->column; }
+#line 1920 "nanoLangParser.tab.c"
     break;
 
-  case 56:
-#line 148 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTEmptyAlloc(); }
-#line 1750 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 56: /* args: %empty  */
+#line 162 "nanoLangParser.y"
+      { yyval = ASTEmptyAlloc(); }
+#line 1926 "nanoLangParser.tab.c"
     break;
 
-  case 57:
-#line 149 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1756 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 57: /* args: arglist  */
+#line 163 "nanoLangParser.y"
+              { yyval = yyvsp[0]; }
+#line 1932 "nanoLangParser.tab.c"
     break;
 
-  case 58:
-#line 152 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(arglist, NULL, 0, (yyvsp[0]), NULL); }
-#line 1762 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 58: /* arglist: expr  */
+#line 166 "nanoLangParser.y"
+              { yyval = ASTAlloc2(arglist, NULL, 0, yyvsp[0], NULL);
+                yyval->line = yyvsp[0]->line;
+                yyval->column = yyvsp[0]->column; }
+#line 1940 "nanoLangParser.tab.c"
     break;
 
-  case 59:
-#line 153 "nanoLangParser.y" /* yacc.c:1646  */
-    { (yyval) = ASTAlloc2(arglist, NULL, 0, (yyvsp[-2]), (yyvsp[0])); ASTFree((yyvsp[-1])); }
-#line 1768 "nanoLangParser.tab.c" /* yacc.c:1646  */
+  case 59: /* arglist: arglist COMMA expr  */
+#line 169 "nanoLangParser.y"
+                             { yyval = ASTAlloc2(arglist, NULL, 0, yyvsp[-2], yyvsp[0]);
+                               yyval->line = yyvsp[-2]->line;
+                               yyval->column = yyvsp[-2]->column; }
+#line 1948 "nanoLangParser.tab.c"
     break;
 
 
-#line 1772 "nanoLangParser.tab.c" /* yacc.c:1646  */
+#line 1952 "nanoLangParser.tab.c"
+
       default: break;
     }
   /* User semantic actions sometimes alter yychar, and that requires
@@ -1782,11 +1963,10 @@ yyreduce:
      case of YYERROR or YYBACKUP, subsequent parser actions might lead
      to an incorrect destructor call or verbose syntax error message
      before the lookahead is translated.  */
-  YY_SYMBOL_PRINT ("-> $$ =", yyr1[yyn], &yyval, &yyloc);
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
 
   YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
 
   *++yyvsp = yyval;
   *++yylsp = yyloc;
@@ -1794,14 +1974,13 @@ yyreduce:
   /* Now 'shift' the result of the reduction.  Determine what state
      that goes to, based on the state we popped back to and the rule
      number reduced by.  */
-
-  yyn = yyr1[yyn];
-
-  yystate = yypgoto[yyn - YYNTOKENS] + *yyssp;
-  if (0 <= yystate && yystate <= YYLAST && yycheck[yystate] == *yyssp)
-    yystate = yytable[yystate];
-  else
-    yystate = yydefgoto[yyn - YYNTOKENS];
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
 
   goto yynewstate;
 
@@ -1812,50 +1991,45 @@ yyreduce:
 yyerrlab:
   /* Make sure we have latest lookahead translation.  See comments at
      user semantic actions for why this is necessary.  */
-  yytoken = yychar == YYEMPTY ? YYEMPTY : YYTRANSLATE (yychar);
-
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
   /* If not already recovering from an error, report this error.  */
   if (!yyerrstatus)
     {
       ++yynerrs;
-#if ! YYERROR_VERBOSE
-      yyerror (YY_("syntax error"));
-#else
-# define YYSYNTAX_ERROR yysyntax_error (&yymsg_alloc, &yymsg, \
-                                        yyssp, yytoken)
       {
+        yypcontext_t yyctx
+          = {yyssp, yytoken, &yylloc};
         char const *yymsgp = YY_("syntax error");
         int yysyntax_error_status;
-        yysyntax_error_status = YYSYNTAX_ERROR;
+        yysyntax_error_status = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
         if (yysyntax_error_status == 0)
           yymsgp = yymsg;
-        else if (yysyntax_error_status == 1)
+        else if (yysyntax_error_status == -1)
           {
             if (yymsg != yymsgbuf)
               YYSTACK_FREE (yymsg);
-            yymsg = (char *) YYSTACK_ALLOC (yymsg_alloc);
-            if (!yymsg)
+            yymsg = YY_CAST (char *,
+                             YYSTACK_ALLOC (YY_CAST (YYSIZE_T, yymsg_alloc)));
+            if (yymsg)
               {
-                yymsg = yymsgbuf;
-                yymsg_alloc = sizeof yymsgbuf;
-                yysyntax_error_status = 2;
+                yysyntax_error_status
+                  = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+                yymsgp = yymsg;
               }
             else
               {
-                yysyntax_error_status = YYSYNTAX_ERROR;
-                yymsgp = yymsg;
+                yymsg = yymsgbuf;
+                yymsg_alloc = sizeof yymsgbuf;
+                yysyntax_error_status = YYENOMEM;
               }
           }
         yyerror (yymsgp);
-        if (yysyntax_error_status == 2)
-          goto yyexhaustedlab;
+        if (yysyntax_error_status == YYENOMEM)
+          YYNOMEM;
       }
-# undef YYSYNTAX_ERROR
-#endif
     }
 
   yyerror_range[1] = yylloc;
-
   if (yyerrstatus == 3)
     {
       /* If just tried and failed to reuse lookahead token after an
@@ -1884,14 +2058,12 @@ yyerrlab:
 | yyerrorlab -- error raised explicitly by YYERROR.  |
 `---------------------------------------------------*/
 yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
 
-  /* Pacify compilers like GCC when the user code never invokes
-     YYERROR and the label yyerrorlab therefore never appears in user
-     code.  */
-  if (/*CONSTCOND*/ 0)
-     goto yyerrorlab;
-
-  yyerror_range[1] = yylsp[1-yylen];
   /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
   YYPOPSTACK (yylen);
@@ -1907,13 +2079,14 @@ yyerrorlab:
 yyerrlab1:
   yyerrstatus = 3;      /* Each real token shifted decrements this.  */
 
+  /* Pop stack until we find a state that shifts the error token.  */
   for (;;)
     {
       yyn = yypact[yystate];
       if (!yypact_value_is_default (yyn))
         {
-          yyn += YYTERROR;
-          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR)
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
             {
               yyn = yytable[yyn];
               if (0 < yyn)
@@ -1927,7 +2100,7 @@ yyerrlab1:
 
       yyerror_range[1] = *yylsp;
       yydestruct ("Error: popping",
-                  yystos[yystate], yyvsp, yylsp);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, yylsp);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -1938,13 +2111,11 @@ yyerrlab1:
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 
   yyerror_range[2] = yylloc;
-  /* Using YYLLOC is tempting, but would change the location of
-     the lookahead.  YYLOC is available though.  */
-  YYLLOC_DEFAULT (yyloc, yyerror_range, 2);
-  *++yylsp = yyloc;
+  ++yylsp;
+  YYLLOC_DEFAULT (*yylsp, yyerror_range, 2);
 
   /* Shift the error token.  */
-  YY_SYMBOL_PRINT ("Shifting", yystos[yyn], yyvsp, yylsp);
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
   yystate = yyn;
   goto yynewstate;
@@ -1955,26 +2126,30 @@ yyerrlab1:
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
+
 
 /*-----------------------------------.
 | yyabortlab -- YYABORT comes here.  |
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
+
 
-#if !defined yyoverflow || YYERROR_VERBOSE
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
   yyerror (YY_("memory exhausted"));
   yyresult = 2;
-  /* Fall through.  */
-#endif
+  goto yyreturnlab;
+
 
-yyreturn:
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
   if (yychar != YYEMPTY)
     {
       /* Make sure we have latest lookahead translation.  See comments at
@@ -1990,20 +2165,19 @@ yyreturn:
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-                  yystos[*yyssp], yyvsp, yylsp);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, yylsp);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
   if (yyss != yyssa)
     YYSTACK_FREE (yyss);
 #endif
-#if YYERROR_VERBOSE
   if (yymsg != yymsgbuf)
     YYSTACK_FREE (yymsg);
-#endif
   return yyresult;
 }
-#line 157 "nanoLangParser.y" /* yacc.c:1906  */
+
+#line 175 "nanoLangParser.y"
 
 
 
@@ -2022,49 +2196,172 @@ int main (int argc, char* argv[])
   int res;
   bool printdot   = false;
   bool printsexpr = false;
+  bool printcsexpr= false;
+  bool use_arena  = true;
+  bool printstats = false;
+  bool use_mmap   = false;
+  bool run        = false;
+  bool use_vm     = false;
+  bool use_jit    = false;
+  bool printbc    = false;
+  bool printir    = false;
+  bool emitc      = false;
+  bool emitasm    = false;
+  bool optimize   = true;
+  bool line_buffered = false;
+  Arena_p unit_arena = NULL;
 
    ++argv, --argc;  /* skip over program name */
 
-   if (argc > 0)
+   while(argc > 0 && strncmp(argv[0], "--", 2)==0)
    {
       if(strcmp(argv[0], "--dot")==0)
       {
          printdot   = true;
          printsexpr = false;
-         ++argv, --argc;
       }
       else if(strcmp(argv[0], "--sexpr")==0)
       {
          printdot   = false;
          printsexpr = true;
-         ++argv, --argc;
       }
+      else if(strcmp(argv[0], "--csexpr")==0)
+      {
+         printcsexpr = true;
+      }
+      else if(strcmp(argv[0], "--no-arena")==0)
+      {
+         use_arena = false;
+      }
+      else if(strcmp(argv[0], "--no-opt")==0)
+      {
+         optimize = false;
+      }
+      else if(strncmp(argv[0], "--inline-growth=", 16)==0)
+      {
+         opt_inline_growth = atol(argv[0]+16);
+      }
+      else if(strcmp(argv[0], "--mmap")==0)
+      {
+         use_mmap = true;
+      }
+      else if(strcmp(argv[0], "--stats")==0)
+      {
+         printstats = true;
+      }
+      else if(strcmp(argv[0], "--run")==0)
+      {
+         run = true;
+      }
+      else if(strcmp(argv[0], "--vm")==0)
+      {
+         run    = true;
+         use_vm = true;
+      }
+      else if(strcmp(argv[0], "--jit")==0)
+      {
+         run     = true;
+         use_jit = true;
+      }
+      else if(strcmp(argv[0], "--bytecode")==0)
+      {
+         printbc = true;
+      }
+      else if(strcmp(argv[0], "--ir")==0)
+      {
+         printir = true;
+      }
+      else if(strcmp(argv[0], "--emit-c")==0)
+      {
+         emitc = true;
+      }
+      else if(strcmp(argv[0], "--emit-asm")==0)
+      {
+         emitasm = true;
+      }
+      else if(strcmp(argv[0], "--line-buffered")==0)
+      {
+         line_buffered = true;
+      }
+      else
+      {
+         fprintf(stderr, "Unknown option: %s\n", argv[0]);
+         exit(EXIT_FAILURE);
+      }
+      ++argv, --argc;
    }
 
-   if ( argc > 0 )
+   if ( argc > 0 && use_mmap )
+   {
+      if(!yyscan_mmap(argv[0]))
+      {
+         perror(argv[0]);
+         exit(EXIT_FAILURE);
+      }
+   }
+   else if ( argc > 0 )
    {
       yyin = fopen( argv[0], "r" );
+      if(!yyin)
+      {
+         perror(argv[0]);
+         exit(EXIT_FAILURE);
+      }
    }
    else
    {
       yyin = stdin;
    }
 
+   /* All AST nodes of this compilation unit live in one arena and are
+      released together at the end. */
+   if(use_arena)
+   {
+      unit_arena = ArenaAlloc(0);
+      ASTSetArena(unit_arena);
+   }
+
    res = yyparse();
+   yyscan_unmap();
+
+   if(printstats)
+   {
+      fprintf(stderr, "# Scanned %ld bytes, allocated %ld AST cells "
+              "(%.3f per byte)\n", yyscanned, nodectr,
+              yyscanned? (double)nodectr/yyscanned : 0.0);
+   }
 
    if(res==0)
    {
-      bool no_errors;
+      bool     no_errors;
+      FILE     *c_out = NULL;
+      IRProg_p ir = NULL;
 
       TypeTable_p   tt = TypeTableAlloc();
       SymbolTable_p st = SymbolTableAlloc();
 
-      no_errors = STBuildAllTables(st, tt, ast);
-      fprintf(stdout,"Global symbols:\n---------------\n");
-      SymbolTablePrintLocal(stdout, st, tt);
-      SymbolTablePrintGlobal(stdout, st->context, tt);
-      fprintf(stdout,"\nTypes:\n------\n");
-      TypeTablePrint(stdout, tt);
+      if(emitc || emitasm)
+      {
+         /* Diagnostics go to stdout - keep them out of the code */
+         fflush(stdout);
+         c_out = fdopen(dup(STDOUT_FILENO), "w");
+         if(!c_out || dup2(STDERR_FILENO, STDOUT_FILENO) < 0)
+         {
+            perror(emitc? "--emit-c" : "--emit-asm");
+            exit(EXIT_FAILURE);
+         }
+      }
+      no_errors = ASTSemanticCheck(st, tt, ast);
+
+      /* Tables and trees as parsed (and annotated), before the
+         optimizer rewrites them */
+      if(!run && !printbc && !printir && !emitc && !emitasm)
+      {
+         fprintf(stdout,"Global symbols:\n---------------\n");
+         SymbolTablePrintLocal(stdout, st, tt);
+         fprintf(stdout,"\nTypes:\n------\n");
+         TypeTablePrint(stdout, tt);
+      }
 
       if(printdot)
       {
@@ -2075,6 +2372,139 @@ int main (int argc, char* argv[])
          SExprASTPrint(stdout, ast);
          printf("\n");
       }
+      if(printcsexpr || printstats)
+      {
+         CompactAST_p cast = CompactASTAlloc();
+
+         ASTCompact(cast, ast);
+         if(printcsexpr)
+         {
+            CompactASTSExprPrint(stdout, cast, cast->root);
+            printf("\n");
+         }
+         if(printstats)
+         {
+            fprintf(stderr, "# Pointer AST: %ld bytes, compact AST: %u nodes, "
+                    "%zu bytes\n", nodectr*(long)sizeof(ASTCell),
+                    cast->node_ctr-1, CompactASTBytes(cast));
+         }
+         CompactASTFree(cast);
+      }
+
+      if(no_errors && optimize &&
+         (run || printbc || printir || emitc || emitasm))
+      {
+         OptStatsCell opt_stats = {0};
+
+         ASTOptimize(st, ast, &opt_stats);
+         if(printstats)
+         {
+            fprintf(stderr, "# Optimizer: %ld operations folded, "
+                    "%ld constants propagated, %ld dead nodes removed, "
+                    "%ld calls inlined\n",
+                    opt_stats.folded, opt_stats.propagated,
+                    opt_stats.removed, opt_stats.inlined);
+         }
+      }
+      if(no_errors && (emitc || emitasm || printir || printbc ||
+                       use_vm || use_jit))
+      {
+         /* Everything but the interpreter works on the SSA IR */
+         ir = IRBuild(st, ast);
+         /* The JIT keeps all variables in memory, where a new
+            induction variable costs more than the multiplication */
+         ir->reduce = !use_jit;
+         if(optimize)
+         {
+            IRStatsCell ir_stats = {{0}};
+
+            IROptimize(ir, &ir_stats);
+            if(printstats)
+            {
+               IRPrintStats(stderr, &ir_stats);
+            }
+         }
+         if(printir)
+         {
+            IRPrint(stdout, ir);
+         }
+      }
+      if(!no_errors)
+      {
+         res = EXIT_FAILURE;
+      }
+      else if(emitc)
+      {
+         CGenProgram(c_out, ir, line_buffered);
+         fclose(c_out);
+      }
+      else if(emitasm)
+      {
+         VMProg_p prog = BCCompile(ir);
+
+         ASGenProgram(c_out, st, prog, line_buffered);
+         fclose(c_out);
+         VMProgFree(prog);
+      }
+      else if(run || printbc)
+      {
+         /* Remaining arguments are passed to main(), the result of
+            main() is our exit status */
+         if(use_vm || use_jit || printbc)
+         {
+            VMProg_p  prog = BCCompile(ir);
+            JITProg_p jit  = NULL;
+
+            if(printbc)
+            {
+               BCPrint(stdout, prog);
+            }
+            if(use_jit)
+            {
+               jit = JITCompile(prog);
+               if(!jit)
+               {
+                  fprintf(stderr, "# No native code here, using the VM\n");
+               }
+            }
+            /* All literals are in, the program cannot change them */
+            NanoStrPoolSeal();
+            NanoOutInit(line_buffered);
+            if(jit)
+            {
+               res = (int)JITRun(jit, argc? argc-1 : 0, argv+1);
+               JITProgFree(jit);
+            }
+            else if(run)
+            {
+               res = (int)VMRun(prog, argc? argc-1 : 0, argv+1);
+            }
+            VMProgFree(prog);
+         }
+         else
+         {
+            /* As above, but the interpreter decodes literals lazily */
+            InterpDecodeLiterals(ast);
+            NanoStrPoolSeal();
+            NanoOutInit(line_buffered);
+            res = (int)InterpRun(st, ast, argc? argc-1 : 0, argv+1);
+         }
+         if(run && printstats)
+         {
+            NanoOutPrintStats(stderr);
+         }
+      }
+      if(ir)
+      {
+         IRProgFree(ir);
+      }
+   }
+   if(unit_arena)
+   {
+      ASTSetArena(NULL);
+      ArenaFree(unit_arena);
    }
+   StrInternFree();
+   NanoStrPoolFree();
    return res;
 }
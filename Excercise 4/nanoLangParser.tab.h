@@ -1,8 +1,9 @@
-/* A Bison parser, made by GNU Bison 3.0.4.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison interface for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2015 Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
    This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
@@ -15,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -30,6 +31,10 @@
    This special exception was added by the Free Software Foundation in
    version 2.2 of Bison.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 #ifndef YY_YY_NANOLANGPARSER_TAB_H_INCLUDED
 # define YY_YY_NANOLANGPARSER_TAB_H_INCLUDED
 /* Debug traces.  */
@@ -40,40 +45,45 @@
 extern int yydebug;
 #endif
 
-/* Token type.  */
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
   enum yytokentype
   {
-    IDENT = 258,
-    STRINGLIT = 259,
-    INTLIT = 260,
-    INTEGER = 261,
-    STRING = 262,
-    IF = 263,
-    WHILE = 264,
-    RETURN = 265,
-    PRINT = 266,
-    ELSE = 267,
-    EQ = 268,
-    NEQ = 269,
-    LT = 270,
-    GT = 271,
-    LEQ = 272,
-    GEQ = 273,
-    PLUS = 274,
-    MINUS = 275,
-    MULT = 276,
-    DIV = 277,
-    UMINUS = 278,
-    OPENPAR = 279,
-    CLOSEPAR = 280,
-    SEMICOLON = 281,
-    COMMA = 282,
-    OPENCURLY = 283,
-    CLOSECURLY = 284,
-    ERROR = 285
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    IDENT = 258,                   /* IDENT  */
+    STRINGLIT = 259,               /* STRINGLIT  */
+    INTLIT = 260,                  /* INTLIT  */
+    INTEGER = 261,                 /* INTEGER  */
+    STRING = 262,                  /* STRING  */
+    IF = 263,                      /* IF  */
+    WHILE = 264,                   /* WHILE  */
+    RETURN = 265,                  /* RETURN  */
+    PRINT = 266,                   /* PRINT  */
+    ELSE = 267,                    /* ELSE  */
+    EQ = 268,                      /* EQ  */
+    NEQ = 269,                     /* NEQ  */
+    LT = 270,                      /* LT  */
+    GT = 271,                      /* GT  */
+    LEQ = 272,                     /* LEQ  */
+    GEQ = 273,                     /* GEQ  */
+    PLUS = 274,                    /* PLUS  */
+    MINUS = 275,                   /* MINUS  */
+    MULT = 276,                    /* MULT  */
+    DIV = 277,                     /* DIV  */
+    UMINUS = 278,                  /* UMINUS  */
+    OPENPAR = 279,                 /* OPENPAR  */
+    CLOSEPAR = 280,                /* CLOSEPAR  */
+    SEMICOLON = 281,               /* SEMICOLON  */
+    COMMA = 282,                   /* COMMA  */
+    OPENCURLY = 283,               /* OPENCURLY  */
+    CLOSECURLY = 284,              /* CLOSECURLY  */
+    ERROR = 285                    /* ERROR  */
   };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
 
 /* Value type.  */
@@ -100,6 +110,8 @@ struct YYLTYPE
 
 extern YYSTYPE yylval;
 extern YYLTYPE yylloc;
+
 int yyparse (void);
 
+
 #endif /* !YY_YY_NANOLANGPARSER_TAB_H_INCLUDED  */
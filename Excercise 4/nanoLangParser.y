@@ -7,14 +7,26 @@
    #include <stdio.h>
    #include <stdlib.h>
    #include <stdarg.h>
+   #include <unistd.h>
    #include "ast.h"
    #include "types.h"
    #include "semantic.h"
+   #include "compactast.h"
+   #include "interp.h"
+   #include "vm.h"
+   #include "jit.h"
+   #include "cgen.h"
+   #include "asmgen.h"
+   #include "optimize.h"
+   #include "irpass.h"
 
    extern int yylex(void);
    extern int yylineno;
    extern int yycolno;
+   extern long yyscanned;
    extern FILE *yyin;
+   extern bool yyscan_mmap(const char* path);
+   extern void yyscan_unmap(void);
    void yyerror(const char *err, ...);
 
    AST_p ast;
@@ -57,15 +69,15 @@ def: vardef { $$ = $1; }
    | fundef { $$ = $1; }
 ;
 
-vardef: type idlist SEMICOLON { $$ = ASTAlloc2(vardef, NULL, 0, $1, $2); ASTFree($3); }
+vardef: type idlist SEMICOLON { $$ = ASTAlloc2(vardef, NULL, 0, $1, $2); }
       | error SEMICOLON { $$ = 0; }
 ;
 
 idlist: IDENT { $$ = $1; }
-      | idlist COMMA IDENT { $$ = ASTAlloc2(idlist, NULL, 0, $1, $3); ASTFree($2); }
+      | idlist COMMA IDENT { $$ = ASTAlloc2(idlist, NULL, 0, $1, $3); }
 ;
 
-fundef: type IDENT OPENPAR params CLOSEPAR body { $$ = ASTAlloc(fundef, NULL, 0, $1, $2, $4, $6); ASTFree($3); ASTFree($5); }
+fundef: type IDENT OPENPAR params CLOSEPAR body { $$ = ASTAlloc(fundef, NULL, 0, $1, $2, $4, $6); }
       | error body { $$ = 0; }
 ;
 
@@ -78,13 +90,13 @@ params: { $$ = ASTAlloc2(params, NULL, 0, NULL, NULL); }
 ;
 
 paramlist: param { $$ = $1; }
-         | paramlist COMMA param { $$ = ASTAlloc2(paramlist, NULL, 0, $1, $3); ASTFree($2); }
+         | paramlist COMMA param { $$ = ASTAlloc2(paramlist, NULL, 0, $1, $3); }
 ;
 
 param: type IDENT { $$ = ASTAlloc2(param, NULL, 0, $1, $2); }
 ;
 
-body: OPENCURLY vardefs stmts CLOSECURLY { $$ = ASTAlloc2(body, NULL, 0, $2, $3); ASTFree($1); ASTFree($4); }
+body: OPENCURLY vardefs stmts CLOSECURLY { $$ = ASTAlloc2(body, NULL, 0, $2, $3); }
 ;
 
 vardefs: { $$ = ASTEmptyAlloc(); }
@@ -103,54 +115,60 @@ stmt: while_stmt { $$ = $1; }
     | funcall_stmt { $$ = $1; }
 ;
 
-while_stmt: WHILE OPENPAR boolexpr CLOSEPAR body { $$ = ASTAlloc(while_stmt, NULL, 0, $1, $3, $5, NULL); ASTFree($2);ASTFree($4); }
+while_stmt: WHILE OPENPAR boolexpr CLOSEPAR body { $$ = ASTAlloc(while_stmt, NULL, 0, $1, $3, $5, NULL); }
 ;
 
-if_stmt: IF OPENPAR boolexpr CLOSEPAR body { $$ = ASTAlloc(if_stmt, NULL, 0, $1, $3, $5, NULL); ASTFree($2); ASTFree($4); }
-       | IF OPENPAR boolexpr CLOSEPAR body ELSE body { $$ = ASTAlloc(if_stmt, NULL, 0, $1, $3, $5, $7); ASTFree($2); ASTFree($4); ASTFree($6); }
+if_stmt: IF OPENPAR boolexpr CLOSEPAR body { $$ = ASTAlloc(if_stmt, NULL, 0, $1, $3, $5, NULL); }
+       | IF OPENPAR boolexpr CLOSEPAR body ELSE body { $$ = ASTAlloc(if_stmt, NULL, 0, $1, $3, $5, $7); }
 ;
 
-ret_stmt: RETURN expr SEMICOLON { $$ = ASTAlloc2(ret_stmt, NULL, 0, $1, $2); ASTFree($3); }
+ret_stmt: RETURN expr SEMICOLON { $$ = ASTAlloc2(ret_stmt, NULL, 0, $1, $2); }
 ;
 
-print_stmt: PRINT expr SEMICOLON { $$ = ASTAlloc2(print_stmt, NULL, 0, $1, $2); ASTFree($3); }
+print_stmt: PRINT expr SEMICOLON { $$ = ASTAlloc2(print_stmt, NULL, 0, $1, $2); }
 ;
 
-assign: IDENT EQ expr SEMICOLON { $$ = ASTAlloc2(assign, NULL, 0, $1, $3); ASTFree($2); ASTFree($4); }
+assign: IDENT EQ expr SEMICOLON { $$ = ASTTokenNode2($2, assign, $1, $3); }
 ;
 
-funcall_stmt: funcall SEMICOLON { $$ = ASTAlloc2(funcall_stmt, NULL, 0, $1, NULL); ASTFree($2); }
+funcall_stmt: funcall SEMICOLON { $$ = ASTAlloc2(funcall_stmt, NULL, 0, $1, NULL); }
 ;
 
-boolexpr: expr EQ expr  { $$ = ASTAlloc2(t_EQ, NULL, 0, $1, $3); ASTFree($2); }
-        | expr NEQ expr { $$ = ASTAlloc2(t_NEQ, NULL, 0, $1, $3); ASTFree($2); }
-        | expr LT expr { $$ = ASTAlloc2(t_LT, NULL, 0, $1, $3); ASTFree($2); }
-        | expr GT expr { $$ = ASTAlloc2(t_GT, NULL, 0, $1, $3); ASTFree($2); }
-        | expr LEQ expr { $$ = ASTAlloc2(t_LEQ, NULL, 0, $1, $3); ASTFree($2); }
-        | expr GEQ expr { $$ = ASTAlloc2(t_GEQ, NULL, 0, $1, $3); ASTFree($2); }
+boolexpr: expr EQ expr  { $$ = ASTTokenNode2($2, t_EQ, $1, $3); }
+        | expr NEQ expr { $$ = ASTTokenNode2($2, t_NEQ, $1, $3); }
+        | expr LT expr { $$ = ASTTokenNode2($2, t_LT, $1, $3); }
+        | expr GT expr { $$ = ASTTokenNode2($2, t_GT, $1, $3); }
+        | expr LEQ expr { $$ = ASTTokenNode2($2, t_LEQ, $1, $3); }
+        | expr GEQ expr { $$ = ASTTokenNode2($2, t_GEQ, $1, $3); }
 ;
 
 expr: funcall { $$ = $1; }
     | INTLIT  { $$ = $1; }
     | IDENT   { $$ = $1; }
     | STRINGLIT { $$ = $1; }
-    | OPENPAR expr CLOSEPAR { $$ = $2;ASTFree($1); ASTFree($3); }
-    | expr PLUS expr  { $$ = ASTAlloc2(t_PLUS, NULL, 0, $1, $3); ASTFree($2); }
-    | expr MINUS expr { $$ = ASTAlloc2(t_MINUS, NULL, 0, $1, $3); ASTFree($2); }
-    | expr MULT expr  { $$ = ASTAlloc2(t_MULT, NULL, 0, $1, $3); ASTFree($2); }
-    | expr DIV expr   { $$ = ASTAlloc2(t_DIV, NULL, 0, $1, $3); ASTFree($2); }
-    | MINUS expr %prec UMINUS { $$ = ASTAlloc2(t_MINUS, NULL, 0, $2, NULL); ASTFree($1); }
+    | OPENPAR expr CLOSEPAR { $$ = $2; }
+    | expr PLUS expr  { $$ = ASTTokenNode2($2, t_PLUS, $1, $3); }
+    | expr MINUS expr { $$ = ASTTokenNode2($2, t_MINUS, $1, $3); }
+    | expr MULT expr  { $$ = ASTTokenNode2($2, t_MULT, $1, $3); }
+    | expr DIV expr   { $$ = ASTTokenNode2($2, t_DIV, $1, $3); }
+    | MINUS expr %prec UMINUS { $$ = ASTTokenNode2($1, t_MINUS, $2, NULL); }
 ;
 
-funcall: IDENT OPENPAR args CLOSEPAR { $$ = ASTAlloc2(funcall, NULL, 0, $1, $3); ASTFree($2); ASTFree($4); }
+funcall: IDENT OPENPAR args CLOSEPAR { $$ = ASTAlloc2(funcall, NULL, 0, $1, $3);
+                                       $$->line = $1->line;
+                                       $$->column = $1->column; }
 ;
 
 args: { $$ = ASTEmptyAlloc(); }
     | arglist { $$ = $1; }
 ;
 
-arglist: expr { $$ = ASTAlloc2(arglist, NULL, 0, $1, NULL); }
-       | arglist COMMA expr  { $$ = ASTAlloc2(arglist, NULL, 0, $1, $3); ASTFree($2); }
+arglist: expr { $$ = ASTAlloc2(arglist, NULL, 0, $1, NULL);
+                $$->line = $1->line;
+                $$->column = $1->column; }
+       | arglist COMMA expr  { $$ = ASTAlloc2(arglist, NULL, 0, $1, $3);
+                               $$->line = $1->line;
+                               $$->column = $1->column; }
 ;
 
 
@@ -172,48 +190,172 @@ int main (int argc, char* argv[])
   int res;
   bool printdot   = false;
   bool printsexpr = false;
+  bool printcsexpr= false;
+  bool use_arena  = true;
+  bool printstats = false;
+  bool use_mmap   = false;
+  bool run        = false;
+  bool use_vm     = false;
+  bool use_jit    = false;
+  bool printbc    = false;
+  bool printir    = false;
+  bool emitc      = false;
+  bool emitasm    = false;
+  bool optimize   = true;
+  bool line_buffered = false;
+  Arena_p unit_arena = NULL;
 
    ++argv, --argc;  /* skip over program name */
 
-   if (argc > 0)
+   while(argc > 0 && strncmp(argv[0], "--", 2)==0)
    {
       if(strcmp(argv[0], "--dot")==0)
       {
          printdot   = true;
          printsexpr = false;
-         ++argv, --argc;
       }
       else if(strcmp(argv[0], "--sexpr")==0)
       {
          printdot   = false;
          printsexpr = true;
-         ++argv, --argc;
       }
+      else if(strcmp(argv[0], "--csexpr")==0)
+      {
+         printcsexpr = true;
+      }
+      else if(strcmp(argv[0], "--no-arena")==0)
+      {
+         use_arena = false;
+      }
+      else if(strcmp(argv[0], "--no-opt")==0)
+      {
+         optimize = false;
+      }
+      else if(strncmp(argv[0], "--inline-growth=", 16)==0)
+      {
+         opt_inline_growth = atol(argv[0]+16);
+      }
+      else if(strcmp(argv[0], "--mmap")==0)
+      {
+         use_mmap = true;
+      }
+      else if(strcmp(argv[0], "--stats")==0)
+      {
+         printstats = true;
+      }
+      else if(strcmp(argv[0], "--run")==0)
+      {
+         run = true;
+      }
+      else if(strcmp(argv[0], "--vm")==0)
+      {
+         run    = true;
+         use_vm = true;
+      }
+      else if(strcmp(argv[0], "--jit")==0)
+      {
+         run     = true;
+         use_jit = true;
+      }
+      else if(strcmp(argv[0], "--bytecode")==0)
+      {
+         printbc = true;
+      }
+      else if(strcmp(argv[0], "--ir")==0)
+      {
+         printir = true;
+      }
+      else if(strcmp(argv[0], "--emit-c")==0)
+      {
+         emitc = true;
+      }
+      else if(strcmp(argv[0], "--emit-asm")==0)
+      {
+         emitasm = true;
+      }
+      else if(strcmp(argv[0], "--line-buffered")==0)
+      {
+         line_buffered = true;
+      }
+      else
+      {
+         fprintf(stderr, "Unknown option: %s\n", argv[0]);
+         exit(EXIT_FAILURE);
+      }
+      ++argv, --argc;
    }
 
-   if ( argc > 0 )
+   if ( argc > 0 && use_mmap )
+   {
+      if(!yyscan_mmap(argv[0]))
+      {
+         perror(argv[0]);
+         exit(EXIT_FAILURE);
+      }
+   }
+   else if ( argc > 0 )
    {
       yyin = fopen( argv[0], "r" );
+      if(!yyin)
+      {
+         perror(argv[0]);
+         exit(EXIT_FAILURE);
+      }
    }
    else
    {
       yyin = stdin;
    }
 
+   /* All AST nodes of this compilation unit live in one arena and are
+      released together at the end. */
+   if(use_arena)
+   {
+      unit_arena = ArenaAlloc(0);
+      ASTSetArena(unit_arena);
+   }
+
    res = yyparse();
+   yyscan_unmap();
+
+   if(printstats)
+   {
+      fprintf(stderr, "# Scanned %ld bytes, allocated %ld AST cells "
+              "(%.3f per byte)\n", yyscanned, nodectr,
+              yyscanned? (double)nodectr/yyscanned : 0.0);
+   }
 
    if(res==0)
    {
-      bool no_errors;
+      bool     no_errors;
+      FILE     *c_out = NULL;
+      IRProg_p ir = NULL;
 
       TypeTable_p   tt = TypeTableAlloc();
       SymbolTable_p st = SymbolTableAlloc();
 
-      no_errors = STBuildAllTables(st, tt, ast);
-      fprintf(stdout,"Global symbols:\n---------------\n");
-      SymbolTablePrintLocal(stdout, st, tt);
-      fprintf(stdout,"\nTypes:\n------\n");
-      TypeTablePrint(stdout, tt);
+      if(emitc || emitasm)
+      {
+         /* Diagnostics go to stdout - keep them out of the code */
+         fflush(stdout);
+         c_out = fdopen(dup(STDOUT_FILENO), "w");
+         if(!c_out || dup2(STDERR_FILENO, STDOUT_FILENO) < 0)
+         {
+            perror(emitc? "--emit-c" : "--emit-asm");
+            exit(EXIT_FAILURE);
+         }
+      }
+      no_errors = ASTSemanticCheck(st, tt, ast);
+
+      /* Tables and trees as parsed (and annotated), before the
+         optimizer rewrites them */
+      if(!run && !printbc && !printir && !emitc && !emitasm)
+      {
+         fprintf(stdout,"Global symbols:\n---------------\n");
+         SymbolTablePrintLocal(stdout, st, tt);
+         fprintf(stdout,"\nTypes:\n------\n");
+         TypeTablePrint(stdout, tt);
+      }
 
       if(printdot)
       {
@@ -224,6 +366,139 @@ int main (int argc, char* argv[])
          SExprASTPrint(stdout, ast);
          printf("\n");
       }
+      if(printcsexpr || printstats)
+      {
+         CompactAST_p cast = CompactASTAlloc();
+
+         ASTCompact(cast, ast);
+         if(printcsexpr)
+         {
+            CompactASTSExprPrint(stdout, cast, cast->root);
+            printf("\n");
+         }
+         if(printstats)
+         {
+            fprintf(stderr, "# Pointer AST: %ld bytes, compact AST: %u nodes, "
+                    "%zu bytes\n", nodectr*(long)sizeof(ASTCell),
+                    cast->node_ctr-1, CompactASTBytes(cast));
+         }
+         CompactASTFree(cast);
+      }
+
+      if(no_errors && optimize &&
+         (run || printbc || printir || emitc || emitasm))
+      {
+         OptStatsCell opt_stats = {0};
+
+         ASTOptimize(st, ast, &opt_stats);
+         if(printstats)
+         {
+            fprintf(stderr, "# Optimizer: %ld operations folded, "
+                    "%ld constants propagated, %ld dead nodes removed, "
+                    "%ld calls inlined\n",
+                    opt_stats.folded, opt_stats.propagated,
+                    opt_stats.removed, opt_stats.inlined);
+         }
+      }
+      if(no_errors && (emitc || emitasm || printir || printbc ||
+                       use_vm || use_jit))
+      {
+         /* Everything but the interpreter works on the SSA IR */
+         ir = IRBuild(st, ast);
+         /* The JIT keeps all variables in memory, where a new
+            induction variable costs more than the multiplication */
+         ir->reduce = !use_jit;
+         if(optimize)
+         {
+            IRStatsCell ir_stats = {{0}};
+
+            IROptimize(ir, &ir_stats);
+            if(printstats)
+            {
+               IRPrintStats(stderr, &ir_stats);
+            }
+         }
+         if(printir)
+         {
+            IRPrint(stdout, ir);
+         }
+      }
+      if(!no_errors)
+      {
+         res = EXIT_FAILURE;
+      }
+      else if(emitc)
+      {
+         CGenProgram(c_out, ir, line_buffered);
+         fclose(c_out);
+      }
+      else if(emitasm)
+      {
+         VMProg_p prog = BCCompile(ir);
+
+         ASGenProgram(c_out, st, prog, line_buffered);
+         fclose(c_out);
+         VMProgFree(prog);
+      }
+      else if(run || printbc)
+      {
+         /* Remaining arguments are passed to main(), the result of
+            main() is our exit status */
+         if(use_vm || use_jit || printbc)
+         {
+            VMProg_p  prog = BCCompile(ir);
+            JITProg_p jit  = NULL;
+
+            if(printbc)
+            {
+               BCPrint(stdout, prog);
+            }
+            if(use_jit)
+            {
+               jit = JITCompile(prog);
+               if(!jit)
+               {
+                  fprintf(stderr, "# No native code here, using the VM\n");
+               }
+            }
+            /* All literals are in, the program cannot change them */
+            NanoStrPoolSeal();
+            NanoOutInit(line_buffered);
+            if(jit)
+            {
+               res = (int)JITRun(jit, argc? argc-1 : 0, argv+1);
+               JITProgFree(jit);
+            }
+            else if(run)
+            {
+               res = (int)VMRun(prog, argc? argc-1 : 0, argv+1);
+            }
+            VMProgFree(prog);
+         }
+         else
+         {
+            /* As above, but the interpreter decodes literals lazily */
+            InterpDecodeLiterals(ast);
+            NanoStrPoolSeal();
+            NanoOutInit(line_buffered);
+            res = (int)InterpRun(st, ast, argc? argc-1 : 0, argv+1);
+         }
+         if(run && printstats)
+         {
+            NanoOutPrintStats(stderr);
+         }
+      }
+      if(ir)
+      {
+         IRProgFree(ir);
+      }
+   }
+   if(unit_arena)
+   {
+      ASTSetArena(NULL);
+      ArenaFree(unit_arena);
    }
+   StrInternFree();
+   NanoStrPoolFree();
    return res;
 }
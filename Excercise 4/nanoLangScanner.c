@@ -542,18 +542,39 @@ char *yytext;
 */
 #line 9 "nanoLangScanner.l"
   # include <string.h>
+  # include <fcntl.h>
+  # include <unistd.h>
+  # include <sys/mman.h>
+  # include <sys/stat.h>
   # include "ast.h"
   # include "nanoLangParser.tab.h"
 
 
-  int yycolno = 1;
+  int  yycolno = 1;
+  long yyscanned = 0; /* Number of bytes scanned so far */
   void yyerror(char *err, ...);
 
+  /* Every token travels with its location in yylloc. Only tokens
+     that carry a semantic value (identifiers, literals, operators,
+     types and keywords that show up in the AST) get an AST cell -
+     whitespace, comments and punctuation do not allocate at all. */
   #define YY_USER_ACTION {\
-      yylval=ASTEmptyAlloc();\
-      yylval->litval = strdup(yytext);\
+      yylloc.first_line = yylloc.last_line = yylineno;\
+      yylloc.first_column = yycolno;\
+      yycolno += yyleng;\
+      yylloc.last_column = yycolno-1;\
+      yyscanned += yyleng;\
+      yylval = NULL;\
    }
-#line 557 "<stdout>"
+
+  #define TOKEN_CELL(ttype) {\
+      yylval = ASTEmptyAlloc();\
+      yylval->type   = (ttype);\
+      yylval->litval = StrInternN(yytext, yyleng);\
+      yylval->line   = yylloc.first_line;\
+      yylval->column = yylloc.first_column;\
+   }
+#line 578 "<stdout>"
 
 #define INITIAL 0
 
@@ -771,11 +792,11 @@ YY_DECL
 		}
 
 	{
-#line 24 "nanoLangScanner.l"
+#line 45 "nanoLangScanner.l"
 
 
 
-#line 779 "<stdout>"
+#line 800 "<stdout>"
 
 	while ( /*CONSTCOND*/1 )		/* loops until end-of-file is reached */
 		{
@@ -844,162 +865,162 @@ do_action:	/* This label is used only to access EOF actions. */
 
 case 1:
 YY_RULE_SETUP
-#line 27 "nanoLangScanner.l"
+#line 48 "nanoLangScanner.l"
 {  /* Skip comments */  }
 	YY_BREAK
 case 2:
 YY_RULE_SETUP
-#line 28 "nanoLangScanner.l"
-{ yylval->type = t_INTEGER; return INTEGER; }
+#line 49 "nanoLangScanner.l"
+{ TOKEN_CELL(t_INTEGER); return INTEGER; }
 	YY_BREAK
 case 3:
 YY_RULE_SETUP
-#line 29 "nanoLangScanner.l"
-{ yylval->type = t_STRING; return STRING; }
+#line 50 "nanoLangScanner.l"
+{ TOKEN_CELL(t_STRING); return STRING; }
 	YY_BREAK
 case 4:
 YY_RULE_SETUP
-#line 30 "nanoLangScanner.l"
-{ yylval->type = t_PRINT; return PRINT; }
+#line 51 "nanoLangScanner.l"
+{ TOKEN_CELL(t_PRINT); return PRINT; }
 	YY_BREAK
 case 5:
 YY_RULE_SETUP
-#line 31 "nanoLangScanner.l"
-{ yylval->type = t_RETURN; return RETURN; }
+#line 52 "nanoLangScanner.l"
+{ TOKEN_CELL(t_RETURN); return RETURN; }
 	YY_BREAK
 case 6:
 YY_RULE_SETUP
-#line 32 "nanoLangScanner.l"
-{ yylval->type = t_IF; return IF; }
+#line 53 "nanoLangScanner.l"
+{ TOKEN_CELL(t_IF); return IF; }
 	YY_BREAK
 case 7:
 YY_RULE_SETUP
-#line 33 "nanoLangScanner.l"
-{ yylval->type = t_ELSE; return ELSE; }
+#line 54 "nanoLangScanner.l"
+{ return ELSE; }
 	YY_BREAK
 case 8:
 YY_RULE_SETUP
-#line 34 "nanoLangScanner.l"
-{ yylval->type = t_WHILE; return WHILE; }
+#line 55 "nanoLangScanner.l"
+{ TOKEN_CELL(t_WHILE); return WHILE; }
 	YY_BREAK
 case 9:
 YY_RULE_SETUP
-#line 35 "nanoLangScanner.l"
-{ yylval->type = t_INTLIT; yylval->intval = atol(yytext); return INTLIT; }
+#line 56 "nanoLangScanner.l"
+{ TOKEN_CELL(t_INTLIT); yylval->intval = atol(yytext); return INTLIT; }
 	YY_BREAK
 case 10:
 /* rule 10 can match eol */
 YY_RULE_SETUP
-#line 36 "nanoLangScanner.l"
-{ yylval->type = t_STRINGLIT; return STRINGLIT; }
+#line 57 "nanoLangScanner.l"
+{ TOKEN_CELL(t_STRINGLIT); return STRINGLIT; }
 	YY_BREAK
 case 11:
 YY_RULE_SETUP
-#line 37 "nanoLangScanner.l"
-{ yylval->type = t_IDENT; return IDENT; }
+#line 58 "nanoLangScanner.l"
+{ TOKEN_CELL(t_IDENT); return IDENT; }
 	YY_BREAK
 case 12:
 YY_RULE_SETUP
-#line 38 "nanoLangScanner.l"
+#line 59 "nanoLangScanner.l"
 { return OPENPAR; }
 	YY_BREAK
 case 13:
 YY_RULE_SETUP
-#line 39 "nanoLangScanner.l"
+#line 60 "nanoLangScanner.l"
 { return CLOSEPAR; }
 	YY_BREAK
 case 14:
 YY_RULE_SETUP
-#line 40 "nanoLangScanner.l"
+#line 61 "nanoLangScanner.l"
 { return OPENCURLY; }
 	YY_BREAK
 case 15:
 YY_RULE_SETUP
-#line 41 "nanoLangScanner.l"
+#line 62 "nanoLangScanner.l"
 { return CLOSECURLY; }
 	YY_BREAK
 case 16:
 YY_RULE_SETUP
-#line 42 "nanoLangScanner.l"
+#line 63 "nanoLangScanner.l"
 { return SEMICOLON; }
 	YY_BREAK
 case 17:
 YY_RULE_SETUP
-#line 43 "nanoLangScanner.l"
+#line 64 "nanoLangScanner.l"
 { return COMMA; }
 	YY_BREAK
 case 18:
 YY_RULE_SETUP
-#line 44 "nanoLangScanner.l"
-{ yylval->type = t_MULT; return MULT; }
+#line 65 "nanoLangScanner.l"
+{ TOKEN_CELL(t_MULT); return MULT; }
 	YY_BREAK
 case 19:
 YY_RULE_SETUP
-#line 45 "nanoLangScanner.l"
-{ yylval->type = t_DIV; return DIV; }
+#line 66 "nanoLangScanner.l"
+{ TOKEN_CELL(t_DIV); return DIV; }
 	YY_BREAK
 case 20:
 YY_RULE_SETUP
-#line 46 "nanoLangScanner.l"
-{ yylval->type = t_PLUS; return PLUS; }
+#line 67 "nanoLangScanner.l"
+{ TOKEN_CELL(t_PLUS); return PLUS; }
 	YY_BREAK
 case 21:
 YY_RULE_SETUP
-#line 47 "nanoLangScanner.l"
-{ yylval->type = t_MINUS; return MINUS; }
+#line 68 "nanoLangScanner.l"
+{ TOKEN_CELL(t_MINUS); return MINUS; }
 	YY_BREAK
 case 22:
 YY_RULE_SETUP
-#line 48 "nanoLangScanner.l"
-{ yylval->type = t_LT; return LT; }
+#line 69 "nanoLangScanner.l"
+{ TOKEN_CELL(t_LT); return LT; }
 	YY_BREAK
 case 23:
 YY_RULE_SETUP
-#line 49 "nanoLangScanner.l"
-{ yylval->type = t_LEQ; return LEQ; }
+#line 70 "nanoLangScanner.l"
+{ TOKEN_CELL(t_LEQ); return LEQ; }
 	YY_BREAK
 case 24:
 YY_RULE_SETUP
-#line 50 "nanoLangScanner.l"
-{ yylval->type = t_GT; return GT; }
+#line 71 "nanoLangScanner.l"
+{ TOKEN_CELL(t_GT); return GT; }
 	YY_BREAK
 case 25:
 YY_RULE_SETUP
-#line 51 "nanoLangScanner.l"
-{ yylval->type = t_GEQ; return GEQ; }
+#line 72 "nanoLangScanner.l"
+{ TOKEN_CELL(t_GEQ); return GEQ; }
 	YY_BREAK
 case 26:
 YY_RULE_SETUP
-#line 52 "nanoLangScanner.l"
-{ yylval->type = t_NEQ; return NEQ; }
+#line 73 "nanoLangScanner.l"
+{ TOKEN_CELL(t_NEQ); return NEQ; }
 	YY_BREAK
 case 27:
 YY_RULE_SETUP
-#line 53 "nanoLangScanner.l"
-{ yylval->type = t_EQ; return EQ; }
+#line 74 "nanoLangScanner.l"
+{ TOKEN_CELL(t_EQ); return EQ; }
 	YY_BREAK
 case 28:
 /* rule 28 can match eol */
 YY_RULE_SETUP
-#line 54 "nanoLangScanner.l"
+#line 75 "nanoLangScanner.l"
 { yycolno = 1; }
 	YY_BREAK
 case 29:
 YY_RULE_SETUP
-#line 55 "nanoLangScanner.l"
+#line 76 "nanoLangScanner.l"
 { /* Skip  whitespace*/ }
 	YY_BREAK
 case 30:
 YY_RULE_SETUP
-#line 56 "nanoLangScanner.l"
+#line 77 "nanoLangScanner.l"
 { yyerror("Unexpected charater: %c", *yytext); }
 	YY_BREAK
 case 31:
 YY_RULE_SETUP
-#line 59 "nanoLangScanner.l"
+#line 80 "nanoLangScanner.l"
 ECHO;
 	YY_BREAK
-#line 1003 "<stdout>"
+#line 1024 "<stdout>"
 case YY_STATE_EOF(INITIAL):
 	yyterminate();
 
@@ -2012,7 +2033,71 @@ void yyfree (void * ptr )
 
 #define YYTABLES_NAME "yytables"
 
-#line 59 "nanoLangScanner.l"
+#line 80 "nanoLangScanner.l"
+
+/*
+   Memory-mapped input: Map the whole source file and let flex scan
+   it in place, without copying it into its own buffers. Together with
+   the intern pool, this means no per-token copies of the source at
+   all. yy_scan_buffer() needs two 0 bytes behind the text - we reserve
+   an anonymous mapping that is larger than the file and map the file
+   over its start. The mapping is private, since flex temporarily
+   writes into the buffer.
+*/
+
+static char*  yymap_base = NULL;
+static size_t yymap_size = 0;
+
+bool yyscan_mmap(const char* path)
+{
+   int         fd;
+   struct stat st;
+   size_t      page = sysconf(_SC_PAGESIZE);
+   char*       base;
+
+   fd = open(path, O_RDONLY);
+   if(fd < 0)
+   {
+      return false;
+   }
+   if(fstat(fd, &st) < 0)
+   {
+      close(fd);
+      return false;
+   }
+   yymap_size = ((st.st_size+2+page-1)/page)*page;
+   base = mmap(NULL, yymap_size, PROT_READ|PROT_WRITE,
+               MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+   if(base == MAP_FAILED)
+   {
+      close(fd);
+      return false;
+   }
+   if(st.st_size &&
+      mmap(base, st.st_size, PROT_READ|PROT_WRITE,
+           MAP_PRIVATE|MAP_FIXED, fd, 0) == MAP_FAILED)
+   {
+      munmap(base, yymap_size);
+      close(fd);
+      return false;
+   }
+   close(fd);
+   madvise(base, st.st_size, MADV_SEQUENTIAL);
+   yymap_base = base;
+   yy_scan_buffer(base, st.st_size+2);
+
+   return true;
+}
+
+void yyscan_unmap(void)
+{
+   if(yymap_base)
+   {
+      yy_delete_buffer(YY_CURRENT_BUFFER);
+      munmap(yymap_base, yymap_size);
+      yymap_base = NULL;
+   }
+}
 
 
 
@@ -0,0 +1,677 @@
+/*-----------------------------------------------------------------------
+
+File  : nanobench.c
+
+Authors: Konstantin Kläger, Isabel Staaden, Carolin Rösch
+
+Contents
+
+  Micro-benchmarks for the data structures of the nanoLang
+  compiler and its runtime. Usage: nanobench <benchmark> [size]
+
+  This code is released under the GNU General Public Licence.
+
+Changes
+
+<1> Sat Oct 17 23:41:20 CEST 2026
+    New
+
+-----------------------------------------------------------------------*/
+
+#include <time.h>
+#include "ast.h"
+#include "arena.h"
+#include "compactast.h"
+#include "symbols.h"
+#include "semantic.h"
+#include "nanort.h"
+
+
+
+/*---------------------------------------------------------------------*/
+/*                        Global Variables                             */
+/*---------------------------------------------------------------------*/
+
+/* Statements per generated statement chain - keeps the recursion
+   depth of ASTFree() and friends bounded */
+#define STMTS_PER_BLOCK 100
+
+
+/*---------------------------------------------------------------------*/
+/*                         Internal Functions                          */
+/*---------------------------------------------------------------------*/
+
+static double now(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + ts.tv_nsec/1e9;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: token()
+//
+//   Simulate the scanner: allocate a token cell for text.
+//
+// Global Variables: ast_arena
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static AST_p token(ASTNodeType type, char* text)
+{
+   AST_p res = ASTEmptyAlloc();
+
+   res->type   = type;
+   res->litval = StrIntern(text);
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: gen_stmt()
+//
+//   Generate the AST for "x = y + 3 * z;" the way scanner and parser
+//   would (operator tokens become the inner nodes).
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static AST_p gen_stmt(void)
+{
+   AST_p lhs, rhs;
+
+   lhs = token(t_IDENT, "x");
+   rhs = ASTTokenNode2(token(t_MULT, "*"),
+                       t_MULT, token(t_INTLIT, "3"), token(t_IDENT, "z"));
+   rhs = ASTTokenNode2(token(t_PLUS, "+"), t_PLUS, token(t_IDENT, "y"), rhs);
+
+   return ASTTokenNode2(token(t_EQ, "="), assign, lhs, rhs);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: gen_program()
+//
+//   Generate a program with (about) n statements, organized as a
+//   balanced tree of statement blocks.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static AST_p gen_program(long n)
+{
+   AST_p res;
+   long  i;
+
+   if(n <= STMTS_PER_BLOCK)
+   {
+      res = ASTEmptyAlloc();
+      for(i=0; i<n; i++)
+      {
+         res = ASTAlloc2(stmts, NULL, 0, res, gen_stmt());
+      }
+      return ASTAlloc2(body, NULL, 0, ASTEmptyAlloc(), res);
+   }
+   return ASTAlloc2(prog, NULL, 0, gen_program(n/2), gen_program(n-n/2));
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: bench_ast()
+//
+//   Compare building and releasing an AST with malloc()/free()
+//   against the arena allocator.
+//
+// Global Variables: nodectr
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+static void bench_ast(long n)
+{
+   double  start, build, release;
+   long    nodes;
+   AST_p   ast;
+   Arena_p arena;
+
+   printf("AST allocation, %ld statements\n", n);
+
+   nodectr = 0;
+   start = now();
+   ast = gen_program(n);
+   build = now()-start;
+   nodes = nodectr;
+   start = now();
+   ASTFree(ast);
+   release = now()-start;
+   printf("  malloc: %ld nodes, build %8.4fs, free %8.4fs\n",
+          nodes, build, release);
+
+   nodectr = 0;
+   arena = ArenaAlloc(0);
+   ASTSetArena(arena);
+   start = now();
+   ast = gen_program(n);
+   build = now()-start;
+   nodes = nodectr;
+   ASTSetArena(NULL);
+   start = now();
+   ArenaFree(arena);
+   release = now()-start;
+   printf("  arena:  %ld nodes, build %8.4fs, free %8.4fs\n",
+          nodes, build, release);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ptr_count_nodes()
+// Function: compact_count_nodes()
+//
+//   Count the nodes of a given type with a recursive walk over the
+//   pointer and the compact representation.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static long ptr_count_nodes(AST_p ast, ASTNodeType type)
+{
+   long res = 0;
+   int  i;
+
+   if(ast)
+   {
+      res = (ast->type == type);
+      for(i=0; i<MAXCHILD; i++)
+      {
+         res += ptr_count_nodes(ast->child[i], type);
+      }
+   }
+   return res;
+}
+
+static long compact_count_nodes(CompactAST_p cast, CNode node, ASTNodeType type)
+{
+   long     res = 0;
+   uint32_t i;
+
+   if(node != CNODE_NONE)
+   {
+      res = (CASTType(cast, node) == type);
+      for(i=0; i<CASTArity(cast, node); i++)
+      {
+         res += compact_count_nodes(cast, CASTChild(cast, node, i), type);
+      }
+   }
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: bench_compact()
+//
+//   Compare memory use and traversal time of the pointer AST and the
+//   compact AST.
+//
+// Global Variables: nodectr
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+static void bench_compact(long n)
+{
+   double       start, elapsed;
+   long         count, rounds = 10, i;
+   AST_p        ast;
+   Arena_p      arena;
+   CompactAST_p cast;
+
+   nodectr = 0;
+   arena = ArenaAlloc(0);
+   ASTSetArena(arena);
+   ast = gen_program(n);
+   ASTSetArena(NULL);
+
+   start = now();
+   cast = CompactASTAlloc();
+   ASTCompact(cast, ast);
+   elapsed = now()-start;
+
+   printf("Compact AST, %ld statements\n", n);
+   printf("  pointer: %ld nodes, %zu bytes (%zu per node)\n",
+          nodectr, arena->reserved, sizeof(ASTCell));
+   printf("  compact: %u nodes, %zu bytes, converted in %8.4fs\n",
+          cast->node_ctr-1, CompactASTBytes(cast), elapsed);
+
+   start = now();
+   for(i=0, count=0; i<rounds; i++)
+   {
+      count += ptr_count_nodes(ast, t_IDENT);
+   }
+   printf("  pointer walk:   %8.4fs (%ld)\n", (now()-start)/rounds, count/rounds);
+   start = now();
+   for(i=0, count=0; i<rounds; i++)
+   {
+      count += compact_count_nodes(cast, cast->root, t_IDENT);
+   }
+   printf("  compact walk:   %8.4fs (%ld)\n", (now()-start)/rounds, count/rounds);
+   start = now();
+   for(i=0, count=0; i<rounds; i++)
+   {
+      count += CompactASTCountNodes(cast, t_IDENT);
+   }
+   printf("  compact scan:   %8.4fs (%ld)\n", (now()-start)/rounds, count/rounds);
+
+   CompactASTFree(cast);
+   ArenaFree(arena);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: bench_symbols()
+//
+//   Measure symbol table lookup cost for tables of 10 up to max
+//   symbols.
+//
+// Global Variables: -
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+static void bench_symbols(long max)
+{
+   long          n, i, lookups = 10000000;
+   char          **names, buf[32];
+   SymbolTable_p st;
+   double        start, elapsed;
+   unsigned long rnd = 42, found;
+
+   names = malloc(max*sizeof(char*));
+   for(i=0; i<max; i++)
+   {
+      sprintf(buf, "v%ld", i);
+      names[i] = StrIntern(buf);
+   }
+   printf("Symbol table lookup, %ld lookups per size\n", lookups);
+   for(n = 10; n <= max; n *= 10)
+   {
+      st = SymbolTableAlloc();
+      start = now();
+      for(i=0; i<n; i++)
+      {
+         STInsertSymbol(st, names[i], T_Integer, 0, 0);
+      }
+      elapsed = now()-start;
+      start = now();
+      for(i=0, found=0; i<lookups; i++)
+      {
+         rnd = rnd*6364136223846793005ul+1442695040888963407ul;
+         found += (STFindSymbolLocal(st, names[(rnd>>33)%n]) != NULL);
+      }
+      printf("  %7ld symbols: insert %6.1f ns, lookup %6.1f ns (%lu found)\n",
+             n, elapsed/n*1e9, (now()-start)/lookups*1e9, found);
+      SymbolTableFree(st);
+   }
+   free(names);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: bench_scopes()
+//
+//   Measure entering and leaving n scopes (nested 10 deep, as in
+//   generated code), with one local variable in every tenth scope.
+//
+// Global Variables: -
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+static void bench_scopes(long n)
+{
+   SymbolTable_p global, st;
+   char          *name = StrIntern("i");
+   double        start, elapsed;
+   long          i;
+   int           j;
+
+   global = SymbolTableAlloc();
+   start = now();
+   for(i=0; i<n; i+=10)
+   {
+      st = global;
+      for(j=0; j<10; j++)
+      {
+         st = STEnterContext(st);
+      }
+      STInsertSymbol(st, name, T_Integer, 0, 0);
+      for(j=0; j<10; j++)
+      {
+         st = STLeaveContext(st);
+      }
+   }
+   elapsed = now()-start;
+   printf("Scopes, %ld scopes entered and left\n", n);
+   printf("  %6.1f ns per scope, %zu bytes total (%zu per scope)\n",
+          elapsed/n*1e9, global->arena->reserved,
+          global->arena->reserved/(n? n : 1));
+   start = now();
+   SymbolTableFree(global);
+   printf("  free: %8.4fs\n", now()-start);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: gen_fun()
+//
+//   Generate the AST for function f<k> with n statements like
+//   gen_stmt(), followed by a loop calling the next function and a
+//   return:
+//
+//   Integer f<k>(Integer n)
+//   {
+//      Integer x, y, z;
+//      x = y + 3 * z; ...
+//      while(x < n) { x = x + f<k+1>(x); }
+//      return x;
+//   }
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static AST_p gen_fun(long k, long n, long funs)
+{
+   char  name[32], callee[32];
+   AST_p params_ast, vars, code, call, loop;
+   long  i;
+
+   sprintf(name, "f%ld", k);
+   sprintf(callee, "f%ld", (k+1)%funs);
+
+   params_ast = ASTAlloc2(params, NULL, 0,
+                          ASTAlloc2(param, NULL, 0, token(t_INTEGER, "Integer"),
+                                    token(t_IDENT, "n")), NULL);
+   vars = ASTAlloc2(idlist, NULL, 0, token(t_IDENT, "x"), token(t_IDENT, "y"));
+   vars = ASTAlloc2(idlist, NULL, 0, vars, token(t_IDENT, "z"));
+   vars = ASTAlloc2(vardef, NULL, 0, token(t_INTEGER, "Integer"), vars);
+   vars = ASTAlloc2(vardefs, NULL, 0, ASTEmptyAlloc(), vars);
+
+   code = ASTEmptyAlloc();
+   for(i=0; i<n; i++)
+   {
+      code = ASTAlloc2(stmts, NULL, 0, code, gen_stmt());
+   }
+   call = ASTAlloc2(funcall, NULL, 0, token(t_IDENT, callee),
+                    ASTAlloc2(arglist, NULL, 0, token(t_IDENT, "x"), NULL));
+   loop = ASTTokenNode2(token(t_EQ, "="), assign, token(t_IDENT, "x"),
+                        ASTTokenNode2(token(t_PLUS, "+"), t_PLUS,
+                                      token(t_IDENT, "x"), call));
+   loop = ASTAlloc2(body, NULL, 0, ASTEmptyAlloc(),
+                    ASTAlloc2(stmts, NULL, 0, ASTEmptyAlloc(), loop));
+   loop = ASTAlloc(while_stmt, NULL, 0, token(t_WHILE, "while"),
+                   ASTTokenNode2(token(t_LT, "<"), t_LT,
+                                 token(t_IDENT, "x"), token(t_IDENT, "n")),
+                   loop, NULL);
+   code = ASTAlloc2(stmts, NULL, 0, code, loop);
+   code = ASTAlloc2(stmts, NULL, 0, code,
+                    ASTAlloc2(ret_stmt, NULL, 0, token(t_RETURN, "return"),
+                              token(t_IDENT, "x")));
+
+   return ASTAlloc(fundef, NULL, 0, token(t_INTEGER, "Integer"),
+                   token(t_IDENT, name), params_ast,
+                   ASTAlloc2(body, NULL, 0, vars, code));
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: gen_checked_program()
+//
+//   Generate a type correct program with (about) n statements in
+//   functions of STMTS_PER_BLOCK statements each, plus main().
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static AST_p gen_checked_program(long n)
+{
+   long  funs = n/STMTS_PER_BLOCK+1, k;
+   AST_p res = ASTEmptyAlloc(), call;
+
+   for(k=0; k<funs; k++)
+   {
+      res = ASTAlloc2(prog, NULL, 0, res, gen_fun(k, STMTS_PER_BLOCK, funs));
+   }
+   call = ASTAlloc2(funcall, NULL, 0, token(t_IDENT, "f0"),
+                    ASTAlloc2(arglist, NULL, 0, token(t_INTLIT, "1"), NULL));
+   call = ASTAlloc2(ret_stmt, NULL, 0, token(t_RETURN, "return"), call);
+   call = ASTAlloc2(body, NULL, 0, ASTEmptyAlloc(),
+                    ASTAlloc2(stmts, NULL, 0, ASTEmptyAlloc(), call));
+   return ASTAlloc2(prog, NULL, 0, res,
+                    ASTAlloc(fundef, NULL, 0, token(t_INTEGER, "Integer"),
+                             token(t_IDENT, "main"),
+                             ASTAlloc2(params, NULL, 0, NULL, NULL), call));
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: bench_semantic()
+//
+//   Measure ASTSemanticCheck() on a program with about n statements.
+//
+// Global Variables: -
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+static void bench_semantic(long n)
+{
+   Arena_p       arena;
+   AST_p         ast;
+   SymbolTable_p st;
+   TypeTable_p   tt;
+   double        start, elapsed;
+   bool          ok;
+
+   printf("Semantic analysis, %ld statements\n", n);
+   arena = ArenaAlloc(0);
+   ASTSetArena(arena);
+   ast = gen_checked_program(n);
+   st  = SymbolTableAlloc();
+   tt  = TypeTableAlloc();
+
+   start = now();
+   ok = ASTSemanticCheck(st, tt, ast);
+   elapsed = now()-start;
+   printf("  %8.4fs (%s)\n", elapsed, ok? "ok" : "errors");
+
+   SymbolTableFree(st);
+   TypeTableFree(tt);
+   ASTSetArena(NULL);
+   ArenaFree(arena);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: bench_itoa()
+//
+//   Compare NanoIntToDec() with snprintf() on n values each of small
+//   numbers (below 1000 in magnitude), of numbers with uniformly
+//   distributed bit lengths (so all magnitudes of the long range
+//   occur equally often) and of uniformly distributed 64 bit numbers
+//   (nearly all of them 18 or 19 digits). Both results are checked
+//   against each other first, also at the ends of the range and
+//   around the powers of ten.
+//
+// Global Variables: -
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+static void bench_itoa(long n)
+{
+   static char   *dist[] = {"small", "all lengths", "64 bit"};
+   long          *vals, i, p, errors, chars;
+   int           d, len;
+   char          buf[32], ref[32];
+   double        start, elapsed;
+   unsigned long rnd = 42;
+
+   vals = malloc(n*sizeof(long));
+   if(!vals)
+   {
+      fprintf(stderr, "Out of memory in nanobench!\n");
+      exit(EXIT_FAILURE);
+   }
+
+   errors = 0;
+   for(p=1, i=0; i<19; i++, p*=10)
+   {
+      long edge[] = {p-1, p, p+1, -p+1, -p, -p-1, LONG_MAX, LONG_MIN};
+
+      for(d=0; d<8; d++)
+      {
+         len = NanoIntToDec(buf, edge[d]);
+         errors += len != snprintf(ref, 32, "%ld", edge[d]) ||
+            memcmp(buf, ref, len);
+      }
+   }
+
+   printf("Integer formatting, %ld values per distribution\n", n);
+   for(d=0; d<3; d++)
+   {
+      for(i=0; i<n; i++)
+      {
+         rnd = rnd*6364136223846793005ul+1442695040888963407ul;
+         switch(d)
+         {
+         case 0:
+               vals[i] = (long)(rnd>>33)%1000;
+               break;
+         case 1:
+               vals[i] = (long)((rnd^(rnd<<29)) >> (rnd>>58));
+               break;
+         default:
+               vals[i] = (long)(rnd^(rnd>>29));
+               break;
+         }
+         if(d < 2 && (rnd>>32)&1)
+         {
+            vals[i] = -vals[i];
+         }
+         len = NanoIntToDec(buf, vals[i]);
+         errors += len != snprintf(ref, 32, "%ld", vals[i]) ||
+            memcmp(buf, ref, len);
+      }
+
+      printf("  %s:\n", dist[d]);
+      start = now();
+      for(i=0, chars=0; i<n; i++)
+      {
+         chars += snprintf(buf, 32, "%ld", vals[i]);
+      }
+      elapsed = now()-start;
+      printf("    snprintf:     %8.4fs (%.1f ns per value, %.1f chars)\n",
+             elapsed, elapsed*1e9/n, (double)chars/n);
+      start = now();
+      for(i=0, chars=0; i<n; i++)
+      {
+         chars += NanoIntToDec(buf, vals[i]);
+      }
+      elapsed = now()-start;
+      printf("    NanoIntToDec: %8.4fs (%.1f ns per value, %.1f chars)\n",
+             elapsed, elapsed*1e9/n, (double)chars/n);
+   }
+   printf("  %ld mismatches\n", errors);
+   free(vals);
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                         Exported Functions                          */
+/*---------------------------------------------------------------------*/
+
+int main(int argc, char* argv[])
+{
+   long n = 1000000;
+
+   if(argc < 2)
+   {
+      fprintf(stderr, "Usage: nanobench ast|compact|symbols|scopes|semantic|itoa [size]\n");
+      exit(EXIT_FAILURE);
+   }
+   if(argc > 2)
+   {
+      n = atol(argv[2]);
+   }
+   if(strcmp(argv[1], "ast")==0)
+   {
+      bench_ast(n);
+   }
+   else if(strcmp(argv[1], "compact")==0)
+   {
+      bench_compact(n);
+   }
+   else if(strcmp(argv[1], "symbols")==0)
+   {
+      bench_symbols(n);
+   }
+   else if(strcmp(argv[1], "scopes")==0)
+   {
+      bench_scopes(n);
+   }
+   else if(strcmp(argv[1], "semantic")==0)
+   {
+      bench_semantic(n);
+   }
+   else if(strcmp(argv[1], "itoa")==0)
+   {
+      bench_itoa(n);
+   }
+   else
+   {
+      fprintf(stderr, "Unknown benchmark: %s\n", argv[1]);
+      exit(EXIT_FAILURE);
+   }
+   return EXIT_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                        End of File                                  */
+/*---------------------------------------------------------------------*/
@@ -0,0 +1,682 @@
+/*-----------------------------------------------------------------------
+
+File  : nanort.c
+
+Authors: Konstantin Kläger, Isabel Staaden, Carolin Rösch
+
+Contents
+
+  Runtime support for nanoLang programs.
+
+  This code is released under the GNU General Public Licence.
+
+Changes
+
+<1> Sun Oct 18 03:05:47 CEST 2026
+    New
+
+-----------------------------------------------------------------------*/
+
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include "nanort.h"
+
+
+
+/*---------------------------------------------------------------------*/
+/*                        Global Variables                             */
+/*---------------------------------------------------------------------*/
+
+/* A chunk of the string pool, mapped on its own so that it can be
+   made read-only. The strings follow the header. */
+typedef struct nanochunk
+{
+   struct nanochunk *next;
+   size_t           size;
+}NanoChunkCell, *NanoChunk_p;
+
+static NanoChunk_p pool_chunks = NULL;  /* Newest first */
+static char        *pool_free  = NULL;  /* Unused part of the newest */
+static char        *pool_end   = NULL;
+
+/* All strings of the pool, hashed by their contents */
+static NanoStr     *pool_table = NULL;
+static long        pool_size   = 0;
+static long        pool_ctr    = 0;
+
+/* Output of the print statement, waiting to be written */
+static char        out_buf[NANO_OUT_SIZE];
+static long        out_len     = 0;
+static bool        out_line    = false;
+
+/* For NanoOutPrintStats() */
+static long        out_prints  = 0;
+static long        out_bytes   = 0;
+static long        out_writes  = 0;
+
+/* "00" to "99", for formatting two digits at a time */
+static const char  dec_pairs[201] =
+   "0001020304050607080910111213141516171819"
+   "2021222324252627282930313233343536373839"
+   "4041424344454647484950515253545556575859"
+   "6061626364656667686970717273747576777879"
+   "8081828384858687888990919293949596979899";
+
+/* Powers of ten up to 10^19, the largest one an unsigned long holds */
+static const unsigned long dec_pow10[20] =
+{
+   1ul, 10ul, 100ul, 1000ul, 10000ul, 100000ul, 1000000ul, 10000000ul,
+   100000000ul, 1000000000ul, 10000000000ul, 100000000000ul,
+   1000000000000ul, 10000000000000ul, 100000000000000ul,
+   1000000000000000ul, 10000000000000000ul, 100000000000000000ul,
+   1000000000000000000ul, 10000000000000000000ul
+};
+
+
+/*---------------------------------------------------------------------*/
+/*                      Forward Declarations                           */
+/*---------------------------------------------------------------------*/
+
+
+/*---------------------------------------------------------------------*/
+/*                         Internal Functions                          */
+/*---------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------
+//
+// Function: pool_hash()
+//
+//   Hash of len characters (FNV-1a).
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static unsigned long pool_hash(const char* chars, NanoInt len)
+{
+   unsigned long res = 0xcbf29ce484222325ul;
+
+   while(len--)
+   {
+      res = (res ^ (unsigned char)*chars++) * 0x100000001b3ul;
+   }
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: pool_grow()
+//
+//   Double the size of the hash table of the pool (or create it).
+//
+// Global Variables: pool_table, pool_size
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void pool_grow(void)
+{
+   NanoStr *old  = pool_table;
+   long    size  = pool_size, i, j, mask;
+
+   pool_size  = size? 2*size : 256;
+   pool_table = calloc(pool_size, sizeof(NanoStr));
+   if(!pool_table)
+   {
+      NanoRuntimeError("out of memory");
+   }
+   mask = pool_size-1;
+   for(i=0; i<size; i++)
+   {
+      if(old[i])
+      {
+         for(j = pool_hash(old[i], NanoStrLen(old[i])) & mask; pool_table[j];
+             j = (j+1) & mask)
+         {
+            /* Find free slot */
+         }
+         pool_table[j] = old[i];
+      }
+   }
+   free(old);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: pool_alloc()
+//
+//   Return size bytes (a multiple of 8) of fresh pool memory, in a new
+//   chunk if the newest one is full or sealed.
+//
+// Global Variables: pool_chunks, pool_free, pool_end
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static char* pool_alloc(size_t size)
+{
+   size_t      page = sysconf(_SC_PAGESIZE), csize;
+   NanoChunk_p chunk;
+   char        *res;
+
+   if(!pool_free || (size_t)(pool_end-pool_free) < size)
+   {
+      csize = size+sizeof(NanoChunkCell) < NANO_POOL_CHUNK?
+         NANO_POOL_CHUNK : size+sizeof(NanoChunkCell);
+      csize = (csize+page-1)/page*page;
+      chunk = mmap(NULL, csize, PROT_READ|PROT_WRITE,
+                   MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+      if(chunk == MAP_FAILED)
+      {
+         NanoRuntimeError("out of memory");
+      }
+      chunk->next = pool_chunks;
+      chunk->size = csize;
+      pool_chunks = chunk;
+      pool_free   = (char*)(chunk+1);
+      pool_end    = (char*)chunk+csize;
+   }
+   res        = pool_free;
+   pool_free += size;
+
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: out_write()
+//
+//   Write the cnt buffers of iov to stdout, with as few system calls
+//   as possible. Output errors are ignored (as by stdio), iov is
+//   changed.
+//
+// Global Variables: out_bytes, out_writes
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+static void out_write(struct iovec* iov, int cnt)
+{
+   ssize_t done;
+
+   while(cnt)
+   {
+      done = writev(STDOUT_FILENO, iov, cnt);
+      out_writes++;
+      if(done < 0 && errno == EINTR)
+      {
+         continue;
+      }
+      if(done <= 0)
+      {
+         return;
+      }
+      out_bytes += done;
+      while(cnt && (size_t)done >= iov->iov_len)
+      {
+         done -= iov->iov_len;
+         iov++;
+         cnt--;
+      }
+      if(cnt)
+      {
+         iov->iov_base  = (char*)iov->iov_base+done;
+         iov->iov_len  -= done;
+      }
+   }
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                         Exported Functions                          */
+/*---------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------
+//
+// Function: NanoRuntimeError()
+//
+//   Report a fatal error of the running program and terminate it.
+//
+// Global Variables: -
+//
+// Side Effects    : Output, terminates the program
+//
+/----------------------------------------------------------------------*/
+
+void NanoRuntimeError(const char* msg)
+{
+   NanoOutFlush();
+   fprintf(stderr, "runtime error: %s\n", msg);
+   exit(EXIT_FAILURE);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: NanoDiv()
+//
+//   Integer division with the semantics described in nanort.h.
+//
+// Global Variables: -
+//
+// Side Effects    : May terminate the program
+//
+/----------------------------------------------------------------------*/
+
+NanoInt NanoDiv(NanoInt a, NanoInt b)
+{
+   if(b == 0)
+   {
+      NanoRuntimeError("division by zero");
+   }
+   if(b == -1)
+   {
+      return NanoNeg(a);
+   }
+   return a / b;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: NanoStrMake()
+// Function: NanoStrFromC()
+//
+//   Return the string with the len characters at chars (or the
+//   0-terminated cstr), from the pool. It is added if it is not yet
+//   there.
+//
+// Global Variables: pool_table, pool_size, pool_ctr
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+NanoStr NanoStrMake(const char* chars, NanoInt len)
+{
+   long    mask, i;
+   NanoInt *cell;
+
+   if(2*(pool_ctr+1) > pool_size)
+   {
+      pool_grow();
+   }
+   mask = pool_size-1;
+   for(i = pool_hash(chars, len) & mask; pool_table[i]; i = (i+1) & mask)
+   {
+      if(NanoStrLen(pool_table[i]) == len &&
+         memcmp(pool_table[i], chars, len) == 0)
+      {
+         return pool_table[i];
+      }
+   }
+   /* Length, characters, terminator, padding to the next word */
+   cell = (NanoInt*)pool_alloc((sizeof(NanoInt)+len+1+7) & ~(size_t)7);
+   cell[0] = len;
+   memcpy(cell+1, chars, len);
+   ((char*)(cell+1))[len] = '\0';
+   pool_table[i] = (NanoStr)(cell+1);
+   pool_ctr++;
+
+   return pool_table[i];
+}
+
+NanoStr NanoStrFromC(const char* cstr)
+{
+   return NanoStrMake(cstr, strlen(cstr));
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: NanoStrLiteral()
+//
+//   Return the value of the string literal lit (as written in the
+//   source, including the quotes). The escapes \n, \t, \r, \" and \\
+//   are replaced, other backslashes are kept.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+NanoStr NanoStrLiteral(const char* lit)
+{
+   size_t  len = strlen(lit);
+   char    *buf, *out;
+   NanoStr res;
+
+   if(len >= 2 && lit[0] == '"' && lit[len-1] == '"')
+   {
+      lit++;
+      len -= 2;
+   }
+   buf = malloc(len+1);
+   if(!buf)
+   {
+      NanoRuntimeError("out of memory");
+   }
+   for(out = buf; len; lit++, len--)
+   {
+      if(*lit == '\\' && len > 1)
+      {
+         switch(lit[1])
+         {
+         case 'n':
+               *out++ = '\n';
+               break;
+         case 't':
+               *out++ = '\t';
+               break;
+         case 'r':
+               *out++ = '\r';
+               break;
+         case '"':
+         case '\\':
+               *out++ = lit[1];
+               break;
+         default:
+               *out++ = '\\';
+               *out++ = lit[1];
+               break;
+         }
+         lit++;
+         len--;
+      }
+      else
+      {
+         *out++ = *lit;
+      }
+   }
+   res = NanoStrMake(buf, out-buf);
+   free(buf);
+
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: NanoStrPoolSeal()
+//
+//   Make all strings in the pool so far read-only. Later strings go
+//   to new chunks.
+//
+// Global Variables: pool_chunks, pool_free, pool_end
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+void NanoStrPoolSeal(void)
+{
+   NanoChunk_p chunk;
+
+   for(chunk = pool_chunks; chunk; chunk = chunk->next)
+   {
+      mprotect(chunk, chunk->size, PROT_READ);
+   }
+   pool_free = pool_end = NULL;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: NanoStrPoolFree()
+//
+//   Free the pool, and with it all strings.
+//
+// Global Variables: pool_chunks, pool_free, pool_end, pool_table,
+//                   pool_size, pool_ctr
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+void NanoStrPoolFree(void)
+{
+   NanoChunk_p chunk;
+
+   while((chunk = pool_chunks))
+   {
+      pool_chunks = chunk->next;
+      munmap(chunk, chunk->size);
+   }
+   free(pool_table);
+   pool_free  = pool_end = NULL;
+   pool_table = NULL;
+   pool_size  = pool_ctr = 0;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: NanoStrCmp()
+//
+//   Compare two strings (-1, 0 or 1 like the signs of strcmp()). The
+//   same string is recognized by its address.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+int NanoStrCmp(NanoStr a, NanoStr b)
+{
+   NanoInt la, lb;
+   int     res;
+
+   if(a == b)
+   {
+      return 0;
+   }
+   la  = NanoStrLen(a);
+   lb  = NanoStrLen(b);
+   res = memcmp(a? a : "", b? b : "", la < lb? la : lb);
+   if(res)
+   {
+      return res < 0? -1 : 1;
+   }
+   return (la > lb) - (la < lb);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: NanoIntToDec()
+//
+//   Write val in decimal to buf (at most 20 characters, no
+//   terminating 0) and return the number of characters. The
+//   number of digits is computed up front (from the position of the
+//   highest bit, corrected by one comparison), then the digits are
+//   written from the end, two per division.
+//
+// Global Variables: dec_pairs, dec_pow10
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+int NanoIntToDec(char* buf, NanoInt val)
+{
+   unsigned long u = val, q;
+   int           len, digits;
+   char          *p;
+
+   len = 0;
+   if(val < 0)
+   {
+      buf[len++] = '-';
+      u = 0ul-u;
+   }
+   digits  = ((64-__builtin_clzl(u|1))*1233) >> 12;
+   digits += (u|1) >= dec_pow10[digits];
+   len    += digits;
+
+   p = buf+len;
+   while(u >= 100)
+   {
+      q   = u/100;
+      p  -= 2;
+      memcpy(p, dec_pairs+2*(u-100*q), 2);
+      u   = q;
+   }
+   if(u >= 10)
+   {
+      memcpy(p-2, dec_pairs+2*u, 2);
+   }
+   else
+   {
+      p[-1] = '0'+u;
+   }
+   return len;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: NanoOutInit()
+//
+//   Prepare the output of the print statement. It is line buffered
+//   (written at the end of every line) if line_buffered is set or
+//   stdout is a terminal, and written in big blocks otherwise.
+//
+// Global Variables: out_len, out_line
+//
+// Side Effects    : Output (of stdio)
+//
+/----------------------------------------------------------------------*/
+
+void NanoOutInit(bool line_buffered)
+{
+   /* Everything the compiler printed comes first */
+   fflush(stdout);
+   out_len  = 0;
+   out_line = line_buffered || isatty(STDOUT_FILENO);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: NanoOutFlush()
+//
+//   Write the buffered output. This has to happen before the program
+//   ends.
+//
+// Global Variables: out_buf, out_len
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+void NanoOutFlush(void)
+{
+   struct iovec iov;
+
+   if(out_len)
+   {
+      iov.iov_base = out_buf;
+      iov.iov_len  = out_len;
+      out_len      = 0;
+      out_write(&iov, 1);
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: NanoOutPrintStats()
+//
+//   Print the number of print statements executed and the write
+//   calls they needed.
+//
+// Global Variables: out_prints, out_bytes, out_writes
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+void NanoOutPrintStats(FILE* out)
+{
+   fprintf(out, "# Output: %ld prints, %ld bytes in %ld write calls "
+           "(%.4f per print)\n", out_prints, out_bytes, out_writes,
+           out_prints? (double)out_writes/out_prints : 0.0);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: NanoPrintInt()
+// Function: NanoPrintStr()
+//
+//   Implementation of the print statement for both types. The output
+//   goes to the buffer, which is written when it is full (or, line
+//   buffered, when a line is complete). Strings of NANO_OUT_DIRECT
+//   or more characters are not copied, but written together with
+//   the buffer.
+//
+// Global Variables: out_buf, out_len, out_line, out_prints
+//
+// Side Effects    : Output
+//
+/----------------------------------------------------------------------*/
+
+void NanoPrintInt(NanoInt val)
+{
+   out_prints++;
+   if(out_len > NANO_OUT_SIZE-NANO_INT_CHARS)
+   {
+      NanoOutFlush();
+   }
+   out_len += NanoIntToDec(out_buf+out_len, val);
+   out_buf[out_len++] = '\n';
+   if(out_line)
+   {
+      NanoOutFlush();
+   }
+}
+
+void NanoPrintStr(NanoStr str)
+{
+   NanoInt      len = NanoStrLen(str);
+   struct iovec iov[2];
+
+   out_prints++;
+   if(len >= NANO_OUT_DIRECT)
+   {
+      iov[0].iov_base = out_buf;
+      iov[0].iov_len  = out_len;
+      iov[1].iov_base = (char*)str;
+      iov[1].iov_len  = len;
+      out_len         = 0;
+      out_write(iov, 2);
+      return;
+   }
+   if(out_len+len > NANO_OUT_SIZE)
+   {
+      NanoOutFlush();
+   }
+   memcpy(out_buf+out_len, str, len);
+   out_len += len;
+   if(out_line && memchr(str, '\n', len))
+   {
+      NanoOutFlush();
+   }
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                        End of File                                  */
+/*---------------------------------------------------------------------*/
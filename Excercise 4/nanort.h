@@ -0,0 +1,110 @@
+/*-----------------------------------------------------------------------
+
+File  : nanort.h
+
+Authors: Konstantin Kläger, Isabel Staaden, Carolin Rösch
+
+Contents
+
+  Runtime support for executing nanoLang programs. This is shared by
+  all execution engines and has no dependencies on the compiler, so
+  that it can also be linked into generated programs.
+
+  Integers are 64 bit values with wrap-around arithmetic. Division
+  truncates towards zero, division by zero is a runtime error, and
+  the one overflowing division (LONG_MIN / -1) wraps to LONG_MIN.
+  Strings are immutable and 0-terminated, with their length in the
+  word in front of the first character (NanoStrLen()); NULL is the
+  empty string. They are created once, in a pool that keeps only one
+  copy of every string (NanoStrMake()), so passing them around only
+  copies the pointer, and equal pointers mean equal strings. The pool
+  can be sealed (made read-only) once the literals are in. print
+  writes strings as they are and integers followed by a newline.
+
+  Output is collected in a buffer of NANO_OUT_SIZE bytes and written
+  with one system call when it is full, at the end of the program
+  (NanoOutFlush()) and before a runtime error is reported. Line
+  buffered output (for terminals) is written at the end of every
+  line.
+
+  This code is released under the GNU General Public Licence.
+
+Changes
+
+<1> Sun Oct 18 03:05:47 CEST 2026
+    New
+
+-----------------------------------------------------------------------*/
+
+#ifndef NANORT
+
+#define NANORT
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdbool.h>
+
+
+/*---------------------------------------------------------------------*/
+/*                    Data type declarations                           */
+/*---------------------------------------------------------------------*/
+
+typedef long        NanoInt;
+typedef const char* NanoStr;
+
+/* Pool chunks are at least this big (and whole pages) */
+#define NANO_POOL_CHUNK 65536
+
+/* Size of the output buffer, and length from which strings are not
+   copied into it but written directly */
+#define NANO_OUT_SIZE   65536
+#define NANO_OUT_DIRECT 4096
+
+/* Space for the longest integer ("-9223372036854775808\n") */
+#define NANO_INT_CHARS  24
+
+/* A value of either type - the static types tell which one */
+typedef union nanovalue
+{
+   NanoInt i;
+   NanoStr s;
+}NanoValue;
+
+
+/*---------------------------------------------------------------------*/
+/*                Exported Functions and Variables                     */
+/*---------------------------------------------------------------------*/
+
+/* Wrap-around arithmetic without undefined behaviour */
+#define NanoAdd(a, b) ((NanoInt)((unsigned long)(a)+(unsigned long)(b)))
+#define NanoSub(a, b) ((NanoInt)((unsigned long)(a)-(unsigned long)(b)))
+#define NanoMul(a, b) ((NanoInt)((unsigned long)(a)*(unsigned long)(b)))
+#define NanoNeg(a)    ((NanoInt)(0ul-(unsigned long)(a)))
+
+void    NanoRuntimeError(const char* msg);
+NanoInt NanoDiv(NanoInt a, NanoInt b);
+
+#define NanoStrLen(s) ((s)? ((const NanoInt*)(s))[-1] : 0)
+
+NanoStr NanoStrMake(const char* chars, NanoInt len);
+NanoStr NanoStrFromC(const char* cstr);
+NanoStr NanoStrLiteral(const char* lit);
+void    NanoStrPoolSeal(void);
+void    NanoStrPoolFree(void);
+int     NanoStrCmp(NanoStr a, NanoStr b);
+
+int     NanoIntToDec(char* buf, NanoInt val);
+void    NanoOutInit(bool line_buffered);
+void    NanoOutFlush(void);
+void    NanoOutPrintStats(FILE* out);
+void    NanoPrintInt(NanoInt val);
+void    NanoPrintStr(NanoStr str);
+
+
+#endif
+
+/*---------------------------------------------------------------------*/
+/*                        End of File                                  */
+/*---------------------------------------------------------------------*/
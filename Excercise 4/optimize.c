@@ -0,0 +1,2014 @@
+/*-----------------------------------------------------------------------
+
+File  : optimize.c
+
+Authors: Konstantin Kläger, Isabel Staaden, Carolin Rösch
+
+Contents
+
+  AST optimizations for nanoLang (see optimize.h).
+
+  This code is released under the GNU General Public Licence.
+
+Changes
+
+<1> Sun Oct 18 10:12:40 CEST 2026
+    New
+
+-----------------------------------------------------------------------*/
+
+#include "optimize.h"
+#include "interp.h"
+
+
+
+/*---------------------------------------------------------------------*/
+/*                        Global Variables                             */
+/*---------------------------------------------------------------------*/
+
+/* Upper limit for the growth of the program by inlining (percent) */
+long opt_inline_growth = OPT_INLINE_GROWTH;
+
+
+/*---------------------------------------------------------------------*/
+/*                      Forward Declarations                           */
+/*---------------------------------------------------------------------*/
+
+static AST_p opt_expr(OptState_p state, AST_p ast);
+
+
+/*---------------------------------------------------------------------*/
+/*                         Internal Functions                          */
+/*---------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------
+//
+// Function: opt_intlit()
+//
+//   Turn the Integer expression ast into the literal val (in place)
+//   and return it.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static AST_p opt_intlit(AST_p ast, NanoInt val)
+{
+   char buf[24];
+   int  i;
+
+   for(i=0; i<MAXCHILD; i++)
+   {
+      if(ast->child[i])
+      {
+         ASTFree(ast->child[i]);
+         ast->child[i] = NULL;
+      }
+   }
+   snprintf(buf, sizeof(buf), "%ld", val);
+   ast->type        = t_INTLIT;
+   ast->litval      = StrIntern(buf);
+   ast->intval      = val;
+   ast->result_type = T_Integer;
+   ast->sym_table   = NULL;
+   ast->sym_slot    = -1;
+
+   return ast;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: opt_operand()
+//
+//   Replace the binary operation ast by its operand number keep,
+//   release the rest and return the operand.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static AST_p opt_operand(AST_p ast, int keep)
+{
+   AST_p res = ast->child[keep];
+
+   ASTFree(ast->child[1-keep]);
+   ast->child[0] = ast->child[1] = NULL;
+   ASTFree(ast);
+
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: opt_is_lit()
+//
+//   Return true if ast is the Integer literal val.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static inline bool opt_is_lit(AST_p ast, NanoInt val)
+{
+   return ast->type == t_INTLIT && ast->intval == val;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: opt_local_slot()
+//
+//   Return the frame slot of the Integer local ident is bound to, or
+//   -1 for globals and Strings.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static int opt_local_slot(AST_p ident)
+{
+   if(!ident->sym_table || ident->sym_table->depth == 0 ||
+      ASTSymbol(ident)->type != T_Integer)
+   {
+      return -1;
+   }
+   return STFrameSlot(ident->sym_table, ident->sym_slot);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: opt_arith()
+//
+//   Simplify the arithmetic operation ast, whose operands are
+//   already simplified. Literal operands are evaluated, neutral
+//   operands dropped, and constants of chains like (x+1)-2 or
+//   (x*2)*3 are combined (exact, since arithmetic wraps around).
+//   Return the result.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static AST_p opt_arith(OptState_p state, AST_p ast)
+{
+   AST_p   a = ast->child[0], b = ast->child[1];
+   NanoInt val;
+
+   if(!b)
+   {
+      if(a->type == t_INTLIT)
+      {
+         state->stats->folded++;
+         return opt_intlit(ast, NanoNeg(a->intval));
+      }
+      return ast;
+   }
+   if(a->type == t_INTLIT && b->type == t_INTLIT)
+   {
+      switch(ast->type)
+      {
+      case t_PLUS:
+            val = NanoAdd(a->intval, b->intval);
+            break;
+      case t_MINUS:
+            val = NanoSub(a->intval, b->intval);
+            break;
+      case t_MULT:
+            val = NanoMul(a->intval, b->intval);
+            break;
+      default:
+            if(b->intval == 0)
+            {
+               /* Must fail at run time */
+               return ast;
+            }
+            val = NanoDiv(a->intval, b->intval);
+            break;
+      }
+      state->stats->folded++;
+      return opt_intlit(ast, val);
+   }
+   switch(ast->type)
+   {
+   case t_PLUS:
+         if(opt_is_lit(a, 0))
+         {
+            state->stats->folded++;
+            return opt_operand(ast, 1);
+         }
+         /* Fall through */
+   case t_MINUS:
+         if(opt_is_lit(b, 0))
+         {
+            state->stats->folded++;
+            return opt_operand(ast, 0);
+         }
+         if(b->type == t_INTLIT && (a->type == t_PLUS || a->type == t_MINUS) &&
+            a->child[1] && a->child[1]->type == t_INTLIT)
+         {
+            /* (x op1 c1) op2 c2 -> x + (+-c1 +- c2) */
+            val = a->type == t_PLUS? a->child[1]->intval : NanoNeg(a->child[1]->intval);
+            val = ast->type == t_PLUS? NanoAdd(val, b->intval) : NanoSub(val, b->intval);
+            ast->type = t_PLUS;
+            opt_intlit(b, val);
+            ast->child[0] = opt_operand(a, 0);
+            state->stats->folded++;
+            return opt_arith(state, ast);
+         }
+         break;
+   case t_MULT:
+         if(opt_is_lit(a, 1))
+         {
+            state->stats->folded++;
+            return opt_operand(ast, 1);
+         }
+         if(opt_is_lit(b, 1))
+         {
+            state->stats->folded++;
+            return opt_operand(ast, 0);
+         }
+         if(b->type == t_INTLIT && a->type == t_MULT &&
+            a->child[1]->type == t_INTLIT)
+         {
+            opt_intlit(b, NanoMul(a->child[1]->intval, b->intval));
+            ast->child[0] = opt_operand(a, 0);
+            state->stats->folded++;
+            return opt_arith(state, ast);
+         }
+         break;
+   case t_DIV:
+         if(opt_is_lit(b, 1))
+         {
+            state->stats->folded++;
+            return opt_operand(ast, 0);
+         }
+         break;
+   default:
+         break;
+   }
+   return ast;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: opt_args()
+//
+//   Simplify the actual arguments of a call.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void opt_args(OptState_p state, AST_p args)
+{
+   if(args->type != arglist)
+   {
+      return;
+   }
+   if(args->child[0]->type == arglist)
+   {
+      opt_args(state, args->child[0]);
+   }
+   else
+   {
+      args->child[0] = opt_expr(state, args->child[0]);
+   }
+   if(args->child[1])
+   {
+      args->child[1] = opt_expr(state, args->child[1]);
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: opt_expr()
+//
+//   Simplify an expression with the known values of state and return
+//   the result.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static AST_p opt_expr(OptState_p state, AST_p ast)
+{
+   int slot;
+
+   switch(ast->type)
+   {
+   case t_IDENT:
+         slot = opt_local_slot(ast);
+         if(slot >= 0 && state->vals[slot].known)
+         {
+            state->stats->propagated++;
+            return opt_intlit(ast, state->vals[slot].val);
+         }
+         return ast;
+   case funcall:
+         opt_args(state, ast->child[1]);
+         return ast;
+   case t_PLUS:
+   case t_MINUS:
+   case t_MULT:
+   case t_DIV:
+         ast->child[0] = opt_expr(state, ast->child[0]);
+         if(ast->child[1])
+         {
+            ast->child[1] = opt_expr(state, ast->child[1]);
+         }
+         return opt_arith(state, ast);
+   default:
+         return ast;
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: opt_cond()
+//
+//   Simplify both sides of a comparison and return its value
+//   (OPT_UNKNOWN if it depends on run time values).
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static int opt_cond(OptState_p state, AST_p cond)
+{
+   int res;
+
+   cond->child[0] = opt_expr(state, cond->child[0]);
+   cond->child[1] = opt_expr(state, cond->child[1]);
+   res = ASTCondValue(cond);
+   if(res != OPT_UNKNOWN)
+   {
+      state->stats->folded++;
+   }
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: opt_save()
+//
+//   Return a copy of the known values of state (to be passed to
+//   opt_restore(), which releases it).
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static OptStateCell opt_save(OptState_p state)
+{
+   OptStateCell res = *state;
+
+   res.vals = malloc((state->slots+1)*sizeof(OptConstCell));
+   if(!res.vals)
+   {
+      fprintf(stderr, "Out of memory in opt_save()!\n");
+      exit(EXIT_FAILURE);
+   }
+   memcpy(res.vals, state->vals, state->slots*sizeof(OptConstCell));
+
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: opt_restore()
+//
+//   Make the saved state current (again) and release the copy.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void opt_restore(OptState_p state, OptStateCell* saved)
+{
+   memcpy(state->vals, saved->vals, state->slots*sizeof(OptConstCell));
+   state->dead = saved->dead;
+   free(saved->vals);
+   saved->vals = NULL;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: opt_merge()
+//
+//   Join the state at the end of one branch of an if (other) into
+//   the state at the end of the other one. Only values known on
+//   every reachable path remain known. Releases other.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void opt_merge(OptState_p state, OptStateCell* other)
+{
+   int i;
+
+   if(state->dead)
+   {
+      opt_restore(state, other);
+      return;
+   }
+   if(!other->dead)
+   {
+      for(i=0; i<state->slots; i++)
+      {
+         if(!other->vals[i].known || other->vals[i].val != state->vals[i].val)
+         {
+            state->vals[i].known = false;
+         }
+      }
+   }
+   free(other->vals);
+   other->vals = NULL;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: opt_kill()
+//
+//   Forget the values of all locals assigned somewhere in ast.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static void opt_kill(OptState_p state, AST_p ast)
+{
+   int i, slot;
+
+   if(!ast)
+   {
+      return;
+   }
+   if(ast->type == assign)
+   {
+      slot = opt_local_slot(ast->child[0]);
+      if(slot >= 0)
+      {
+         state->vals[slot].known = false;
+      }
+      return;
+   }
+   for(i=0; i<MAXCHILD && ast->child[i]; i++)
+   {
+      opt_kill(state, ast->child[i]);
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: opt_stmt()
+//
+//   Simplify a statement (list) and update state to the point behind
+//   it.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void opt_stmt(OptState_p state, AST_p ast)
+{
+   SymbolTable_p scope;
+   OptStateCell  entry, branch;
+   int           i, cond, slot;
+
+   switch(ast->type)
+   {
+   case nil:
+         break;
+   case stmts:
+         opt_stmt(state, ast->child[0]);
+         opt_stmt(state, ast->child[1]);
+         break;
+   case body:
+         /* Locals start out as 0 or the empty string */
+         scope = ast->context;
+         for(i=0; i<scope->symbol_ctr; i++)
+         {
+            slot = STFrameSlot(scope, i);
+            state->vals[slot].known = scope->symbols[i].type == T_Integer;
+            state->vals[slot].val   = 0;
+         }
+         opt_stmt(state, ast->child[1]);
+         break;
+   case while_stmt:
+         /* The condition and the body see the values that hold in
+            every iteration */
+         entry = opt_save(state);
+         opt_kill(state, ast->child[2]);
+         cond   = opt_cond(state, ast->child[1]);
+         branch = opt_save(state);
+         opt_stmt(state, ast->child[2]);
+         opt_restore(state, &branch);
+         if(cond == false)
+         {
+            opt_restore(state, &entry);
+         }
+         else
+         {
+            state->dead = state->dead || cond == true;
+            free(entry.vals);
+         }
+         break;
+   case if_stmt:
+         cond  = opt_cond(state, ast->child[1]);
+         entry = opt_save(state);
+         opt_stmt(state, ast->child[2]);
+         branch = opt_save(state);
+         opt_restore(state, &entry);
+         if(ast->child[3])
+         {
+            opt_stmt(state, ast->child[3]);
+         }
+         if(cond == true)
+         {
+            opt_restore(state, &branch);
+         }
+         else if(cond == false)
+         {
+            free(branch.vals);
+         }
+         else
+         {
+            opt_merge(state, &branch);
+         }
+         break;
+   case ret_stmt:
+         ast->child[1] = opt_expr(state, ast->child[1]);
+         state->dead = true;
+         break;
+   case print_stmt:
+         ast->child[1] = opt_expr(state, ast->child[1]);
+         break;
+   case assign:
+         ast->child[1] = opt_expr(state, ast->child[1]);
+         slot = opt_local_slot(ast->child[0]);
+         if(slot >= 0)
+         {
+            state->vals[slot].known = ast->child[1]->type == t_INTLIT;
+            state->vals[slot].val   = ast->child[1]->intval;
+         }
+         break;
+   case funcall_stmt:
+         opt_args(state, ast->child[0]->child[1]);
+         break;
+   default:
+         assert(false && "Unexpected AST type in opt_stmt()");
+         break;
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: opt_fundef()
+//
+//   Fold constants in the function definition def. Parameters are
+//   unknown on entry.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void opt_fundef(OptStats_p stats, AST_p def)
+{
+   OptStateCell state;
+
+   state.stats = stats;
+   state.slots = def->child[2]->context->frame_size;
+   state.dead  = false;
+   state.vals  = calloc(state.slots+1, sizeof(OptConstCell));
+   if(!state.vals)
+   {
+      fprintf(stderr, "Out of memory in opt_fundef()!\n");
+      exit(EXIT_FAILURE);
+   }
+   opt_stmt(&state, def->child[3]);
+   free(state.vals);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: dce_drop()
+//
+//   Release the subtree junk and return the number of its nodes.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static long dce_drop(AST_p junk)
+{
+   long res = 1;
+   int  i;
+
+   for(i=0; i<MAXCHILD; i++)
+   {
+      if(junk->child[i])
+      {
+         res += dce_drop(junk->child[i]);
+         junk->child[i] = NULL;
+      }
+   }
+   ASTFree(junk);
+
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: dce_nil()
+//
+//   Turn the statement ast into an empty one (in place) and return
+//   it.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static AST_p dce_nil(OptStats_p stats, AST_p ast)
+{
+   int i;
+
+   for(i=0; i<MAXCHILD; i++)
+   {
+      if(ast->child[i])
+      {
+         stats->removed += dce_drop(ast->child[i]);
+         ast->child[i] = NULL;
+      }
+   }
+   ast->type   = nil;
+   ast->litval = NULL;
+   stats->removed++;
+
+   return ast;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: dce_replace()
+//
+//   Replace the statement ast by its child number keep, release the
+//   rest and return the child.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static AST_p dce_replace(OptStats_p stats, AST_p ast, int keep)
+{
+   AST_p res = ast->child[keep];
+
+   ast->child[keep] = NULL;
+   stats->removed += dce_drop(ast);
+
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: dce_stmt()
+//
+//   Remove unreachable statements and branches that are never taken
+//   from the statement (list) ast and return the result. *term is set
+//   if control never reaches the point behind ast.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static AST_p dce_stmt(OptStats_p stats, AST_p ast, bool* term)
+{
+   bool term2;
+   int  cond;
+
+   *term = false;
+   switch(ast->type)
+   {
+   case stmts:
+         ast->child[0] = dce_stmt(stats, ast->child[0], term);
+         if(*term)
+         {
+            /* The last statement is never reached */
+            return dce_replace(stats, ast, 0);
+         }
+         ast->child[1] = dce_stmt(stats, ast->child[1], term);
+         if(ast->child[1]->type == nil)
+         {
+            return dce_replace(stats, ast, 0);
+         }
+         break;
+   case body:
+         ast->child[1] = dce_stmt(stats, ast->child[1], term);
+         break;
+   case while_stmt:
+         cond = ASTCondValue(ast->child[1]);
+         if(cond == false)
+         {
+            return dce_nil(stats, ast);
+         }
+         ast->child[2] = dce_stmt(stats, ast->child[2], &term2);
+         /* There is no way out of while(true) */
+         *term = cond == true;
+         break;
+   case if_stmt:
+         cond = ASTCondValue(ast->child[1]);
+         if(cond == true)
+         {
+            return dce_stmt(stats, dce_replace(stats, ast, 2), term);
+         }
+         if(cond == false)
+         {
+            if(!ast->child[3])
+            {
+               return dce_nil(stats, ast);
+            }
+            return dce_stmt(stats, dce_replace(stats, ast, 3), term);
+         }
+         ast->child[2] = dce_stmt(stats, ast->child[2], term);
+         if(ast->child[3])
+         {
+            ast->child[3] = dce_stmt(stats, ast->child[3], &term2);
+            *term = *term && term2;
+         }
+         else
+         {
+            *term = false;
+         }
+         break;
+   case ret_stmt:
+         *term = true;
+         break;
+   default:
+         break;
+   }
+   return ast;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: dce_count_reads()
+//
+//   Count the reads of every frame slot in the statements or
+//   expressions ast.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static void dce_count_reads(AST_p ast, long* reads)
+{
+   int i;
+
+   switch(ast->type)
+   {
+   case t_IDENT:
+         if(ast->sym_table && ast->sym_table->depth > 0)
+         {
+            reads[STFrameSlot(ast->sym_table, ast->sym_slot)]++;
+         }
+         break;
+   case body:
+   case assign:
+   case funcall:
+         /* Skip declarations, assignment targets and called names */
+         dce_count_reads(ast->child[1], reads);
+         break;
+   default:
+         for(i=0; i<MAXCHILD; i++)
+         {
+            if(ast->child[i])
+            {
+               dce_count_reads(ast->child[i], reads);
+            }
+         }
+         break;
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: dce_pure()
+//
+//   Return true if evaluating the expression ast can neither fail
+//   nor have side effects.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static bool dce_pure(AST_p ast)
+{
+   switch(ast->type)
+   {
+   case t_INTLIT:
+   case t_STRINGLIT:
+   case t_IDENT:
+         return true;
+   case t_DIV:
+         if(ast->child[1]->type != t_INTLIT || ast->child[1]->intval == 0)
+         {
+            return false;
+         }
+         /* Fall through */
+   case t_PLUS:
+   case t_MINUS:
+   case t_MULT:
+         return dce_pure(ast->child[0]) &&
+            (!ast->child[1] || dce_pure(ast->child[1]));
+   default:
+         return false;
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: dce_calls_only()
+//
+//   Return true if the calls in the expression ast are its only
+//   parts that can fail or have side effects.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static bool dce_calls_only(AST_p ast)
+{
+   switch(ast->type)
+   {
+   case funcall:
+         return true;
+   case t_DIV:
+         if(ast->child[1]->type != t_INTLIT || ast->child[1]->intval == 0)
+         {
+            return false;
+         }
+         /* Fall through */
+   case t_PLUS:
+   case t_MINUS:
+   case t_MULT:
+         return dce_calls_only(ast->child[0]) &&
+            (!ast->child[1] || dce_calls_only(ast->child[1]));
+   default:
+         return dce_pure(ast);
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: dce_extract_calls()
+//
+//   Append the calls in the expression ast (in evaluation order) to
+//   the statement list calls as call statements in scope context,
+//   and detach them from ast. Return the new list (NULL if there are
+//   no calls).
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations, changes ast
+//
+/----------------------------------------------------------------------*/
+
+static AST_p dce_extract_calls(AST_p ast, AST_p calls, SymbolTable_p context)
+{
+   AST_p stmt;
+   int   i;
+
+   if(ast->type == funcall)
+   {
+      stmt = ASTAlloc2(funcall_stmt, NULL, 0, ast, NULL);
+      stmt->context = context;
+      return calls? ASTAlloc2(stmts, NULL, 0, calls, stmt) : stmt;
+   }
+   for(i=0; i<2; i++)
+   {
+      if(ast->child[i])
+      {
+         calls = dce_extract_calls(ast->child[i], calls, context);
+         if(ast->child[i]->type == funcall)
+         {
+            ast->child[i] = NULL;
+         }
+      }
+   }
+   return calls;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: dce_stores()
+//
+//   Remove assignments to locals whose slot is never read from the
+//   statement (list) ast and return the result. Calls on the right
+//   hand side are kept as call statements. Sets *changed if anything
+//   was removed.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static AST_p dce_stores(OptStats_p stats, AST_p ast, long* reads, bool* changed)
+{
+   AST_p target, calls;
+
+   switch(ast->type)
+   {
+   case stmts:
+         ast->child[0] = dce_stores(stats, ast->child[0], reads, changed);
+         ast->child[1] = dce_stores(stats, ast->child[1], reads, changed);
+         if(ast->child[1]->type == nil)
+         {
+            return dce_replace(stats, ast, 0);
+         }
+         break;
+   case body:
+         ast->child[1] = dce_stores(stats, ast->child[1], reads, changed);
+         break;
+   case while_stmt:
+         ast->child[2] = dce_stores(stats, ast->child[2], reads, changed);
+         break;
+   case if_stmt:
+         ast->child[2] = dce_stores(stats, ast->child[2], reads, changed);
+         if(ast->child[3])
+         {
+            ast->child[3] = dce_stores(stats, ast->child[3], reads, changed);
+         }
+         break;
+   case assign:
+         target = ast->child[0];
+         if(target->sym_table->depth == 0 ||
+            reads[STFrameSlot(target->sym_table, target->sym_slot)])
+         {
+            break;
+         }
+         if(dce_pure(ast->child[1]))
+         {
+            *changed = true;
+            return dce_nil(stats, ast);
+         }
+         if(ast->child[1]->type == funcall)
+         {
+            *changed = true;
+            stats->removed += dce_drop(target);
+            ast->type     = funcall_stmt;
+            ast->litval   = NULL;
+            ast->child[0] = ast->child[1];
+            ast->child[1] = NULL;
+         }
+         else if(dce_calls_only(ast->child[1]))
+         {
+            *changed = true;
+            calls = dce_extract_calls(ast->child[1], NULL, ast->context);
+            stats->removed += dce_drop(ast);
+            return calls;
+         }
+         break;
+   default:
+         break;
+   }
+   return ast;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: dce_fundef()
+//
+//   Remove dead code from the function definition def. Dead stores
+//   are removed until none are left, since every removed store may
+//   make another local unread.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void dce_fundef(OptStats_p stats, AST_p def)
+{
+   int  slots = def->child[2]->context->frame_size;
+   long *reads;
+   bool term, changed;
+
+   def->child[3] = dce_stmt(stats, def->child[3], &term);
+
+   reads = malloc((slots+1)*sizeof(long));
+   if(!reads)
+   {
+      fprintf(stderr, "Out of memory in dce_fundef()!\n");
+      exit(EXIT_FAILURE);
+   }
+   do
+   {
+      memset(reads, 0, slots*sizeof(long));
+      dce_count_reads(def->child[3], reads);
+      changed = false;
+      def->child[3] = dce_stores(stats, def->child[3], reads, &changed);
+   }
+   while(changed);
+   free(reads);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: inl_size()
+//
+//   Return the number of nodes of the subtree ast.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static long inl_size(AST_p ast)
+{
+   long res = 1;
+   int  i;
+
+   for(i=0; i<MAXCHILD; i++)
+   {
+      if(ast->child[i])
+      {
+         res += inl_size(ast->child[i]);
+      }
+   }
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: inl_returns()
+//
+//   Return the number of return statements in ast.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static long inl_returns(AST_p ast)
+{
+   long res = ast->type == ret_stmt;
+   int  i;
+
+   for(i=0; i<MAXCHILD; i++)
+   {
+      if(ast->child[i])
+      {
+         res += inl_returns(ast->child[i]);
+      }
+   }
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: inl_tail()
+//
+//   Return the position of the statement executed last in the
+//   statement (list) in *slot, looking into nested blocks.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static AST_p* inl_tail(AST_p* slot)
+{
+   AST_p ast = *slot;
+
+   switch(ast->type)
+   {
+   case stmts:
+         return inl_tail(ast->child[1]->type != nil? &ast->child[1] : &ast->child[0]);
+   case body:
+         return inl_tail(&ast->child[1]);
+   default:
+         return slot;
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: inl_add_calls()
+//
+//   Add an edge to the call graph for every call in ast.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void inl_add_calls(CallGraph_p graph, AST_p ast)
+{
+   int i;
+
+   if(ast->type == funcall && graph->fun_no[ast->sym_slot] >= 0)
+   {
+      if(graph->edge_ctr == graph->edge_size)
+      {
+         graph->edge_size = graph->edge_size? 2*graph->edge_size : 64;
+         graph->edges = realloc(graph->edges, graph->edge_size*sizeof(int));
+         if(!graph->edges)
+         {
+            fprintf(stderr, "Out of memory in inl_add_calls()!\n");
+            exit(EXIT_FAILURE);
+         }
+      }
+      graph->edges[graph->edge_ctr++] = graph->fun_no[ast->sym_slot];
+   }
+   for(i=0; i<MAXCHILD; i++)
+   {
+      if(ast->child[i])
+      {
+         inl_add_calls(graph, ast->child[i]);
+      }
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: inl_find_recursive()
+//
+//   Fill state->recursive: a function is recursive if it can
+//   (directly or indirectly) call itself, i.e. if it calls itself or
+//   lies in a strongly connected component of the call graph with
+//   more than one function. The components are found with Tarjan's
+//   algorithm in O(functions+calls). The depth-first search keeps
+//   its own stack (next[] holds the next edge of every function on
+//   it), so deep call chains do not recurse on the C stack.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void inl_find_recursive(InlState_p state)
+{
+   CallGraphCell graph;
+   int  n = state->functions_ctr, m = 0, i, v, w, root, top, comp;
+   int  *slot, *index, *low, *path, *comp_stack;
+   long *next;
+   bool *on_stack, cycle;
+   int  counter = 0;
+
+   graph.fun_no    = malloc((n+1)*sizeof(int));
+   graph.edges     = NULL;
+   graph.edge_ctr  = 0;
+   graph.edge_size = 0;
+   slot = malloc((n+1)*sizeof(int));
+   if(!graph.fun_no || !slot)
+   {
+      fprintf(stderr, "Out of memory in inl_find_recursive()!\n");
+      exit(EXIT_FAILURE);
+   }
+   for(i=0; i<n; i++)
+   {
+      graph.fun_no[i] = state->functions[i]? m : -1;
+      if(state->functions[i])
+      {
+         slot[m++] = i;
+      }
+   }
+   graph.edge_start = malloc((m+1)*sizeof(long));
+   index      = calloc(m+1, sizeof(int));
+   low        = malloc((m+1)*sizeof(int));
+   path       = malloc((m+1)*sizeof(int));
+   comp_stack = malloc((m+1)*sizeof(int));
+   next       = malloc((m+1)*sizeof(long));
+   on_stack   = calloc(m+1, sizeof(bool));
+   if(!graph.edge_start || !index || !low || !path || !comp_stack ||
+      !next || !on_stack)
+   {
+      fprintf(stderr, "Out of memory in inl_find_recursive()!\n");
+      exit(EXIT_FAILURE);
+   }
+   for(v=0; v<m; v++)
+   {
+      graph.edge_start[v] = graph.edge_ctr;
+      inl_add_calls(&graph, state->functions[slot[v]]->child[3]);
+   }
+   graph.edge_start[m] = graph.edge_ctr;
+
+   comp = 0;
+   for(root=0; root<m; root++)
+   {
+      if(index[root])
+      {
+         continue;
+      }
+      top = 0;
+      path[top++] = root;
+      index[root] = low[root] = ++counter;
+      next[root] = graph.edge_start[root];
+      comp_stack[comp++] = root;
+      on_stack[root] = true;
+      while(top)
+      {
+         v = path[top-1];
+         if(next[v] < graph.edge_start[v+1])
+         {
+            w = graph.edges[next[v]++];
+            if(w == v)
+            {
+               state->recursive[slot[v]] = true;
+            }
+            else if(!index[w])
+            {
+               path[top++] = w;
+               index[w] = low[w] = ++counter;
+               next[w] = graph.edge_start[w];
+               comp_stack[comp++] = w;
+               on_stack[w] = true;
+            }
+            else if(on_stack[w] && index[w] < low[v])
+            {
+               low[v] = index[w];
+            }
+            continue;
+         }
+         top--;
+         if(top && low[v] < low[path[top-1]])
+         {
+            low[path[top-1]] = low[v];
+         }
+         if(low[v] == index[v])
+         {
+            /* v is the root of a component - pop it. It has more
+               than one member iff v is not on top. */
+            cycle = comp_stack[comp-1] != v;
+            do
+            {
+               w = comp_stack[--comp];
+               on_stack[w] = false;
+               if(cycle)
+               {
+                  state->recursive[slot[w]] = true;
+               }
+            }
+            while(w != v);
+         }
+      }
+   }
+   free(on_stack);
+   free(next);
+   free(comp_stack);
+   free(path);
+   free(low);
+   free(index);
+   free(slot);
+   free(graph.edge_start);
+   free(graph.edges);
+   free(graph.fun_no);
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: inl_candidate()
+//
+//   Return the definition of the function called by call if the call
+//   may be inlined: the callee is small, not recursive, fits into the
+//   remaining growth budget, and returns (if at all) only with its
+//   last statement. Otherwise return NULL.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static AST_p inl_candidate(InlState_p state, AST_p call)
+{
+   AST_p fun = state->functions[call->sym_slot];
+   long  size, returns;
+
+   if(!fun || state->recursive[call->sym_slot])
+   {
+      return NULL;
+   }
+   size = inl_size(fun->child[3]);
+   if(size > OPT_INLINE_SIZE || size > state->budget)
+   {
+      return NULL;
+   }
+   returns = inl_returns(fun->child[3]);
+   if(returns > 1 ||
+      (returns == 1 && (*inl_tail(&fun->child[3]))->type != ret_stmt))
+   {
+      return NULL;
+   }
+   return fun;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: inl_find()
+//
+//   Find the first call in the expression *slot (in evaluation
+//   order) that can be inlined into the statement around it, and
+//   return its position. Inlining evaluates the call before the rest
+//   of the statement, so everything evaluated before it must be free
+//   of effects and must not read globals (which the call might
+//   change). *blocked is set when such a part has been passed.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static AST_p* inl_find(InlState_p state, AST_p* slot, bool* blocked)
+{
+   AST_p ast = *slot, *res;
+
+   switch(ast->type)
+   {
+   case funcall:
+         if(inl_candidate(state, ast))
+         {
+            return slot;
+         }
+         res = inl_find(state, &ast->child[1], blocked);
+         *blocked = true;
+         return res;
+   case arglist:
+   case t_PLUS:
+   case t_MINUS:
+   case t_MULT:
+   case t_DIV:
+         res = inl_find(state, &ast->child[0], blocked);
+         if(res || *blocked || !ast->child[1])
+         {
+            return res;
+         }
+         res = inl_find(state, &ast->child[1], blocked);
+         if(ast->type == t_DIV && !dce_pure(ast))
+         {
+            *blocked = true;
+         }
+         return res;
+   case t_IDENT:
+         if(ast->sym_table->depth == 0)
+         {
+            *blocked = true;
+         }
+         return NULL;
+   default:
+         return NULL;
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: inl_map()
+//
+//   Return the copy of the scope old in the current inlined body
+//   (old itself if it is not part of the callee).
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+static SymbolTable_p inl_map(InlState_p state, SymbolTable_p old)
+{
+   int i;
+
+   for(i=0; i<state->map_ctr; i++)
+   {
+      if(state->map_old[i] == old)
+      {
+         return state->map_new[i];
+      }
+   }
+   return old;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: inl_map_add()
+//
+//   Record copy as the copy of the callee scope old.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static void inl_map_add(InlState_p state, SymbolTable_p old, SymbolTable_p copy)
+{
+   if(state->map_ctr == state->map_size)
+   {
+      state->map_size = state->map_size? 2*state->map_size : 8;
+      state->map_old  = realloc(state->map_old, state->map_size*sizeof(SymbolTable_p));
+      state->map_new  = realloc(state->map_new, state->map_size*sizeof(SymbolTable_p));
+      if(!state->map_old || !state->map_new)
+      {
+         fprintf(stderr, "Out of memory in inl_map_add()!\n");
+         exit(EXIT_FAILURE);
+      }
+   }
+   state->map_old[state->map_ctr] = old;
+   state->map_new[state->map_ctr] = copy;
+   state->map_ctr++;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: inl_scope()
+//
+//   Open a new scope inside parent with the same symbols as old, and
+//   make it the copy of old.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static SymbolTable_p inl_scope(InlState_p state, SymbolTable_p parent,
+                               SymbolTable_p old)
+{
+   SymbolTable_p res = STEnterContext(parent);
+   int           i;
+
+   for(i=0; i<old->symbol_ctr; i++)
+   {
+      STInsertSymbol(res, old->symbols[i].symbol, old->symbols[i].type,
+                     old->symbols[i].line, old->symbols[i].col);
+   }
+   inl_map_add(state, old, res);
+
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: inl_copy()
+//
+//   Return a copy of the callee code ast in which every scope of the
+//   callee is replaced by its copy.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static AST_p inl_copy(InlState_p state, AST_p ast)
+{
+   AST_p res = ASTEmptyAlloc();
+   long  ctr = res->nodectr;
+   int   i;
+
+   *res = *ast;
+   res->nodectr = ctr;
+   if(ast->type == body)
+   {
+      res->context = inl_scope(state, inl_map(state, ast->context->context),
+                               ast->context);
+   }
+   else
+   {
+      res->context = inl_map(state, ast->context);
+   }
+   if(res->sym_table)
+   {
+      res->sym_table = inl_map(state, res->sym_table);
+   }
+   for(i=0; i<MAXCHILD; i++)
+   {
+      if(ast->child[i])
+      {
+         res->child[i] = inl_copy(state, ast->child[i]);
+      }
+   }
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: inl_bind_args()
+//
+//   Detach the actual arguments args from their call and append
+//   assignments of them to the parameters in scope (starting with
+//   number *param) to the statement list code. Return the new list.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static AST_p inl_bind_args(SymbolTable_p scope, AST_p* slot, int* param,
+                           AST_p code)
+{
+   AST_p args = *slot, var;
+
+   switch(args->type)
+   {
+   case nil:
+         break;
+   case arglist:
+         code = inl_bind_args(scope, &args->child[0], param, code);
+         if(args->child[1])
+         {
+            code = inl_bind_args(scope, &args->child[1], param, code);
+         }
+         break;
+   default:
+         var = ASTAlloc(t_IDENT, scope->symbols[*param].symbol, 0,
+                        NULL, NULL, NULL, NULL);
+         ASTBind(var, scope, *param);
+         var->context     = scope;
+         var->result_type = scope->symbols[*param].type;
+         code = ASTAlloc2(stmts, NULL, 0, code,
+                          ASTAlloc2(assign, NULL, 0, var, args));
+         code->child[1]->context = scope;
+         *slot = NULL;
+         (*param)++;
+         break;
+   }
+   return code;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: inl_default()
+//
+//   Return a literal with the value of a function of type type that
+//   ends without return.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static AST_p inl_default(TypeIndex type)
+{
+   AST_p res;
+
+   if(type == T_String)
+   {
+      res = ASTAlloc(t_STRINGLIT, "\"\"", 0, NULL, NULL, NULL, NULL);
+   }
+   else
+   {
+      res = ASTAlloc(t_INTLIT, "0", 0, NULL, NULL, NULL, NULL);
+   }
+   res->result_type = type;
+
+   return res;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: inl_expand()
+//
+//   Inline the call at *cand into the statement site and return the
+//   block replacing site:
+//
+//     { <parameters> = <arguments>; { <callee body> ... site } }
+//
+//   The parameters are fresh locals of a new scope inside the scope
+//   of site, the callee scopes are copied below it. The final return
+//   of the callee becomes site itself, with the returned expression
+//   in place of the call (a call statement just keeps the effects of
+//   that expression).
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static AST_p inl_expand(InlState_p state, AST_p site, AST_p* cand)
+{
+   AST_p         call = *cand, fun = state->functions[call->sym_slot];
+   AST_p         code, copy, ret, *tail;
+   SymbolTable_p params = fun->child[2]->context, scope;
+   TypeIndex     type = call->result_type;
+   int           param = 0;
+   bool          whole = cand == &site->child[0] && site->type == funcall_stmt;
+
+   state->stats->inlined++;
+   state->budget -= inl_size(fun->child[3]);
+
+   scope = STEnterContext(site->context);
+   for(param=0; param<params->symbol_ctr; param++)
+   {
+      STInsertSymbol(scope, params->symbols[param].symbol,
+                     params->symbols[param].type,
+                     params->symbols[param].line, params->symbols[param].col);
+   }
+   state->map_ctr = 0;
+   inl_map_add(state, params, scope);
+   copy = inl_copy(state, fun->child[3]);
+
+   param = 0;
+   code  = inl_bind_args(scope, &call->child[1], &param, ASTEmptyAlloc());
+   code  = ASTAlloc2(stmts, NULL, 0, code, copy);
+   *cand = NULL;
+   dce_drop(call);
+
+   tail = inl_tail(&code->child[1]);
+   if((*tail)->type == ret_stmt)
+   {
+      ret = *tail;
+      if(whole)
+      {
+         *tail = dce_extract_calls(ret->child[1], NULL, ret->context);
+         if(ret->child[1]->type == funcall)
+         {
+            ret->child[1] = NULL;
+         }
+         if(!*tail)
+         {
+            *tail = ASTEmptyAlloc();
+         }
+      }
+      else
+      {
+         *cand = ret->child[1];
+         ret->child[1] = NULL;
+         *tail = site;
+         site->context = ret->context;
+      }
+      dce_drop(ret);
+   }
+   else if(!whole)
+   {
+      *cand = inl_default(type);
+      code  = ASTAlloc2(stmts, NULL, 0, code, site);
+      site->context = scope;
+   }
+   if(whole)
+   {
+      dce_drop(site);
+   }
+   code = ASTAlloc2(body, NULL, 0, ASTEmptyAlloc(), code);
+   code->context = scope;
+
+   return code;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: inl_stmt()
+//
+//   Inline calls in the statement (list) ast and return the result.
+//
+// Global Variables: -
+//
+// Side Effects    : Memory operations
+//
+/----------------------------------------------------------------------*/
+
+static AST_p inl_stmt(InlState_p state, AST_p ast)
+{
+   AST_p *slot, *cand, fun;
+   bool  blocked = false;
+
+   switch(ast->type)
+   {
+   case stmts:
+         ast->child[0] = inl_stmt(state, ast->child[0]);
+         ast->child[1] = inl_stmt(state, ast->child[1]);
+         return ast;
+   case body:
+         ast->child[1] = inl_stmt(state, ast->child[1]);
+         return ast;
+   case while_stmt:
+         ast->child[2] = inl_stmt(state, ast->child[2]);
+         return ast;
+   case if_stmt:
+         ast->child[2] = inl_stmt(state, ast->child[2]);
+         if(ast->child[3])
+         {
+            ast->child[3] = inl_stmt(state, ast->child[3]);
+         }
+         return ast;
+   case assign:
+   case print_stmt:
+   case ret_stmt:
+         slot = &ast->child[1];
+         break;
+   case funcall_stmt:
+         slot = &ast->child[0];
+         break;
+   default:
+         return ast;
+   }
+   cand = inl_find(state, slot, &blocked);
+   if(!cand)
+   {
+      return ast;
+   }
+   if(ast->type == funcall_stmt && cand == slot)
+   {
+      /* The value is dropped - the returned expression must be
+         reducible to its calls */
+      fun = inl_candidate(state, *cand);
+      if(inl_returns(fun->child[3]) &&
+         !dce_calls_only((*inl_tail(&fun->child[3]))->child[1]))
+      {
+         return ast;
+      }
+   }
+   /* The expanded code may contain further calls to inline */
+   return inl_stmt(state, inl_expand(state, ast, cand));
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                         Exported Functions                          */
+/*---------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------
+//
+// Function: ASTCondValue()
+//
+//   Return the value (true or false) of the comparison cond if both
+//   sides are literals, OPT_UNKNOWN otherwise.
+//
+// Global Variables: -
+//
+// Side Effects    : -
+//
+/----------------------------------------------------------------------*/
+
+int ASTCondValue(AST_p cond)
+{
+   AST_p   a = cond->child[0], b = cond->child[1];
+   NanoStr sa, sb;
+   int     cmp;
+
+   if(a->type == t_INTLIT && b->type == t_INTLIT)
+   {
+      cmp = (a->intval > b->intval) - (a->intval < b->intval);
+   }
+   else if(a->type == t_STRINGLIT && b->type == t_STRINGLIT)
+   {
+      sa  = NanoStrLiteral(a->litval);
+      sb  = NanoStrLiteral(b->litval);
+      cmp = NanoStrCmp(sa, sb);
+   }
+   else
+   {
+      return OPT_UNKNOWN;
+   }
+   switch(cond->type)
+   {
+   case t_EQ:
+         return cmp == 0;
+   case t_NEQ:
+         return cmp != 0;
+   case t_LT:
+         return cmp < 0;
+   case t_GT:
+         return cmp > 0;
+   case t_LEQ:
+         return cmp <= 0;
+   case t_GEQ:
+         return cmp >= 0;
+   default:
+         assert(false && "Unexpected AST type in ASTCondValue()");
+         return OPT_UNKNOWN;
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ASTFoldConstants()
+//
+//   Fold constant expressions and propagate the values of Integer
+//   locals in all functions of the checked program.
+//
+// Global Variables: -
+//
+// Side Effects    : Changes the AST, memory operations
+//
+/----------------------------------------------------------------------*/
+
+void ASTFoldConstants(AST_p program, OptStats_p stats)
+{
+   AST_p def;
+
+   for(; program && program->type == prog; program = program->child[0])
+   {
+      def = program->child[1];
+      if(def && def->type == fundef)
+      {
+         opt_fundef(stats, def);
+      }
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ASTEliminateDeadCode()
+//
+//   Remove unreachable statements, branches and loops whose
+//   condition is constant, and assignments to locals that are never
+//   read, from all functions of the checked program. The number of
+//   removed nodes is added to stats->removed.
+//
+// Global Variables: -
+//
+// Side Effects    : Changes the AST, memory operations
+//
+/----------------------------------------------------------------------*/
+
+void ASTEliminateDeadCode(AST_p program, OptStats_p stats)
+{
+   AST_p def;
+
+   for(; program && program->type == prog; program = program->child[0])
+   {
+      def = program->child[1];
+      if(def && def->type == fundef)
+      {
+         dce_fundef(stats, def);
+      }
+   }
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ASTInline()
+//
+//   Inline calls of small, non-recursive functions in all functions
+//   of the checked program with global symbol table st, until the
+//   program has grown by opt_inline_growth percent. Return the
+//   number of inlined calls.
+//
+// Global Variables: opt_inline_growth
+//
+// Side Effects    : Changes the AST and the symbol tables, memory
+//                   operations
+//
+/----------------------------------------------------------------------*/
+
+long ASTInline(SymbolTable_p st, AST_p program, OptStats_p stats)
+{
+   InlStateCell state;
+   long         inlined = stats->inlined;
+   int          i;
+
+   state.stats         = stats;
+   state.functions     = InterpFunctionTable(st, program);
+   state.functions_ctr = st->symbol_ctr;
+   state.recursive     = calloc(st->symbol_ctr+1, sizeof(bool));
+   state.budget        = inl_size(program)*opt_inline_growth/100;
+   state.map_ctr       = 0;
+   state.map_size      = 0;
+   state.map_old       = NULL;
+   state.map_new       = NULL;
+   if(!state.recursive)
+   {
+      fprintf(stderr, "Out of memory in ASTInline()!\n");
+      exit(EXIT_FAILURE);
+   }
+   inl_find_recursive(&state);
+
+   for(i=0; i<state.functions_ctr; i++)
+   {
+      if(state.functions[i])
+      {
+         state.functions[i]->child[3] =
+            inl_stmt(&state, state.functions[i]->child[3]);
+      }
+   }
+   free(state.map_old);
+   free(state.map_new);
+   free(state.recursive);
+   free(state.functions);
+
+   return stats->inlined - inlined;
+}
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ASTOptimize()
+//
+//   Run all optimizations on the checked program with global symbol
+//   table st.
+//
+// Global Variables: -
+//
+// Side Effects    : Changes the AST, memory operations
+//
+/----------------------------------------------------------------------*/
+
+void ASTOptimize(SymbolTable_p st, AST_p program, OptStats_p stats)
+{
+   ASTFoldConstants(program, stats);
+   ASTEliminateDeadCode(program, stats);
+   if(ASTInline(st, program, stats))
+   {
+      /* Arguments are often constants */
+      ASTFoldConstants(program, stats);
+      ASTEliminateDeadCode(program, stats);
+   }
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                        End of File                                  */
+/*---------------------------------------------------------------------*/
@@ -0,0 +1,138 @@
+/*-----------------------------------------------------------------------
+
+File  : optimize.h
+
+Authors: Konstantin Kläger, Isabel Staaden, Carolin Rösch
+
+Contents
+
+  Optimizations on the checked and annotated AST. They run between
+  the semantic analysis and code generation, so that every execution
+  engine and backend profits from them, and they never change the
+  observable behaviour of a program: arithmetic is evaluated with the
+  wrap-around semantics of nanort.h, and an operation that would fail
+  at run time (division by zero) is left in place.
+
+  Constant folding evaluates arithmetic and comparisons over
+  literals. Constant propagation tracks the values of Integer locals
+  through the statements of a function (locals start out as 0, and
+  calls cannot change them) and replaces reads of known locals by
+  literals.
+
+  Dead code elimination removes statements that cannot be reached
+  (behind return, behind while loops with a constant true condition),
+  branches and loops whose condition is constant false, and
+  assignments to locals that are never read (keeping calls on their
+  right hand side).
+
+  Inlining replaces calls of small, non-recursive functions that
+  return (if at all) with their last statement by a block in which
+  the parameters are fresh locals, assigned from the arguments, and
+  the callee scopes are copied into the caller (see inl_expand()).
+  Calls are inlined as statements (call statements, assignments,
+  print and return), or inside their expression when everything
+  evaluated before them is free of effects.
+
+  This code is released under the GNU General Public Licence.
+
+Changes
+
+<1> Sun Oct 18 10:12:40 CEST 2026
+    New
+
+-----------------------------------------------------------------------*/
+
+#ifndef OPTIMIZE
+
+#define OPTIMIZE
+
+#include "ast.h"
+#include "nanort.h"
+
+
+/*---------------------------------------------------------------------*/
+/*                    Data type declarations                           */
+/*---------------------------------------------------------------------*/
+
+/* Value of a comparison that cannot be decided at compile time */
+#define OPT_UNKNOWN -1
+
+/* Functions of at most OPT_INLINE_SIZE AST nodes are inlined, until
+ * the program has grown by opt_inline_growth (default
+ * OPT_INLINE_GROWTH) percent */
+#define OPT_INLINE_SIZE    80
+#define OPT_INLINE_GROWTH  100
+
+/* What the optimizer has done (for --stats) */
+typedef struct optstats
+{
+   long folded;      /* Operations evaluated at compile time */
+   long propagated;  /* Reads of locals replaced by their value */
+   long removed;     /* AST nodes removed as dead code */
+   long inlined;     /* Inlined calls */
+}OptStatsCell, *OptStats_p;
+
+/* Known value of an Integer local */
+typedef struct optconst
+{
+   bool    known;
+   NanoInt val;
+}OptConstCell, *OptConst_p;
+
+/* Dataflow state at a program point of the current function. dead
+ * marks points that cannot be reached (e.g. behind return). */
+typedef struct optstate
+{
+   OptStats_p stats;
+   int        slots;    /* Frame size of the function */
+   bool       dead;
+   OptConst_p vals;     /* Indexed by frame slot */
+}OptStateCell, *OptState_p;
+
+
+/* Call graph of the functions of a program. Functions are numbered
+ * densely; the callees of function f are edges[edge_start[f]] up to
+ * (excluding) edges[edge_start[f+1]]. */
+typedef struct callgraph
+{
+   int  *fun_no;       /* Function number by global symbol position, or -1 */
+   long *edge_start;
+   int  *edges;
+   long edge_ctr;
+   long edge_size;
+}CallGraphCell, *CallGraph_p;
+
+
+/* State of the inliner */
+typedef struct inlstate
+{
+   OptStats_p    stats;
+   AST_p         *functions;     /* Indexed by global symbol position */
+   int           functions_ctr;
+   bool          *recursive;
+   long          budget;         /* Nodes that may still be added */
+   int           map_ctr;        /* Callee scopes and their copies */
+   int           map_size;
+   SymbolTable_p *map_old;
+   SymbolTable_p *map_new;
+}InlStateCell, *InlState_p;
+
+
+/*---------------------------------------------------------------------*/
+/*                Exported Functions and Variables                     */
+/*---------------------------------------------------------------------*/
+
+extern long opt_inline_growth;
+
+int  ASTCondValue(AST_p cond);
+void ASTFoldConstants(AST_p program, OptStats_p stats);
+void ASTEliminateDeadCode(AST_p program, OptStats_p stats);
+long ASTInline(SymbolTable_p st, AST_p program, OptStats_p stats);
+void ASTOptimize(SymbolTable_p st, AST_p program, OptStats_p stats);
+
+
+#endif
+
+/*---------------------------------------------------------------------*/
+/*                        End of File                                  */
+/*---------------------------------------------------------------------*/
@@ -26,6 +26,17 @@ Changes
 /*                        Global Variables                             */
 /*---------------------------------------------------------------------*/
 
+/* State of the fused semantic pass (see ASTSemanticCheck()) for the
+   function currently being checked */
+typedef struct semstate
+{
+   TypeTable_p tt;
+   TypeIndex   ret_type;   /* Declared return type */
+   int         body_depth; /* Nesting depth of bodies */
+   bool        has_return; /* Return in the outermost body seen */
+   AST_p       fun;        /* Name of the current function */
+}SemStateCell, *SemState_p;
+
 
 /*---------------------------------------------------------------------*/
 /*                      Forward Declarations                           */
@@ -106,6 +117,10 @@ bool st_insert_symbols(SymbolTable_p st, TypeTable_p tt,
    case t_IDENT:
          res = STInsertSymbol(st, symbols->litval, type,
                               typenode->line, typenode->column);
+         if(res)
+         {
+            ASTBind(symbols, st, st->symbol_ctr-1);
+         }
          break;
    default:
          assert(false && "Unexpected AST type in st_insert_symbols()");
@@ -142,8 +157,7 @@ static void get_param_types(NanoType_p ntype, AST_p ast)
             get_param_types(ntype, ast->child[1]);
             break;
       case param:
-            ntype->typeargs[ntype->typeargno++] =
-               get_type_ast_type(ast->child[0]);
+            TypeAddArg(ntype, get_type_ast_type(ast->child[0]));
             break;
       default:
             assert(false && "Unexpected AST type in get_param_types()");
@@ -194,6 +208,49 @@ static bool st_insert_params(SymbolTable_p st, TypeTable_p tt, AST_p ast)
 }
 
 
+/*-----------------------------------------------------------------------
+//
+// Function: st_bind_node()
+//
+//   Bind an identifier to the symbol it denotes in the context st,
+//   or a function call to the function symbol. Return false if this
+//   is not (yet) possible.
+//
+// Global Variables: -
+//
+// Side Effects    : Annotates the AST
+//
+/----------------------------------------------------------------------*/
+
+static bool st_bind_node(SymbolTable_p st, AST_p ast)
+{
+   SymbolTable_p scope;
+   int           slot;
+
+   if(ast->sym_table)
+   {
+      return true;
+   }
+   if(ast->type == funcall)
+   {
+      if(ast->child[0]->sym_table)
+      {
+         ASTBind(ast, ast->child[0]->sym_table, ast->child[0]->sym_slot);
+         return true;
+      }
+      return false;
+   }
+   assert(ast->type == t_IDENT);
+   slot = STFindSymbolScope(st, ast->litval, &scope);
+   if(slot < 0)
+   {
+      return false;
+   }
+   ASTBind(ast, scope, slot);
+   return true;
+}
+
+
 /*-----------------------------------------------------------------------
 //
 // Function: type_error()
@@ -240,7 +297,8 @@ static bool type_check_arglist(FILE* out, char* function,
 {
    bool res = true;
 
-   if(args)
+   /* Empty argument lists are represented by a nil node */
+   if(args && args->type != nil)
    {
       /* ASTCellPrint(args);*/
 
@@ -299,13 +357,13 @@ static bool type_check_funcall(FILE* out, TypeTable_p tt, AST_p ast)
 
    assert(ast->context);
 
-   entry = STFindSymbolGlobal(ast->context, ast->child[0]->litval);
-   if(!entry)
+   if(!ast->sym_table)
    {
       fprintf(out, "%d:%d: error: undefined identifier %s\n",
               ast->child[0]->line, ast->child[0]->column, ast->child[0]->litval);
       return false;
    }
+   entry = ASTSymbol(ast);
    fun_type = &(tt->types[entry->type]);
    ast->result_type = TypeRetType(fun_type);
 
@@ -324,223 +382,115 @@ static bool type_check_funcall(FILE* out, TypeTable_p tt, AST_p ast)
 
 /*-----------------------------------------------------------------------
 //
-// Function: body_has_return()
+// Function: type_annotate_node()
 //
-//   Return true if the body has an (unconditional) return statement.
+//   Compute the result type of a node that is neither an identifier
+//   nor a call from the (already annotated) children. Return false
+//   and print an error if the children have the wrong types.
 //
 // Global Variables: -
 //
-// Side Effects    : -
+// Side Effects    : Annotates the AST, error messages
 //
 /----------------------------------------------------------------------*/
 
-static bool body_has_return(AST_p ast)
-{
-   bool res = false;
-
-   if(ast)
-   {
-      switch(ast->type)
-      {
-      case ret_stmt:
-            res = true;
-            break;
-      case body:
-            res = body_has_return(ast->child[1]);
-            break;
-      case stmts:
-            res |= body_has_return(ast->child[0]);
-            res |= body_has_return(ast->child[1]);
-            break;
-      default:
-            break;
-      }
-   }
-   return res;
-}
-
-
-bool STInsertVarDef(SymbolTable_p st, TypeTable_p tt, AST_p def)
-{
-   assert((def->type == vardef) || (def->type == param));
-
-   //printf("# STInsertVarDef():");SExprASTPrint(stdout, def);printf("\n");
-   //ASTCellPrint(def);
-   //ASTCellPrint(def->child[0]);
-
-   return  st_insert_symbols(st, tt, def->child[0], def->child[1]);
-}
-
-bool STInsertFunDef(SymbolTable_p st, TypeTable_p tt, AST_p def)
-{
-   NanoTypeCell ntype;
-   TypeIndex    type;
-
-   assert(def->type == fundef);
-
-   // printf("# STInsertFunDef():");SExprASTPrint(stdout, def->child[0]);printf("\n");
-   ntype.constructor = tc_function;
-   ntype.typeargno   = 1;
-   ntype.typeargs[0] = get_type_ast_type(def->child[0]);
-
-   get_param_types(&ntype, def->child[2]);
-   type = TypeTableGetTypeIndex(tt, &ntype);
-   return STInsertSymbol(st, def->child[1]->litval, type,
-                         def->child[0]->line, def->child[0]->column);
-}
-
-
-bool STBuildAllTables(SymbolTable_p st, TypeTable_p tt, AST_p ast)
+static bool type_annotate_node(TypeTable_p tt, AST_p ast)
 {
    bool res = true;
-   int  i;
-
-   assert(st);
 
-   if(ast)
+   switch(ast->type)
    {
-         //printf("\nSymboltable at node: ");
-         //ASTCellPrint(ast);
-         //SymbolTablePrintGlobal(stdout, st, tt);
-
-      ast->context = st;
-      switch(ast->type)
-      {
-      case vardef:
-            res = STBuildAllTables(st, tt, ast->child[0]) && res;
-            res = STBuildAllTables(st, tt, ast->child[1]) && res;
-            res = STInsertVarDef(st, tt, ast) && res;
-            break;
-      case fundef:
-            res = STInsertFunDef(st, tt, ast) && res;
-            res = STBuildAllTables(st, tt, ast->child[0]) && res;
-            res = STBuildAllTables(st, tt, ast->child[1]) && res;
-            st = STEnterContext(st);
-            res = st_insert_params(st, tt, ast->child[2]) && res;
-            res = STBuildAllTables(st, tt, ast->child[2]) && res;
-            res = STBuildAllTables(st, tt, ast->child[3]) && res;
-            st = STLeaveContext(st);
-            break;
-      case body:
-            st = STEnterContext(st);
-            ast->context = st;
-            res = STBuildAllTables(st, tt, ast->child[0]) && res;
-            res = STBuildAllTables(st, tt, ast->child[1]) && res;
-            st = STLeaveContext(st);
-            break;
-      default:
-            for(i=0; ast->child[i]; i++)
-            {
-               res = STBuildAllTables(st, tt, ast->child[i]) && res;
-            }
-            break;
-      }
+   case t_INTLIT:
+         ast->result_type = T_Integer;
+         break;
+   case t_STRINGLIT:
+         ast->result_type = T_String;
+         break;
+   case t_MULT:
+   case t_DIV:
+   case t_PLUS:
+   case t_MINUS:
+         if(ast->child[0]->result_type != T_Integer)
+         {
+            type_error(stdout, tt, T_Integer, ast->child[0]);
+            res = false;
+         }
+         if(ast->child[1] && (ast->child[1]->result_type != T_Integer))
+         {
+            type_error(stdout, tt, T_Integer, ast->child[1]);
+            res = false;
+         }
+         ast->result_type = T_Integer;
+         break;
+   case t_EQ:
+   case t_NEQ:
+   case t_LT:
+   case t_GT:
+   case t_LEQ:
+   case t_GEQ:
+   case assign:
+         /* Per syntax, we can only have expressions, which are
+            T_String or T_Integer. */
+         if(ast->child[0]->result_type != ast->child[1]->result_type)
+         {
+            /* We flag the second expression as wrong */
+            type_error(stdout, tt, ast->child[0]->result_type, ast->child[1]);
+            res = false;
+         }
+         ast->result_type = T_NoType;
+         break;
+   default:
+         ast->result_type = T_NoType;
+         break;
    }
    return res;
 }
 
-TypeIndex GetSymbolResType(FILE* out, TypeTable_p tt, AST_p node)
-{
-   assert(node->type == t_IDENT);
-   assert(node->context);
-
-   Symbol_p entry = STFindSymbolGlobal(node->context, node->litval);
-   if(!entry)
-   {
-      fprintf(out, "%d:%d: error: undefined identifier %s\n",
-              node->line, node->column, node->litval);
-      return T_NoType;
-   }
-   return TypeTableGetRetType(tt, entry->type);
-}
 
+/*-----------------------------------------------------------------------
+//
+// Function: sem_set_context()
+//
+//   Set the context of all nodes of a declaration (types and defined
+//   names), which need no further checks.
+//
+// Global Variables: -
+//
+// Side Effects    : Annotates the AST
+//
+/----------------------------------------------------------------------*/
 
-bool ASTTypeCheck(SymbolTable_p st, TypeTable_p tt, AST_p ast)
+static void sem_set_context(SymbolTable_p st, AST_p ast)
 {
-   bool res = true;
+   int i;
 
    if(ast)
    {
-      /* Types work bottom-up */
-      res = ASTTypeCheck(st, tt, ast->child[0]) && res;
-      res = ASTTypeCheck(st, tt, ast->child[1]) && res;
-      res = ASTTypeCheck(st, tt, ast->child[2]) && res;
-      res = ASTTypeCheck(st, tt, ast->child[3]) && res;
-      switch(ast->type)
+      ast->context     = st;
+      ast->result_type = T_NoType;
+      for(i=0; ast->child[i]; i++)
       {
-      case t_INTLIT:
-            ast->result_type = T_Integer;
-            break;
-      case t_STRINGLIT:
-            ast->result_type = T_String;
-            break;
-      case t_IDENT:
-            ast->result_type = GetSymbolResType(stdout, tt, ast);
-            if(ast->result_type == T_NoType)
-            {
-               res = false;
-            }
-            break;
-      case funcall:
-            res = type_check_funcall(stdout, tt, ast);
-            break;
-      case t_MULT:
-      case t_DIV:
-      case t_PLUS:
-      case t_MINUS:
-            if(ast->child[0]->result_type != T_Integer)
-            {
-               type_error(stdout, tt, T_Integer, ast->child[0]);
-               res = false;
-            }
-            if(ast->child[1] && (ast->child[1]->result_type != T_Integer))
-            {
-               type_error(stdout, tt, T_Integer, ast->child[1]);
-               res = false;
-            }
-            ast->result_type = T_Integer;
-            break;
-      case t_EQ:
-      case t_NEQ:
-      case t_LT:
-      case t_GT:
-      case t_LEQ:
-      case t_GEQ:
-      case assign:
-            /* Per syntax, we can only have expressions, which are
-               T_String or T_Integer. */
-            if(ast->child[0]->result_type != ast->child[1]->result_type)
-            {
-               /* We flag the second expression as wrong */
-               type_error(stdout, tt, ast->child[0]->result_type, ast->child[1]);
-               res = false;
-            }
-            ast->result_type = T_NoType;
-            break;
-      default:
-            ast->result_type = T_NoType;
-            break;
+         sem_set_context(st, ast->child[i]);
       }
    }
-   return res;
 }
 
 
-
 /*-----------------------------------------------------------------------
 //
-// Function: ASTCheckReturnTypes()
+// Function: sem_declare_globals()
 //
-//   Check if all returns have the proper type.
+//   Insert all global variables and functions into st (in program
+//   order), so that the main pass can resolve forward references
+//   immediately. Only walks the spine of the program.
 //
 // Global Variables: -
 //
-// Side Effects    : Error output
+// Side Effects    : Annotates the AST, error messages
 //
 /----------------------------------------------------------------------*/
 
-bool ASTCheckReturnTypes(SymbolTable_p st, TypeTable_p tt,
-                         TypeIndex expected, AST_p ast)
+static bool sem_declare_globals(SymbolTable_p st, TypeTable_p tt, AST_p ast)
 {
    bool res = true;
 
@@ -548,24 +498,17 @@ bool ASTCheckReturnTypes(SymbolTable_p st, TypeTable_p tt,
    {
       switch(ast->type)
       {
-      case fundef:
-            assert(expected==T_NoType);
-            expected = STSymbolReturnType(st, tt, ast->child[1]->litval);
-            res = ASTCheckReturnTypes(st, tt, expected, ast->child[3]) && res;
+      case prog:
+            res = sem_declare_globals(st, tt, ast->child[0]) && res;
+            res = sem_declare_globals(st, tt, ast->child[1]) && res;
+            break;
+      case vardef:
+            res = STInsertVarDef(st, tt, ast) && res;
             break;
-      case ret_stmt:
-            assert(expected!=T_NoType);
-            if(expected != ast->child[0]->result_type)
-            {
-               type_error(stderr, tt, expected, ast->child[0]);
-               res = false;
-            }
+      case fundef:
+            res = STInsertFunDef(st, tt, ast) && res;
             break;
       default:
-            res = ASTCheckReturnTypes(st, tt, expected, ast->child[0]) && res;
-            res = ASTCheckReturnTypes(st, tt, expected, ast->child[1]) && res;
-            res = ASTCheckReturnTypes(st, tt, expected, ast->child[2]) && res;
-            res = ASTCheckReturnTypes(st, tt, expected, ast->child[3]) && res;
             break;
       }
    }
@@ -575,45 +518,169 @@ bool ASTCheckReturnTypes(SymbolTable_p st, TypeTable_p tt,
 
 /*-----------------------------------------------------------------------
 //
-// Function: ASTCheckReturns()
+// Function: sem_check()
 //
-//   Check if all functions have a return statement.
+//   The fused semantic pass: build local scopes, bind identifiers and
+//   calls, annotate types and check calls, return types and the
+//   presence of returns, all in one traversal of ast. Global symbols
+//   must already be in the global table.
 //
 // Global Variables: -
 //
-// Side Effects    : Prints warning if statement is missing.
+// Side Effects    : Annotates the AST, error messages
 //
 /----------------------------------------------------------------------*/
 
-bool ASTCheckReturns(AST_p ast)
+static bool sem_check(SemState_p state, SymbolTable_p st, AST_p ast)
 {
-   bool res = true;
+   bool         res = true;
+   int          i;
+   SemStateCell outer;
 
-   if(ast)
+   if(!ast)
    {
-      switch(ast->type)
-      {
-      case prog:
-            res = ASTCheckReturns(ast->child[0]) && res;
-            res = ASTCheckReturns(ast->child[1]) && res;
-            break;
-      case fundef:
-            if(!body_has_return(ast->child[3]))
-            {
-               fprintf(stdout, "%d:%d: warning: cannot guarantee proper "
-                       "return value for function %s()\n",
-                       ast->child[0]->line, ast->child[0]->column, ast->child[1]->litval);
-               res = false;
-            }
-            break;
-      default:
-            break;
-      }
+      return true;
+   }
+   ast->context = st;
+   switch(ast->type)
+   {
+   case vardef:
+         if(st->depth > 0)
+         {
+            res = STInsertVarDef(st, state->tt, ast) && res;
+         }
+         sem_set_context(st, ast->child[0]);
+         sem_set_context(st, ast->child[1]);
+         ast->result_type = T_NoType;
+         break;
+   case fundef:
+         sem_set_context(st, ast->child[0]);
+         sem_set_context(st, ast->child[1]);
+         st = STEnterContext(st);
+         res = st_insert_params(st, state->tt, ast->child[2]) && res;
+         sem_set_context(st, ast->child[2]);
+
+         outer = *state;
+         state->ret_type   = get_type_ast_type(ast->child[0]);
+         state->body_depth = 0;
+         state->has_return = false;
+         state->fun        = ast->child[1];
+         res = sem_check(state, st, ast->child[3]) && res;
+         if(!state->has_return)
+         {
+            fprintf(stdout, "%d:%d: warning: cannot guarantee proper "
+                    "return value for function %s()\n",
+                    ast->child[0]->line, ast->child[0]->column,
+                    ast->child[1]->litval);
+         }
+         *state = outer;
+         ast->result_type = T_NoType;
+         break;
+   case body:
+         st = STEnterContext(st);
+         ast->context = st;
+         state->body_depth++;
+         res = sem_check(state, st, ast->child[0]) && res;
+         res = sem_check(state, st, ast->child[1]) && res;
+         state->body_depth--;
+         ast->result_type = T_NoType;
+         break;
+   case ret_stmt:
+         res = sem_check(state, st, ast->child[0]) && res;
+         res = sem_check(state, st, ast->child[1]) && res;
+         if(state->body_depth == 1)
+         {
+            state->has_return = true;
+         }
+         if(state->ret_type != ast->child[1]->result_type)
+         {
+            type_error(stderr, state->tt, state->ret_type, ast->child[1]);
+            res = false;
+         }
+         /* return f(...) can reuse the frame */
+         ast->tail_call = ast->child[1]->type == funcall &&
+            ast->child[1]->sym_table;
+         ast->result_type = T_NoType;
+         break;
+   case t_IDENT:
+         /* All globals and all visible locals are known by now */
+         st_bind_node(st, ast);
+         ast->result_type = GetSymbolResType(stdout, state->tt, ast);
+         if(ast->result_type == T_NoType)
+         {
+            res = false;
+         }
+         break;
+   case funcall:
+         ast->child[0]->context = st;
+         st_bind_node(st, ast->child[0]);
+         st_bind_node(st, ast);
+         res = sem_check(state, st, ast->child[1]) && res;
+         res = type_check_funcall(stdout, state->tt, ast) && res;
+         ast->child[0]->result_type = ast->result_type;
+         break;
+   default:
+         for(i=0; ast->child[i]; i++)
+         {
+            res = sem_check(state, st, ast->child[i]) && res;
+         }
+         res = type_annotate_node(state->tt, ast) && res;
+         break;
    }
    return res;
 }
 
 
+bool STInsertVarDef(SymbolTable_p st, TypeTable_p tt, AST_p def)
+{
+   assert((def->type == vardef) || (def->type == param));
+
+   //printf("# STInsertVarDef():");SExprASTPrint(stdout, def);printf("\n");
+   //ASTCellPrint(def);
+   //ASTCellPrint(def->child[0]);
+
+   return  st_insert_symbols(st, tt, def->child[0], def->child[1]);
+}
+
+bool STInsertFunDef(SymbolTable_p st, TypeTable_p tt, AST_p def)
+{
+   NanoTypeCell ntype;
+   TypeIndex    type;
+
+   assert(def->type == fundef);
+
+   // printf("# STInsertFunDef():");SExprASTPrint(stdout, def->child[0]);printf("\n");
+   TypeInit(&ntype, tc_function);
+   TypeAddArg(&ntype, get_type_ast_type(def->child[0]));
+
+   get_param_types(&ntype, def->child[2]);
+   type = TypeTableGetTypeIndex(tt, &ntype);
+   TypeFreeArgs(&ntype);
+   if(!STInsertSymbol(st, def->child[1]->litval, type,
+                      def->child[0]->line, def->child[0]->column))
+   {
+      return false;
+   }
+   ASTBind(def->child[1], st, st->symbol_ctr-1);
+   return true;
+}
+
+
+TypeIndex GetSymbolResType(FILE* out, TypeTable_p tt, AST_p node)
+{
+   assert(node->type == t_IDENT);
+   assert(node->context);
+
+   if(!node->sym_table)
+   {
+      fprintf(out, "%d:%d: error: undefined identifier %s\n",
+              node->line, node->column, node->litval);
+      return T_NoType;
+   }
+   return TypeTableGetRetType(tt, ASTSymbol(node)->type);
+}
+
+
 /*-----------------------------------------------------------------------
 //
 // Function: STCheckMain()
@@ -634,7 +701,7 @@ bool STCheckMainTypes(SymbolTable_p st, TypeTable_p tt)
    bool res = true;
    int i;
 
-   symbol = STFindSymbolLocal(st, "main");
+   symbol = STFindSymbolLocal(st, StrIntern("main"));
    if(!symbol)
    {
       fprintf(stderr, "error: no main function()\n");
@@ -666,3 +733,39 @@ bool STCheckMainTypes(SymbolTable_p st, TypeTable_p tt)
 
    return res;
 }
+
+
+/*-----------------------------------------------------------------------
+//
+// Function: ASTSemanticCheck()
+//
+//   Complete semantic analysis of the program ast: build the symbol
+//   tables, bind names, annotate and check types, check return types
+//   and the presence of returns and the type of main(), with one
+//   traversal of the tree (plus one of the list of top level
+//   definitions). Returns true if no error was found (missing returns
+//   are only warnings).
+//
+// Global Variables: -
+//
+// Side Effects    : Annotates the AST, error messages
+//
+/----------------------------------------------------------------------*/
+
+bool ASTSemanticCheck(SymbolTable_p st, TypeTable_p tt, AST_p ast)
+{
+   SemStateCell state;
+   bool         res;
+
+   state.tt         = tt;
+   state.ret_type   = T_NoType;
+   state.body_depth = 0;
+   state.has_return = false;
+   state.fun        = NULL;
+
+   res = sem_declare_globals(st, tt, ast);
+   res = sem_check(&state, st, ast) && res;
+   res = STCheckMainTypes(st, tt) && res;
+
+   return res;
+}
@@ -40,16 +40,13 @@ Changes
 
 bool STInsertVarDef(SymbolTable_p st, TypeTable_p tt, AST_p def);
 bool STInsertFunDef(SymbolTable_p st, TypeTable_p tt, AST_p def);
-bool STBuildAllTables(SymbolTable_p st, TypeTable_p tt, AST_p ast);
 
 TypeIndex GetSymbolResType(FILE* out, TypeTable_p tt, AST_p node);
-bool ASTTypeCheck(SymbolTable_p st, TypeTable_p tt, AST_p ast);
-bool ASTCheckReturnTypes(SymbolTable_p st, TypeTable_p tt,
-                         TypeIndex expected, AST_p ast);
-bool ASTCheckReturns(AST_p ast);
 
 bool STCheckMainTypes(SymbolTable_p st, TypeTable_p tt);
 
+bool ASTSemanticCheck(SymbolTable_p st, TypeTable_p tt, AST_p ast);
+
 
 #endif
 
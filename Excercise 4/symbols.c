@@ -1,35 +1,94 @@
 
+#include <stdint.h>
 #include "symbols.h"
 
+/* Hash of an interned symbol name (i.e. of its address) */
+static unsigned int st_hash(char* symbol)
+{
+   uint64_t key = (uint64_t)(uintptr_t)symbol;
+
+   return (unsigned int)((key * 0x9E3779B97F4A7C15ull) >> 32);
+}
+
+/* Enter position pos of table->symbols into the hash index */
+static void st_index_insert(SymbolTable_p table, int pos)
+{
+   unsigned int mask = table->index_size-1;
+   unsigned int i    = st_hash(table->symbols[pos].symbol) & mask;
+
+   while(table->index[i].symbol)
+   {
+      i = (i+1) & mask;
+   }
+   table->index[i].symbol = table->symbols[pos].symbol;
+   table->index[i].pos    = pos;
+}
+
+/* (Re)build the hash index for n symbols, so that it is at most a
+   quarter full */
+static void st_index_rebuild(SymbolTable_p table, int n)
+{
+   int size = 16, i;
+
+   while(size < 4*n)
+   {
+      size *= 2;
+   }
+   /* The old index stays in the arena until the tables are freed */
+   table->index_size = size;
+   table->index      = ArenaCalloc(table->arena, size*sizeof(STIndexCell));
+   for(i=0; i< table->symbol_ctr; i++)
+   {
+      st_index_insert(table, i);
+   }
+}
+
 SymbolTable_p SymbolTableAlloc(void)
 {
    SymbolTable_p handle = SymbolTableCellAlloc();
 
-   handle->context    = NULL;
-   handle->symbol_ctr = 0;
+   handle->context     = NULL;
+   handle->arena       = ArenaAlloc(ST_ARENA_CHUNK);
+   handle->depth       = 0;
+   handle->frame_base  = 0;
+   handle->frame_size  = 0;
+   handle->symbol_ctr  = 0;
+   handle->symbol_size = 0;
+   handle->symbols     = NULL;
+   handle->index_size  = 0;
+   handle->index       = NULL;
 
    return handle;
 }
 
+/* Free a global table with all scopes ever entered from it. Symbol
+   names belong to the intern pool. */
 void SymbolTableFree(SymbolTable_p junk)
 {
-   int i;
-
    if(junk)
    {
-      for(i=0; i< junk->symbol_ctr; i++)
-      {
-         free(junk->symbols[i].symbol);
-      }
+      assert(junk->depth == 0);
+      ArenaFree(junk->arena);
    }
    SymbolTableCellFree(junk);
 }
 
+/* Open a new scope - just a bump allocation, the symbol array is only
+   allocated with the first symbol */
 SymbolTable_p STEnterContext(SymbolTable_p table)
 {
-   SymbolTable_p handle = SymbolTableAlloc();
+   SymbolTable_p handle = ArenaMalloc(table->arena, sizeof(SymbolTableCell));
 
-   handle->context = table;
+   handle->context     = table;
+   handle->arena       = table->arena;
+   handle->depth       = table->depth+1;
+   handle->frame_base  = table->depth? table->frame_base+table->symbol_ctr : 0;
+   handle->frame_size  = 0;
+   handle->symbol_ctr  = 0;
+   handle->symbol_size = 0;
+   handle->symbols     = NULL;
+   handle->index_size  = 0;
+   handle->index       = NULL;
 
    return handle;
 }
@@ -41,13 +100,26 @@ SymbolTable_p STLeaveContext(SymbolTable_p table)
 
 Symbol_p STFindSymbolLocal(SymbolTable_p table, char* symbol)
 {
-   int i;
+   unsigned int i, mask;
+   int          pos;
 
-   for(i=0; i< table->symbol_ctr; i++)
+   if(!table->index)
    {
-      if(strcmp(table->symbols[i].symbol, symbol) == 0)
+      for(pos=0; pos< table->symbol_ctr; pos++)
       {
-         return &(table->symbols[i]);
+         if(table->symbols[pos].symbol == symbol)
+         {
+            return &(table->symbols[pos]);
+         }
+      }
+      return NULL;
+   }
+   mask = table->index_size-1;
+   for(i = st_hash(symbol) & mask; table->index[i].symbol; i = (i+1) & mask)
+   {
+      if(table->index[i].symbol == symbol)
+      {
+         return &(table->symbols[table->index[i].pos]);
       }
    }
    return NULL;
@@ -71,6 +143,41 @@ Symbol_p STFindSymbolGlobal(SymbolTable_p table, char* symbol)
    return res;
 }
 
+/* Find symbol in the hierarchy of contexts starting at table. Return
+   its position and set *scope to the table defining it, or return -1
+   if it does not exist. */
+int STFindSymbolScope(SymbolTable_p table, char* symbol,
+                      SymbolTable_p *scope)
+{
+   Symbol_p res;
+
+   for(; table; table = table->context)
+   {
+      res = STFindSymbolLocal(table, symbol);
+      if(res)
+      {
+         *scope = table;
+         return res - table->symbols;
+      }
+   }
+   return -1;
+}
+
+/* Return the outermost scope of the function table belongs to (NULL
+   for the global table) */
+SymbolTable_p STFunctionScope(SymbolTable_p table)
+{
+   if(!table->depth)
+   {
+      return NULL;
+   }
+   while(table->depth > 1)
+   {
+      table = table->context;
+   }
+   return table;
+}
+
 TypeIndex STSymbolReturnType(SymbolTable_p table, TypeTable_p tt, char* symbol)
 {
    Symbol_p entry = STFindSymbolGlobal(table, symbol);
@@ -96,18 +203,53 @@ bool STInsertSymbol(SymbolTable_p table, char* symbol, TypeIndex type,
       // exit(EXIT_FAILURE);
       return false;
    }
-   if(table->symbol_ctr==MAXSYMBOLS)
+   if(table->symbol_ctr==table->symbol_size)
    {
-      fprintf(stderr, "Symbol table overflow: Too many symbols in one context!\n");
-      exit(EXIT_FAILURE);
+      /* Grow by copying inside the arena - the old array is at most
+         as big as all its successors together */
+      Symbol_p old = table->symbols;
+
+      table->symbol_size = table->symbol_size? 2*table->symbol_size : ST_INIT_SYMBOLS;
+      table->symbols = ArenaMalloc(table->arena,
+                                   table->symbol_size*sizeof(SymbolCell));
+      if(table->symbol_ctr)
+      {
+         memcpy(table->symbols, old, table->symbol_ctr*sizeof(SymbolCell));
+      }
    }
-   table->symbols[table->symbol_ctr].symbol = strdup(symbol);
+   table->symbols[table->symbol_ctr].symbol = symbol;
    table->symbols[table->symbol_ctr].line   = line;
    table->symbols[table->symbol_ctr].col    = col;
    table->symbols[table->symbol_ctr].type   = type;
 
    table->symbol_ctr++;
 
+   if(table->depth)
+   {
+      SymbolTable_p fun = STFunctionScope(table);
+
+      if(table->frame_base+table->symbol_ctr > fun->frame_size)
+      {
+         fun->frame_size = table->frame_base+table->symbol_ctr;
+      }
+   }
+
+   if(table->index)
+   {
+      if(2*table->symbol_ctr > table->index_size)
+      {
+         st_index_rebuild(table, table->symbol_ctr);
+      }
+      else
+      {
+         st_index_insert(table, table->symbol_ctr-1);
+      }
+   }
+   else if(table->symbol_ctr > ST_LINEAR_MAX)
+   {
+      st_index_rebuild(table, table->symbol_ctr);
+   }
+
    return true;
 }
 
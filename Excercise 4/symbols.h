@@ -27,34 +27,74 @@ Changes
 #include <string.h>
 #include <stdbool.h>
 #include "types.h"
+#include "intern.h"
 
 
 /*---------------------------------------------------------------------*/
 /*                    Data type declarations                           */
 /*---------------------------------------------------------------------*/
 
-/* How many symbols can be in a single symbol table (i.e. context
- * without subcontexts) ? For a production  level program, this should
- * be dynamic */
-#define MAXSYMBOLS 512
+/* Symbol tables grow dynamically. Up to ST_LINEAR_MAX symbols we just
+ * scan them, beyond that each table gets an open-addressing hash index
+ * (which is kept at most half full). */
+#define ST_INIT_SYMBOLS  8
+#define ST_LINEAR_MAX    8
+
+/* Chunk size of the arena shared by a global table and all its
+ * scopes */
+#define ST_ARENA_CHUNK   8192
 
 /* Storing information for one symbol */
 
 typedef struct symbol
 {
-   char      *symbol;
+   char      *symbol; /* Interned */
    int       line; /* Where is this defined? */
    int       col;
    TypeIndex type;
 }SymbolCell, *Symbol_p;
 
-/* A symbol table table */
+/* Slot in the hash index. The name is stored alongside the position,
+ * so that probing does not have to touch the symbols themselves. */
+
+typedef struct stindex
+{
+   char *symbol;  /* NULL = empty */
+   int  pos;
+}STIndexCell, *STIndex_p;
+
+/* A symbol table table. Symbols are kept in order of insertion. Note
+ * that inserting into a table may move its symbols, so Symbol_p
+ * pointers are only valid until the next insertion into the same
+ * table.
+ *
+ * Nested scopes (STEnterContext()) live in the arena of the global
+ * table, together with all their symbols and indices. A scope without
+ * symbols costs just its cell, and all scopes are released at once by
+ * SymbolTableFree() on the global table. Scopes stay valid after
+ * STLeaveContext(), since the AST refers to them.
+ *
+ * Frame layout: all scopes of a function share one frame of
+ * frame_size slots (recorded in the outermost scope of the function,
+ * depth 1). Symbol i of a scope lives in slot frame_base+i. Nested
+ * scopes start behind the symbols of their parent, sibling scopes
+ * overlap. This requires that a scope gets no new symbols once
+ * scopes have been opened inside it (true for nanoLang, where all
+ * declarations precede the statements). Globals (depth 0) are
+ * addressed by their position. */
 
 typedef struct symboltable
 {
    struct symboltable *context;
+   Arena_p            arena;       /* Shared with all nested scopes */
+   int                depth;       /* 0 for the global table */
+   int                frame_base;  /* Frame slot of the first symbol */
+   int                frame_size;  /* Slots per frame (depth 1 only) */
    int                symbol_ctr;
-   SymbolCell         symbols[MAXSYMBOLS];
+   int                symbol_size;
+   SymbolCell         *symbols;
+   int                index_size;  /* 0 or a power of 2 */
+   STIndex_p          index;
 }SymbolTableCell, *SymbolTable_p;
 
 
@@ -67,13 +107,18 @@ typedef struct symboltable
 #define SymbolTableCellFree(junk) free(junk)
 
 SymbolTable_p SymbolTableAlloc(void);
-void          SymbolTableFree(SymbolTable_p junk);
+void          SymbolTableFree(SymbolTable_p junk); /* Global tables only */
 
 SymbolTable_p STEnterContext(SymbolTable_p table);
 SymbolTable_p STLeaveContext(SymbolTable_p table);
 
+/* All symbol names passed in must be interned (see intern.h) */
 Symbol_p  STFindSymbolLocal(SymbolTable_p table, char* symbol);
 Symbol_p  STFindSymbolGlobal(SymbolTable_p table, char* symbol);
+int       STFindSymbolScope(SymbolTable_p table, char* symbol,
+                            SymbolTable_p *scope);
+SymbolTable_p STFunctionScope(SymbolTable_p table);
+#define   STFrameSlot(table, slot) ((table)->frame_base+(slot))
 TypeIndex STSymbolReturnType(SymbolTable_p table, TypeTable_p tt, char* symbol);
 bool      STInsertSymbol(SymbolTable_p table, char* symbol, TypeIndex type,
                          int line, int col);
@@ -0,0 +1,64 @@
+#!/bin/sh
+#
+# Regression tests for the nanoLang compiler.
+#
+# Every tests/<name>.nano is run with all execution engines (--run,
+# --vm, --jit, and the programs built from --emit-c and --emit-asm),
+# optimized and with --no-opt. Its output must equal tests/<name>.out,
+# its exit status the number on its "# exit:" line (default 0).
+# Arguments for main() are taken from its "# args:" line.
+#
+# Usage: tests/run_tests.sh [compiler]   (default ./nanoLangCompiler)
+#
+
+NANO=${1:-./nanoLangCompiler}
+CC=${CC:-gcc}
+DIR=$(dirname "$0")
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+runs=0
+fails=0
+
+for prog in "$DIR"/*.nano
+do
+   name=$(basename "$prog" .nano)
+   args=$(sed -n 's/^# args: *//p' "$prog")
+   status=$(sed -n 's/^# exit: *//p' "$prog")
+   status=${status:-0}
+
+   for opt in "" --no-opt
+   do
+      for engine in --run --vm --jit --emit-c --emit-asm
+      do
+         runs=$((runs+1))
+         case $engine in
+            --emit-c)
+               $NANO $opt --emit-c "$prog" > "$TMP/p.c" 2>/dev/null &&
+               $CC -O2 -w "$TMP/p.c" -o "$TMP/p" &&
+               "$TMP/p" $args > "$TMP/out" 2>/dev/null
+               res=$?
+               ;;
+            --emit-asm)
+               $NANO $opt --emit-asm "$prog" > "$TMP/p.s" 2>/dev/null &&
+               $CC "$TMP/p.s" -o "$TMP/p" &&
+               "$TMP/p" $args > "$TMP/out" 2>/dev/null
+               res=$?
+               ;;
+            *)
+               $NANO $opt $engine "$prog" $args > "$TMP/out" 2>/dev/null
+               res=$?
+               ;;
+         esac
+         if [ "$res" != "$status" ] || ! cmp -s "$TMP/out" "$DIR/$name.out"
+         then
+            fails=$((fails+1))
+            echo "FAIL: $name $engine $opt (exit status $res, expected $status)"
+            diff "$DIR/$name.out" "$TMP/out" | head -5
+         fi
+      done
+   done
+done
+
+echo "$runs runs, $fails failures"
+[ $fails = 0 ]
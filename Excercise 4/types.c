@@ -1,3 +1,4 @@
+#include <string.h>
 #include "types.h"
 #include "symbols.h"
 
@@ -7,6 +8,78 @@ char* atomic_type_names[] = {
    "Integer"
 };
 
+/* Argument storage of a type table is small - most programs only
+ * have a handful of function types */
+#define TT_ARG_CHUNK 1024
+
+static void* tt_realloc(void* ptr, size_t size) {
+   void* res = realloc(ptr, size);
+   if(!res) {
+      fprintf(stderr, "Out of memory in type table!\n");
+      exit(EXIT_FAILURE);
+   }
+   return res;
+}
+
+// Hash of constructor and arguments (FNV-1a over the type indices)
+static unsigned int type_hash(NanoType_p type) {
+   unsigned int hash = 2166136261u ^ type->constructor;
+   int i;
+   for(i = 0; i < type->typeargno; i++) {
+      hash = (hash ^ (unsigned int)type->typeargs[i]) * 16777619u;
+   }
+   return hash;
+}
+
+// Insert type number i into the hash index. The caller makes sure
+// that there is room.
+static void tt_index_add(TypeTable_p table, int i) {
+   unsigned int mask = table->index_size-1;
+   unsigned int pos;
+   for(pos = type_hash(&(table->types[i])) & mask; table->index[pos];
+       pos = (pos+1) & mask) {
+      // Find free slot
+   }
+   table->index[pos] = i+1;
+}
+
+// Double the size of the hash index and rehash all types
+static void tt_index_grow(TypeTable_p table) {
+   int i;
+   table->index_size = table->index_size? 2*table->index_size : 2*TT_INIT_TYPES;
+   free(table->index);
+   table->index = tt_realloc(NULL, table->index_size*sizeof(int));
+   memset(table->index, 0, table->index_size*sizeof(int));
+   for(i = 0; i < table->type_ctr; i++) {
+      tt_index_add(table, i);
+   }
+}
+
+// Initialize a type under construction (without any arguments)
+void TypeInit(NanoType_p type, TypeConst constructor) {
+   type->constructor = constructor;
+   type->typeargno   = 0;
+   type->typeargsize = 0;
+   type->typeargs    = NULL;
+}
+
+// Append an argument to a type under construction
+void TypeAddArg(NanoType_p type, TypeIndex arg) {
+   if(type->typeargno == type->typeargsize) {
+      type->typeargsize = type->typeargsize? 2*type->typeargsize : 8;
+      type->typeargs = tt_realloc(type->typeargs,
+                                  type->typeargsize*sizeof(TypeIndex));
+   }
+   type->typeargs[type->typeargno++] = arg;
+}
+
+// Release the arguments of a type under construction. Types in a
+// table share the storage of the table and must not be passed here.
+void TypeFreeArgs(NanoType_p type) {
+   free(type->typeargs);
+   TypeInit(type, type->constructor);
+}
+
 
 int TypeCmp(NanoType_p t1, NanoType_p t2) {
     if(t1->constructor != t2->constructor || t1->typeargno != t2->typeargno) {
@@ -72,17 +145,24 @@ void TypePrintNumber(FILE* out, TypeTable_p table, TypeIndex type) {
 
 void TypeTableInit(TypeTable_p table) {
    NanoTypeCell type;
+   TypeIndex    arg;
 
-   table->type_ctr = 0;
+   table->type_ctr   = 0;
+   table->type_size  = 0;
+   table->types      = NULL;
+   table->typeargs   = ArenaAlloc(TT_ARG_CHUNK);
+   table->index_size = 0;
+   table->index      = NULL;
 
    // Insert NoType, Integer and String
    type.constructor = tc_atomic;
    type.typeargno   = 1;
-   type.typeargs[0] = T_NoType;
+   type.typeargs    = &arg;
+   arg = T_NoType;
    TypeTableInsert(table, &type);
-   type.typeargs[0] = T_String;
+   arg = T_String;
    TypeTableInsert(table, &type);
-   type.typeargs[0] = T_Integer;
+   arg = T_Integer;
    TypeTableInsert(table, &type);
 }
 
@@ -94,6 +174,9 @@ TypeTable_p  TypeTableAlloc() {
 }
 
 void TypeTableFree(TypeTable_p junk) {
+   free(junk->types);
+   free(junk->index);
+   ArenaFree(junk->typeargs);
    TypeTableCellFree(junk);
 }
 
@@ -106,29 +189,48 @@ void TypeTablePrint(FILE* out, TypeTable_p table) {
    }
 }
 
+// Append a copy of type to the table (whether or not it is already
+// there). The arguments are copied into the table.
 TypeIndex TypeTableInsert(TypeTable_p table, NanoType_p type) {
-   if(table->type_ctr == MAXTYPES) {
-      fprintf(stderr, "No more free entry in the type table!\n");
-      exit(EXIT_FAILURE);
+   NanoType_p entry;
+
+   if(table->type_ctr == table->type_size) {
+      table->type_size = table->type_size? 2*table->type_size : TT_INIT_TYPES;
+      table->types = tt_realloc(table->types,
+                                table->type_size*sizeof(NanoTypeCell));
    }
-   table->types[table->type_ctr] = *type;
+   entry = &(table->types[table->type_ctr]);
+   entry->constructor = type->constructor;
+   entry->typeargno   = type->typeargno;
+   entry->typeargsize = 0;
+   entry->typeargs    = ArenaMalloc(table->typeargs,
+                                    type->typeargno*sizeof(TypeIndex));
+   memcpy(entry->typeargs, type->typeargs, type->typeargno*sizeof(TypeIndex));
    table->type_ctr++;
 
+   if(2*table->type_ctr > table->index_size) {
+      tt_index_grow(table);
+   }
+   else {
+      tt_index_add(table, table->type_ctr-1);
+   }
    return table->type_ctr-1;
 }
 
+// Return the index of type, inserting it if it is new
 TypeIndex TypeTableGetTypeIndex(TypeTable_p table, NanoType_p type) {
-   int i;
-   for(i = 0; i < table->type_ctr; i++) {
-      if(TypeCmp(type, &(table->types[i])) == 0) {
-         return i;
+   unsigned int mask = table->index_size-1;
+   unsigned int pos;
+   for(pos = type_hash(type) & mask; table->index[pos]; pos = (pos+1) & mask) {
+      if(TypeCmp(type, &(table->types[table->index[pos]-1])) == 0) {
+         return table->index[pos]-1;
       }
    }
    return TypeTableInsert(table, type);
 }
 
 TypeIndex TypeTableGetRetType(TypeTable_p table, TypeIndex type) {
-   assert((type>0) && (type<table->type_ctr));
+   assert((type>0) && ((int)type<table->type_ctr));
    return TypeRetType(&(table->types[type]));
 }
 
@@ -27,17 +27,18 @@ Changes
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#include "arena.h"
 
 
 /*---------------------------------------------------------------------*/
 /*                    Data type declarations                           */
 /*---------------------------------------------------------------------*/
 
-/* How many arguments can a type constructor have? */
-#define MAXTYPEARGS 256
-
-/* Maximal number of types allowed in a nanoLang program */
-#define MAXTYPES   1024
+/* There is no limit on the number of types or on the number of
+ * arguments of a type constructor. Types are hash-consed: every type
+ * is stored exactly once, and the hash index on (constructor,
+ * arguments) is kept at most half full. */
+#define TT_INIT_TYPES   16
 
 /* How can I construct new types? */
 typedef enum
@@ -62,13 +63,17 @@ typedef enum
    constructor = tc_function
    typeargno   =  3 (2 arguments, return type)
    typeargs[]  = 2, 1, 1 (T_Integer, T_String, T_String)
+ * Types under construction own a growable typeargs array (see
+ * TypeInit()/TypeAddArg()), types in a table point to exactly
+ * typeargno entries in the arena of the table.
 */
 
 typedef struct nanotype
 {
    TypeConst constructor;
    int       typeargno;
-   TypeIndex typeargs[MAXTYPEARGS];
+   int       typeargsize; /* Only for types under construction */
+   TypeIndex *typeargs;
 }NanoTypeCell, *NanoType_p;
 
 /* A complete type table */
@@ -76,7 +81,11 @@ typedef struct nanotype
 typedef struct typetable
 {
    int          type_ctr;
-   NanoTypeCell types[MAXTYPES];
+   int          type_size;
+   NanoTypeCell *types;
+   Arena_p      typeargs;   /* Storage for the argument vectors */
+   int          index_size; /* Power of 2 */
+   int          *index;     /* 0 = empty, else type index+1 */
 }TypeTableCell, *TypeTable_p;
 
 
@@ -89,6 +98,10 @@ typedef struct typetable
 #define TypeTableCellFree(junk) free(junk)
 
 
+void         TypeInit(NanoType_p type, TypeConst constructor);
+void         TypeAddArg(NanoType_p type, TypeIndex arg);
+void         TypeFreeArgs(NanoType_p type);
+
 int          TypeCmp(NanoType_p t1, NanoType_p t2);
 #define      TypeRetType(t) ((t)->typeargs[0])
 void         TypePrint(FILE* out, TypeTable_p table, TypeIndex type);
@@ -0,0 +1,320 @@
+/*-----------------------------------------------------------------------
+
+File  : vm.c
+
+Authors: Konstantin Kläger, Isabel Staaden, Carolin Rösch
+
+Contents
+
+  Direct threaded virtual machine for nanoLang bytecode. Needs the
+  GNU C "labels as values" extension.
+
+  This code is released under the GNU General Public Licence.
+
+Changes
+
+<1> Sun Oct 18 04:21:09 CEST 2026
+    New
+
+-----------------------------------------------------------------------*/
+
+#include "vm.h"
+
+
+
+/*---------------------------------------------------------------------*/
+/*                        Global Variables                             */
+/*---------------------------------------------------------------------*/
+
+
+/*---------------------------------------------------------------------*/
+/*                      Forward Declarations                           */
+/*---------------------------------------------------------------------*/
+
+
+/*---------------------------------------------------------------------*/
+/*                         Internal Functions                          */
+/*---------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------
+//
+// Function: vm_thread()
+//
+//   Convert prog into direct threaded code: replace opcodes by the
+//   addresses in labels and jump targets by pointers.
+//
+// Global Variables: bc_op_len
+//
+// Side Effects    : Changes prog
+//
+/----------------------------------------------------------------------*/
+
+static void vm_thread(VMProg_p prog, const void* const* labels)
+{
+   long pc, op, i;
+   int  target;
+
+   for(pc=0; pc<prog->code_ctr; pc += bc_op_len[op])
+   {
+      op     = prog->code[pc].arg;
+      target = BCJumpOperand(op);
+      prog->code[pc].op = labels[op];
+      if(target)
+      {
+         prog->code[pc+target].target = prog->code+prog->code[pc+target].arg;
+      }
+   }
+   for(i=0; i<prog->global_ctr; i++)
+   {
+      if(prog->funs[i].entry >= 0)
+      {
+         prog->funs[i].entry_pc = prog->code+prog->funs[i].entry;
+      }
+   }
+   prog->threaded = true;
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                         Exported Functions                          */
+/*---------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------
+//
+// Function: VMRun()
+//
+//   Run main() of prog. The String arguments of main() are taken
+//   from argv (missing ones are empty). Return the result of main().
+//
+// Global Variables: -
+//
+// Side Effects    : By the program
+//
+/----------------------------------------------------------------------*/
+
+NanoInt VMRun(VMProg_p prog, int argc, char* argv[])
+{
+   static const void* const labels[] =
+   {
+      [BC_MOV]    = &&op_mov,
+      [BC_LOADI]  = &&op_loadi,
+      [BC_LOADS]  = &&op_loads,
+      [BC_GETG]   = &&op_getg,
+      [BC_SETG]   = &&op_setg,
+      [BC_ADD]    = &&op_add,
+      [BC_SUB]    = &&op_sub,
+      [BC_MUL]    = &&op_mul,
+      [BC_DIV]    = &&op_div,
+      [BC_ADDK]   = &&op_addk,
+      [BC_SUBK]   = &&op_subk,
+      [BC_MULK]   = &&op_mulk,
+      [BC_DIVK]   = &&op_divk,
+      [BC_NEG]    = &&op_neg,
+      [BC_SCMP]   = &&op_scmp,
+      [BC_JMP]    = &&op_jmp,
+      [BC_JEQ]    = &&op_jeq,
+      [BC_JNE]    = &&op_jne,
+      [BC_JLT]    = &&op_jlt,
+      [BC_JLE]    = &&op_jle,
+      [BC_JGT]    = &&op_jgt,
+      [BC_JGE]    = &&op_jge,
+      [BC_JEQK]   = &&op_jeqk,
+      [BC_JNEK]   = &&op_jnek,
+      [BC_JLTK]   = &&op_jltk,
+      [BC_JLEK]   = &&op_jlek,
+      [BC_JGTK]   = &&op_jgtk,
+      [BC_JGEK]   = &&op_jgek,
+      [BC_CLEAR]  = &&op_clear,
+      [BC_PRINTI] = &&op_printi,
+      [BC_PRINTS] = &&op_prints,
+      [BC_CALL]   = &&op_call,
+      [BC_TCALL]  = &&op_tcall,
+      [BC_RET]    = &&op_ret,
+      [BC_RETNIL] = &&op_retnil
+   };
+   NanoValue *stack, *globals, *fp, val;
+   VMFrame_p calls, csp;
+   VMFun_p   fun;
+   VMInstr   *pc;
+   int       i;
+
+   assert(prog->main_fun >= 0);
+
+   if(!prog->threaded)
+   {
+      vm_thread(prog, labels);
+   }
+   stack   = malloc(VM_STACK_SIZE*sizeof(NanoValue));
+   calls   = malloc(VM_CALL_DEPTH*sizeof(VMFrameCell));
+   globals = calloc(prog->global_ctr+1, sizeof(NanoValue));
+   if(!stack || !calls || !globals)
+   {
+      NanoRuntimeError("out of memory");
+   }
+   csp = calls;
+   fp  = stack;
+   fun = &prog->funs[prog->main_fun];
+   for(i=0; i<fun->arity; i++)
+   {
+      fp[i].s = i<argc? NanoStrFromC(argv[i]) : NULL;
+   }
+   pc  = fun->entry_pc;
+
+/* Operand i as number, frame slot, jump target */
+#define A(i)    (pc[i].arg)
+#define R(i)    (fp[pc[i].arg])
+#define T(i)    (pc[i].target)
+#define NEXT(n) pc += (n); goto *pc->op
+#define JUMP_IF(cond) pc = (cond)? T(3) : pc+4; goto *pc->op
+
+   goto *pc->op;
+
+op_mov:
+   R(1) = R(2);
+   NEXT(3);
+op_loadi:
+   R(1).i = A(2);
+   NEXT(3);
+op_loads:
+   R(1).s = pc[2].str;
+   NEXT(3);
+op_getg:
+   R(1) = globals[A(2)];
+   NEXT(3);
+op_setg:
+   globals[A(1)] = R(2);
+   NEXT(3);
+op_add:
+   R(1).i = NanoAdd(R(2).i, R(3).i);
+   NEXT(4);
+op_sub:
+   R(1).i = NanoSub(R(2).i, R(3).i);
+   NEXT(4);
+op_mul:
+   R(1).i = NanoMul(R(2).i, R(3).i);
+   NEXT(4);
+op_div:
+   /* The runtime handles the special cases 0 and -1 */
+   if((unsigned long)R(3).i+1 <= 1)
+   {
+      R(1).i = NanoDiv(R(2).i, R(3).i);
+   }
+   else
+   {
+      R(1).i = R(2).i / R(3).i;
+   }
+   NEXT(4);
+op_addk:
+   R(1).i = NanoAdd(R(2).i, A(3));
+   NEXT(4);
+op_subk:
+   R(1).i = NanoSub(R(2).i, A(3));
+   NEXT(4);
+op_mulk:
+   R(1).i = NanoMul(R(2).i, A(3));
+   NEXT(4);
+op_divk:
+   R(1).i = R(2).i / A(3);
+   NEXT(4);
+op_neg:
+   R(1).i = NanoNeg(R(2).i);
+   NEXT(3);
+op_scmp:
+   i = NanoStrCmp(R(2).s, R(3).s);
+   R(1).i = (i > 0) - (i < 0);
+   NEXT(4);
+op_jmp:
+   pc = T(1);
+   goto *pc->op;
+op_jeq:
+   JUMP_IF(R(1).i == R(2).i);
+op_jne:
+   JUMP_IF(R(1).i != R(2).i);
+op_jlt:
+   JUMP_IF(R(1).i < R(2).i);
+op_jle:
+   JUMP_IF(R(1).i <= R(2).i);
+op_jgt:
+   JUMP_IF(R(1).i > R(2).i);
+op_jge:
+   JUMP_IF(R(1).i >= R(2).i);
+op_jeqk:
+   JUMP_IF(R(1).i == A(2));
+op_jnek:
+   JUMP_IF(R(1).i != A(2));
+op_jltk:
+   JUMP_IF(R(1).i < A(2));
+op_jlek:
+   JUMP_IF(R(1).i <= A(2));
+op_jgtk:
+   JUMP_IF(R(1).i > A(2));
+op_jgek:
+   JUMP_IF(R(1).i >= A(2));
+op_clear:
+   memset(&R(1), 0, A(2)*sizeof(NanoValue));
+   NEXT(3);
+op_printi:
+   NanoPrintInt(R(1).i);
+   NEXT(2);
+op_prints:
+   NanoPrintStr(R(1).s);
+   NEXT(2);
+op_call:
+   fun = &prog->funs[A(2)];
+   if(csp == calls+VM_CALL_DEPTH ||
+      fp+A(3)+fun->frame_size > stack+VM_STACK_SIZE)
+   {
+      NanoRuntimeError("stack overflow");
+   }
+   csp->pc  = pc+4;
+   csp->fp  = fp;
+   csp->dst = A(1);
+   csp++;
+   fp += A(3);
+   pc  = fun->entry_pc;
+   goto *pc->op;
+op_tcall:
+   /* The arguments become the parameters of the caller's frame */
+   fun = &prog->funs[A(1)];
+   if(fp+fun->frame_size > stack+VM_STACK_SIZE)
+   {
+      NanoRuntimeError("stack overflow");
+   }
+   memmove(fp, &R(2), A(3)*sizeof(NanoValue));
+   pc = fun->entry_pc;
+   goto *pc->op;
+op_ret:
+   val = R(1);
+   goto do_return;
+op_retnil:
+   val.i = 0;
+do_return:
+   if(csp == calls)
+   {
+      goto done;
+   }
+   csp--;
+   pc = csp->pc;
+   fp = csp->fp;
+   fp[csp->dst] = val;
+   goto *pc->op;
+
+#undef A
+#undef R
+#undef T
+#undef NEXT
+#undef JUMP_IF
+
+done:
+   NanoOutFlush();
+   free(globals);
+   free(calls);
+   free(stack);
+
+   return val.i;
+}
+
+
+/*---------------------------------------------------------------------*/
+/*                        End of File                                  */
+/*---------------------------------------------------------------------*/
@@ -0,0 +1,57 @@
+/*-----------------------------------------------------------------------
+
+File  : vm.h
+
+Authors: Konstantin Kläger, Isabel Staaden, Carolin Rösch
+
+Contents
+
+  Virtual machine for nanoLang bytecode (see bytecode.h), using
+  direct threaded dispatch (computed goto).
+
+  This code is released under the GNU General Public Licence.
+
+Changes
+
+<1> Sun Oct 18 04:21:09 CEST 2026
+    New
+
+-----------------------------------------------------------------------*/
+
+#ifndef VM
+
+#define VM
+
+#include "bytecode.h"
+
+
+/*---------------------------------------------------------------------*/
+/*                    Data type declarations                           */
+/*---------------------------------------------------------------------*/
+
+/* Number of value slots for all frames together, and maximal call
+   depth */
+#define VM_STACK_SIZE  (4*1024*1024)
+#define VM_CALL_DEPTH  (1024*1024)
+
+/* Saved state of a caller */
+typedef struct vmframe
+{
+   VMInstr   *pc;   /* Continuation */
+   NanoValue *fp;
+   long      dst;   /* Slot for the result */
+}VMFrameCell, *VMFrame_p;
+
+
+/*---------------------------------------------------------------------*/
+/*                Exported Functions and Variables                     */
+/*---------------------------------------------------------------------*/
+
+NanoInt VMRun(VMProg_p prog, int argc, char* argv[]);
+
+
+#endif
+
+/*---------------------------------------------------------------------*/
+/*                        End of File                                  */
+/*---------------------------------------------------------------------*/